@@ -0,0 +1,48 @@
+#pragma once
+#include <Arduino.h>
+#include "soc/gpio_struct.h"
+
+/**
+ * FastGpio — saídas direto nos registradores W1TS/W1TC do ESP32
+ * ---------------------------------------------------------------
+ *  - Mask guarda os pinos separados por banco (0–31 / 32–39); apply()
+ *    liga e desliga vários pinos sem passar pelo digitalWrite
+ *  - apply() NÃO é atômico: são até 4 escritas separadas (W1TC e W1TS de
+ *    cada banco), primeiro desliga e depois liga. Entre elas os pinos
+ *    passam por estados intermediários com menos pinos ligados, nunca com
+ *    pino a mais
+ *  - Sem leitura-modifica-escrita: cada escrita só mexe nos bits da
+ *    máscara, então tasks que usam pinos diferentes não precisam de trava.
+ *    O mesmo pino escrito de duas tasks precisa de dono único
+ *  - Tudo inline, sem chamada para a flash: pode ser usado em ISR
+ *  - O pino precisa estar como OUTPUT (pinMode continua no begin)
+ */
+namespace FastGpio {
+  struct Mask {
+    uint32_t lo = 0;   // GPIO 0–31
+    uint32_t hi = 0;   // GPIO 32–39
+
+    Mask& add(uint8_t pin) {
+      if (pin < 32) lo |= 1UL << pin;
+      else hi |= 1UL << (pin - 32);
+      return *this;
+    }
+    Mask operator&(const Mask& o) const { Mask m; m.lo = lo & o.lo; m.hi = hi & o.hi; return m; }
+    Mask operator~() const { Mask m; m.lo = ~lo; m.hi = ~hi; return m; }
+  };
+
+  // desliga antes de ligar: o estado intermediário nunca tem pino a mais
+  inline void IRAM_ATTR apply(const Mask& set, const Mask& clr) {
+    if (clr.lo) GPIO.out_w1tc = clr.lo;
+    if (clr.hi) GPIO.out1_w1tc.val = clr.hi;
+    if (set.lo) GPIO.out_w1ts = set.lo;
+    if (set.hi) GPIO.out1_w1ts.val = set.hi;
+  }
+
+  inline void IRAM_ATTR write(uint8_t pin, bool level) {
+    Mask m;
+    m.add(pin);
+    if (level) apply(m, Mask());
+    else apply(Mask(), m);
+  }
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <Arduino.h>
+#include "actuators/FastGpio.h"
+
+/**
+ * StepperEngine — meio-passos do 28BYJ-48 (ULN2003) gerados por timer
+ * ---------------------------------------------------------------
+ *  - move(steps, rate) arma um timer de hardware e volta na hora; cada
+ *    interrupção aplica um meio-passo, sem depender do loop nem das tasks
+ *  - Último passo: a ISR solta as bobinas e marca o fim; poll() entrega
+ *    DONE uma única vez e desarma o timer
+ *  - Fases pré-calculadas como máscaras set/clear dos registradores GPIO
+ *    (FastGpio): um meio-passo = até 4 escritas, sem digitalWrite e sem
+ *    estado intermediário inválido nas bobinas
+ *  - Modos: WAVE (1 bobina), FULL (2 bobinas, mais torque) e HALF
+ *    (alterna 1/2: dobra a resolução; 4096 passos/volta no 28BYJ-48)
+ *  - Partida em RAMP_START_HZ (abaixo do pull-in do 28BYJ-48, ~500 Hz) e
+ *    rampa linear de RAMP_STEPS meio-passos até a taxa pedida: a própria
+ *    ISR reprograma o período do próximo passo
+ *  - Jitter e custo de CPU medidos na própria ISR (esp_timer)
+ *  - A ISR fica no núcleo que chamou begin(): chamar do núcleo de controle
+ *  - Um motor só (a ISR do core Arduino não recebe argumento)
+ */
+class StepperEngine {
+public:
+    enum class Event : uint8_t { NONE, DONE };
+    enum class DriveMode : uint8_t { WAVE, FULL, HALF };
+
+    struct Stats {
+        uint32_t moves;
+        uint32_t steps;
+        uint32_t jitterMaxUs;
+        uint32_t jitterSumUs;
+        uint32_t jitterSamples;
+        uint32_t lastMoveMs;     // duração do último movimento completo
+        uint32_t isrMaxUs;
+        uint32_t isrSumUs;       // CPU gasta na ISR desde o boot
+        uint32_t lastMoveCpuUs;  // CPU gasta na ISR no último movimento
+    };
+
+    // custo de aplicar uma fase: digitalWrite x4 contra registrador
+    struct Bench {
+        uint32_t n;
+        uint32_t digitalWriteNs;
+        uint32_t registerNs;
+    };
+
+    static constexpr uint16_t MIN_RATE_HZ = 50;
+    static constexpr uint16_t MAX_RATE_HZ = 1000;   // acima disso o 28BYJ-48 (5 V) perde passo
+    static constexpr uint16_t RAMP_START_HZ = 400;  // partida direta segura (pull-in)
+    static constexpr uint16_t RAMP_STEPS = 64;      // meio-passos de aceleração
+
+    // duração de move(steps, rate) com a rampa, em µs
+    static uint32_t moveUs(int32_t steps, uint16_t stepsPerSec);
+
+    bool begin(uint8_t in1, uint8_t in2, uint8_t in3, uint8_t in4, uint8_t timerNum = 0);
+    // só parado; steps de move() passam a contar no modo novo
+    bool setMode(DriveMode mode);
+    DriveMode mode() const { return _mode; }
+    // steps < 0 = sentido inverso; false se ocupado, sem timer ou taxa fora da faixa
+    bool move(int32_t steps, uint16_t stepsPerSec);
+    // interrompe na hora e solta as bobinas (sem evento DONE)
+    void stop();
+    bool busy() const { return _running; }
+    int32_t remaining() const { return _remaining; }
+    Event poll();
+    // cópia para log: campos lidos fora da ISR sem trava
+    Stats stats() const { return _stats; }
+    void printStats() const;
+    // mede com as bobinas desligadas (escreve sempre "tudo em LOW"); parado
+    bool benchmark(uint32_t n, Bench& out);
+
+private:
+    struct Phase {
+        FastGpio::Mask set;
+        FastGpio::Mask clr;
+    };
+
+    uint8_t     _pins[4] = {0};
+    Phase       _phases[8];          // em RAM: lido pela ISR
+    uint8_t     _phaseCount = 8;
+    DriveMode   _mode = DriveMode::HALF;
+    FastGpio::Mask _all;
+    uint32_t    _moveIsrStartUs = 0;
+    hw_timer_t* _timer = nullptr;
+    uint32_t    _periodUs = 0;       // período do passo em curso (muda na rampa)
+    uint16_t    _rateHz = 0;         // taxa de cruzeiro
+    uint16_t    _startHz = 0;
+    uint16_t    _ramp = 0;           // meio-passos de rampa que faltam
+    uint32_t    _moveStartMs = 0;
+    uint8_t     _phase = 0;
+    int8_t      _dir = 1;
+
+    volatile bool    _running = false;   // armado em move(), desarmado em poll()/stop()
+    volatile bool    _done = false;      // ISR: último passo aplicado
+    volatile int32_t _remaining = 0;
+    int64_t          _lastIsrUs = 0;
+    Stats            _stats{};
+
+    static StepperEngine* _instance;
+    static void IRAM_ATTR onTimer();
+    void IRAM_ATTR isrStep();
+    void buildPhases();
+    void release();
+    static uint32_t IRAM_ATTR rampPeriodUs(uint16_t startHz, uint16_t rateHz, uint16_t left);
+    void arm();
+    void IRAM_ATTR retime();
+    void disarm();
+};
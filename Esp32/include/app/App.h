@@ -1,15 +1,37 @@
 #pragma once
 #include <Arduino.h>
 #include <WiFi.h>
-#include <WiFiClientSecure.h>
 #include <ESPmDNS.h>
 #include <ArduinoOTA.h>
 #include <FirebaseClient.h>
-#include <OneWire.h>
-#include <DallasTemperature.h>
 #include <Wire.h>
 #include <LiquidCrystal_I2C.h>
 #include <time.h>
+#include <atomic>
+#include "io/RtdbScheduler.h"
+#include "io/TlsSessionClient.h"
+#include "io/AuthStore.h"
+#include "io/TokenRefresher.h"
+#include "io/WiFiManager.h"
+#include "io/BurstScheduler.h"
+#include "io/OfflineQueue.h"
+#include "io/ShadowState.h"
+#include "core/SeriesCodec.h"
+#include "core/RtdbPaths.h"
+#include "core/Clock.h"
+#include "core/LoopProfiler.h"
+#include "core/SpscQueue.h"
+#include "core/SignalPipeline.h"
+#include "core/WindowStats.h"
+#include "core/BootTrace.h"
+#include "config/Thresholds.h"
+#include "actuators/FastGpio.h"
+#include "actuators/StepperEngine.h"
+#include "control/FeedSchedule.h"
+#include "control/HeaterController.h"
+#include "sensors/TemperatureSensor.h"
+#include "sensors/PhSensor.h"
+#include "ui/LcdFrame.h"
 
 // ====== Identificação / OTA ======
 #define HOSTNAME_DEFAULT "aquario-esp32-devkitc"
@@ -18,6 +40,14 @@
 // ====== LOG / HEARTBEAT ======
 #define LOG_HEARTBEAT 1
 
+// ====== Profiler do loop ======
+#define LOOP_PROFILE 1          // 0 = sem instrumentação
+#define DIAG_PUBLISH_MS 300000  // janela publicada em /aquario/status/diag
+
+// ====== TLS ======
+#define TLS_VERIFY_CA 1 // 0 = sem verificação (só para depuração)
+#define TLS_HANDSHAKE_TIMEOUT_MS 15000
+
 // ====== Pinos ======
 #define ONE_WIRE_BUS 4
 #define PH_ADC_PIN 34
@@ -33,111 +63,245 @@
 #define BUZZER_GROUP_PAUSE_MS 2000
 #define I2C_SDA 16
 #define I2C_SCL 17
+// PCF8574: 100 kHz pela folha de dados; a maioria dos módulos aguenta 400000
+#define LCD_I2C_HZ 100000
 #define PIN_BTN 21
 #define BTN_DEBOUNCE_MS 50
 
-// ====== ADC ======
-#define ADC_MAX_COUNTS 4095.0
-#define ADC_VREF 3.3
-
-// ====== Boia/cascata: antirruído ======
-#define T_LOW_CONFIRM_MS 2000
-#define T_HIGH_CONFIRM_MS 1000
 
 // ====== Alimentador ======
 #define FEED_IN1 25
 #define FEED_IN2 26
 #define FEED_IN3 27
 #define FEED_IN4 33
-#define FEED_STEP_INTERVAL_MS 2
-#define MAX_PORTIONS_PER_EVENT 2
-#define STEPS_PER_REV 4096
 
 class App
 {
 public:
+    // Inicializa o hardware e sobe as tasks de controle e de rede
     void begin();
-    void tick();
 
 private:
+    // ====== Tasks (rede no núcleo 0, controle no núcleo 1) ======
+    // Controle não espera a rede: comandos e eventos passam por filas SPSC
+    static constexpr uint32_t CONTROL_PERIOD_MS = 1;
+    static constexpr uint32_t NET_PERIOD_MS = 2;
+    static constexpr uint32_t CONTROL_STACK = 6144;
+    static constexpr uint32_t NET_STACK = ARDUINO_LOOP_STACK_SIZE; // TLS + FirebaseClient (antes na loopTask)
+    static constexpr UBaseType_t CONTROL_PRIO = 5;
+    static constexpr UBaseType_t NET_PRIO = 3;
+    static void controlTaskEntry(void *arg);
+    static void networkTaskEntry(void *arg);
+    void controlTick();
+    void networkTick();
+
+    // rede → controle (stream de /aquario/controle)
+    struct ControlCmd
+    {
+        enum class Kind : uint8_t
+        {
+            HEATER_MODE,     // arg: 1 = auto
+            HEATER_ON_NOW,   // arg: liga/desliga
+            WATERFALL_MODE,  // arg: 1 = auto
+            WATERFALL_ON_NOW,
+            FEED_NOW,        // arg: porções
+            BENCH_STEPPER    // serial 'b': custo por fase do alimentador
+        };
+        Kind kind;
+        uint8_t arg;
+    };
+    // controle → rede (estados, leituras, médias, alimentador)
+    struct ControlEvent
+    {
+        enum class Kind : uint8_t
+        {
+            HEATER,
+            WATERFALL,
+            WATER_OK,
+            FEEDER_BUSY,
+            TEMP_NOW,
+            PH_NOW,
+            FEED_DONE,
+            FEED_LOG,
+            FEED_BLOCKED     // agenda vencida com nível baixo (uma vez por episódio)
+        };
+        Kind kind;
+        float value;
+        uint64_t monoMs; // instante da medição (a rede data com Clock::toEpoch)
+    };
+    SpscQueue<ControlCmd, 8> cmdQueue;
+    SpscQueue<ControlEvent, 32> eventQueue;
+    uint32_t cmdDrops = 0;                  // só a rede escreve
+    std::atomic<uint32_t> eventDrops{0};    // escrito pelo controle, lido pela rede
+    int8_t reported[4] = {-1, -1, -1, -1};  // último estado enviado (-1 = nunca)
+    struct
+    {
+        bool heater = false;
+        bool waterfall = true;
+        bool waterOk = true;
+        bool feederBusy = false;
+    } netState; // cópia dos estados do lado da rede
+    void applyCommand(const ControlCmd &cmd);
+    bool pushEvent(ControlEvent::Kind kind, float value, uint64_t monoMs);
+    void reportState(uint64_t monoMs);
+    void drainEvents(uint32_t now);
+
     // ====== Firebase (v1.5.11) ======
-    WiFiClientSecure sslClient;
+    TlsSessionClient sslClient;
     network_config_data net{};
     AsyncClientClass aClient{sslClient, net};
+    TlsSessionClient streamSsl;
+    AsyncClientClass streamClient{streamSsl, net};
     FirebaseApp app;
     RealtimeDatabase Database;
     UserAuth *pAuth{nullptr};
+    IDToken *pIdToken{nullptr};
+    using Prio = RtdbScheduler::Prio;
+    RtdbScheduler sched;
+    OfflineQueue backlog;
+    static constexpr uint8_t BACKLOG_DRAIN_MAX = 16;
+    uint32_t backlogDropMark = 0;
+    ShadowState shadow;
+    enum ShadowNode : uint8_t
+    {
+        SH_HEATER = 0,
+        SH_WATERFALL,
+        SH_WATER_OK,
+        SH_FEEDER_BUSY,
+        SH_TEMP_CURRENT,
+        SH_PH_CURRENT,
+    };
+    const uint32_t STATE_REFRESH_MS = 600000;
+
+    // ====== Auth (token persistido + renovação antecipada) ======
+    AuthStore authStore;
+    AuthToken authToken{};
+    TokenRefresher refresher;
+    bool authFromSignIn = false;
+    bool authCaptured = false;
+    uint32_t authSignInAt = 0;
+    uint32_t authRetryAt = 0;
+    uint8_t authFailures = 0;
+    const uint32_t AUTH_TOKEN_TTL_S = 3600;
+    const uint32_t AUTH_REFRESH_AHEAD_S = 300;
+    const uint8_t AUTH_MAX_REFRESH_FAILS = 4;
+    void signIn(const char *uid);
+    void applyToken(uint32_t nowEpoch);
+    void serviceAuth(uint32_t now);
 
     static void processData(AsyncResult &aResult);
-    inline bool fbReady() { return app.ready(); }
+    void dispatchControl(const char *dataPath, const char *data);
+    void applyControl(const char *leaf, const char *value);
+    inline bool fbReady() { return fbStarted && wifi.connected() && app.ready(); }
 
     // ====== Wi-Fi / OTA / NTP ======
-    void connectWiFi();
+    WiFiManager wifi;
+    BurstScheduler radio; // janelas de tráfego + modem sleep entre elas
+    bool otaStarted = false;
+    bool otaActive = false; // upload em andamento: rádio fica acordado
+    bool fbStarted = false;
+    bool clockWaitLogged = false;
     void syncTime();
     void setupOTA();
+    void startFirebase();
+    void setupTls();
 
     // ====== Relés ======
     inline void relayOn(int pin)
     {
-#if RELAY_ACTIVE_LOW
-        digitalWrite(pin, LOW);
-#else
-        digitalWrite(pin, HIGH);
-#endif
+        FastGpio::write(pin, !RELAY_ACTIVE_LOW);
     }
     inline void relayOff(int pin)
     {
-#if RELAY_ACTIVE_LOW
-        digitalWrite(pin, HIGH);
-#else
-        digitalWrite(pin, LOW);
-#endif
+        FastGpio::write(pin, RELAY_ACTIVE_LOW);
     }
 
     // ====== DS18B20 ======
-    OneWire oneWire{ONE_WIRE_BUS};
-    DallasTemperature sensors{&oneWire};
+    // conversão em duas fases: dispara a cada SAMPLE_MS e o controle
+    // colhe o resultado ~750 ms depois, sem travar a task
+    TemperatureSensor tempSensor;
 
     // ====== Controle térmico ======
-    float T_SET = 26.0f;
-    float T_HYST = 1.0f;
-    float T_MIN_SAFE = 15.0f;
-    float T_MAX_SAFE = 35.0f;
-    inline float T_MIN_ON() const { return T_SET - T_HYST; }
-    inline float T_MAX_OFF() const { return T_SET + T_HYST; }
-    bool heaterOn = false;
-    const unsigned long MIN_SWITCH_MS = 30000;
-    unsigned long lastSwitchMs = 0;
+    // mesma decisão do AquaSim; faixa e anti bate-bate de config/Thresholds.h
+    HeaterController heater;
 
     // ====== pH ======
-    const float M_PH = -5.77f;
-    const float B_PH = 22.00f;
-    bool phInit = false;
-    float emaV = 0.0f;
-    const float ALPHA = 0.15f;
-    const float PH_MIN = 0.0f, PH_MAX = 14.0f;
+    PhSensor phSensor; // DMA + média aparada + EMA/calibração (config/Thresholds.h)
 
     // ====== Agregação (5 min) ======
-    const unsigned long SAMPLE_MS = 25000;
-    const unsigned long UPLOAD_MS = 300000;
     unsigned long lastSampleTemp = 0, lastUploadTemp = 0;
-    double sumTemp = 0.0;
-    int nTemp = 0;
+    WindowStats tempWin[TemperatureSensor::MAX_PROBES];
+    uint32_t tempSamples() const
+    {
+        uint32_t n = 0;
+        for (const WindowStats &w : tempWin)
+            n += w.count();
+        return n;
+    }
     unsigned long lastSamplePH = 0, lastUploadPH = 0;
-    double sumPH = 0.0;
-    int nPH = 0;
+    WindowStats phWin;
     String lastAvgTempKey;
     float lastAvgTempSent = NAN;
 
     String lastAvgPhKey;
     float lastAvgPhSent = NAN;
 
+    struct Series
+    {
+        SeriesCodec::Encoder enc;
+        bool unsent = false; // amostras que não saíram ao vivo (offline)
+    };
+    Series tempSeries[TemperatureSensor::MAX_PROBES];
+    Series phSeries;
+    void appendSeries(Series &s, const char *name, uint64_t ts, float v);
+    void writeChunk(const SeriesCodec::Encoder &enc, const char *name, bool live);
+
+    // ====== Amostras antes do NTP ======
+    // Guardadas com o relógio monotônico e re-datadas (Clock::toEpoch)
+    // quando a primeira sincronização chega; cheio → descarta a mais antiga
+    enum class Stamped : uint8_t
+    {
+        TEMP_AVG,
+        PH_AVG,
+        FEED_DONE,
+        FEED_LOG
+    };
+    struct PendingSample
+    {
+        uint64_t monoMs;
+        float value;
+        Stamped kind;
+        uint8_t probe;
+    };
+    static constexpr uint8_t PRESYNC_MAX = 32;
+    PendingSample preSync[PRESYNC_MAX];
+    uint8_t preSyncCount = 0;
+    void stampSample(Stamped kind, float v, uint64_t monoMs, uint8_t probe = 0);
+    void emitSample(Stamped kind, uint64_t ts, float v, uint8_t probe = 0);
+    void flushPreSync();
+    static void seriesName(Stamped kind, uint8_t probe, char *out, size_t len);
+
+    // ====== Resumo por janela (controle → rede) ======
+    // A média segue para a série (e para o preSync); o resumo completo vai
+    // para /aquario/stats/<série>/<ts> no mesmo update multi-caminho
+    struct WindowReport
+    {
+        Stamped kind; // TEMP_AVG ou PH_AVG
+        uint8_t probe;
+        uint64_t monoMs;
+        WindowStats::Summary stats;
+    };
+    SpscQueue<WindowReport, 8> windowQueue;
+    void pushWindow(Stamped kind, uint8_t probe, uint64_t monoMs, const WindowStats::Summary &st);
+    void publishWindow(const WindowReport &w);
+
     // ====== Estado boia/cascata ======
     bool waterOk = true;
     bool waterfallOn = true;
 
     inline int readFloatRaw() { return digitalRead(PIN_FLOAT_SWITCH); }
     inline int readFloatAsBoia() { return (readFloatRaw() == LOW) ? 1 : 0; }
+    Signal::Pipeline<int, Signal::Debounce<int>> floatFilter{Signal::Debounce<int>(T_HIGH_CONFIRM_MS, T_LOW_CONFIRM_MS)};
     void setWaterfall(bool on);
 
     // ====== Buzzer ======
@@ -154,6 +318,7 @@ private:
     Screen currentScreen = Screen::RESUMO;
     uint8_t lcdAddr = 0x27;
     LiquidCrystal_I2C lcd{lcdAddr, 16, 2};
+    LcdFrame lcdFrame;
     uint32_t tLastLcd = 0, tLastRotate = 0;
     bool autoRotate = false;
     const uint32_t ROTATE_EVERY_MS = 5000;
@@ -162,48 +327,93 @@ private:
     float gLastPH = NAN;
 
     uint8_t scanI2C();
+    bool probeI2C(uint8_t addr);
     void initLCD();
-    void lcdClearLine(uint8_t row);
     void drawResumo();
     void drawDetalhe();
     void updateLCD();
     void handleButton();
 
     // ====== Alimentador ======
+    StepperEngine feeder;
     bool feederBusy = false;
-    long feederTargetSteps = 0;
-    long feederRemainingSteps = 0;
-    uint8_t feederStepIndex = 0;
-    unsigned long tLastStep = 0;
-    uint64_t lastFeedTs = 0;
+    uint64_t lastFeedTs = 0;   // epoch (publicado)
     unsigned long tLastFeedNowPoll = 0;
-    int FEED_STEPS_PER_PORTION = 4096;
-    const uint64_t FEED_INTERVAL_MS = 12ULL * 60ULL * 60ULL * 1000ULL;
+    FeedSchedule feedSchedule{FEED_INTERVAL_MS}; // Clock::monoMillis()
 
-    void feederApplyStep(uint8_t idx);
-    void feederReleaseCoils();
-    void feederBeginMove(long stepsCW);
     void feederRun();
     bool feederRequest(uint8_t portions);
 
     // ====== Firebase publishers / logs ======
-    static uint64_t epoch_ms();
     void publicarHeater(bool on);
     void publicarWaterOk(bool ok);
     void publicarWaterfall(bool on);
     void logHeaterDecision(float tC, bool newState, float onThr, float offThr, const char *reason);
     void publicarLastSeen();
-    void setupFirebaseListeners();
+    void publishState(uint32_t now);
+    void flushWrites();
+    void startControlStream();
 
     // ====== Estado Firebase ======
     static App *instance;
     bool fb_ready_notified = false;
-    bool pending_heater_state_publish = true;
     bool feederFbInitDone = false;
     bool fb_need_reauth = false;
     uint32_t fb_cooldown_until = 0;
     int fb_last_err = 0;
-    // >>> HEARTBEAT (last_seen)
-    uint32_t lastSeenAt = 0;
+    bool streamStarted = false;
+    uint32_t lastStreamEventMs = 0;
+    uint32_t streamNotBefore = 0; // dá tempo ao update de init antes do snapshot
+    const uint32_t STREAM_IDLE_MS = 90000;
+    // >>> HEARTBEAT (last_seen): sai na janela periódica do radio
     bool fb_was_ready = false;
+
+    // ====== Profiler do loop (/aquario/status/diag + serial) ======
+    // Um por task; ordem igual à de PROF_*_SECTIONS (App.cpp): vira o nome do nó
+    enum NetSection : uint8_t
+    {
+        PN_TICK = 0,
+        PN_WIFI,
+        PN_FB_LOOP,
+        PN_AUTH,
+        PN_FB_MAINT,
+        PN_EVENTS,
+        PN_DIAG,
+        PN_FLUSH,
+        PN_COUNT
+    };
+    enum CtlSection : uint8_t
+    {
+        PC_TICK = 0,
+        PC_CMDS,
+        PC_BOIA,
+        PC_TEMP,
+        PC_PH,
+        PC_MEDIAS,
+        PC_IHM,
+        PC_FEEDER,
+        PC_COUNT
+    };
+    static constexpr uint8_t DIAG_ROOM_KEEP = 4; // folga deixada na TELEMETRY
+    LoopProfiler profNet;
+    LoopProfiler profCtl;
+    std::atomic<bool> profCtlReset{false}; // pedido da rede, atendido pelo controle
+    uint32_t diagWindowAt = 0;
+    uint8_t diagCursor = 0;
+    void publishDiag(uint32_t now);
+    void printDiag();
+    void handleSerialCommands();
+
+    // ====== Boot (fases em /aquario/status/boot + caches na NVS) ======
+    // NODES_VERSION: sobe quando o conjunto de nós criados no init mudar;
+    // igual ao da NVS → nós já existem, init pulado (e modos preservados)
+    static constexpr uint8_t NODES_VERSION = 1;
+    uint8_t nodesVersion = 0;      // lido da NVS no begin()
+    bool nodesSavePending = false; // grava a versão quando o init for confirmado
+    bool bootPublished = false;
+    static const char *resetReasonName();
+    static uint8_t loadBootByte(const char *key);
+    static void saveBootByte(const char *key, uint8_t v);
+    void printBoot();
+    void publishBoot();
 };
\ No newline at end of file
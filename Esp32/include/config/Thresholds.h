@@ -1,4 +1,5 @@
 #pragma once
+#include <stdint.h>
 
 // Temperatura alvo/segurança
 static constexpr float T_SET      = 26.0f;
@@ -35,7 +36,7 @@ static constexpr int  STEPS_PER_REV             = 4096;
 static constexpr int  FEED_STEPS_PER_PORTION    = 4096; // calibrar
 static constexpr uint8_t MAX_PORTIONS_PER_EVENT = 2;
 static constexpr unsigned long FEED_INTERVAL_MS = 12UL*60UL*60UL*1000UL;
-static constexpr unsigned long FEED_STEP_INTERVAL_MS = 2;
+static constexpr uint16_t FEED_STEP_RATE_HZ = 800;    // meio-passos/s de cruzeiro (parte de StepperEngine::RAMP_START_HZ)
 
 // Filtro pH
 static constexpr float ALPHA_PH = 0.15f;
@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * FeedSchedule — agenda do alimentador no relógio monotônico
+ * ---------------------------------------------------------------
+ *  - due(): passou o intervalo desde o fim da última alimentação; sem
+ *    nenhuma ainda, vence na hora (a primeira sai no boot)
+ *  - O intervalo conta do fim do movimento (done()), automático ou
+ *    manual: um pedido bloqueado (nível baixo) não mexe na agenda e
+ *    volta a valer no próximo tick
+ *  - gate(): o passo (H) do App::controlTick, o mesmo que o AquaSim roda.
+ *    Vencida com nível baixo → BLOCKED uma vez por episódio; depois WAIT
+ *    até a água voltar, sem repetir o aviso a cada tick
+ *  - Relógio monotônico: não espera o NTP nem pula quando ele chega
+ */
+class FeedSchedule {
+public:
+    explicit FeedSchedule(uint64_t intervalMs) : _intervalMs(intervalMs) {}
+
+    bool due(uint64_t nowMono) const {
+        return !_fed || nowMono - _lastMono >= _intervalMs;
+    }
+    // instante em que due() passa a valer (0 = já)
+    uint64_t dueAt() const { return _fed ? _lastMono + _intervalMs : 0; }
+    void done(uint64_t nowMono) {
+        _lastMono = nowMono;
+        _fed = true;
+    }
+    uint64_t lastMono() const { return _lastMono; }
+    uint64_t intervalMs() const { return _intervalMs; }
+
+    enum class Gate : uint8_t { WAIT, FEED, BLOCKED };
+    // FEED: peça o movimento (e chame started() se ele saiu)
+    Gate gate(uint64_t nowMono, bool busy, bool waterOk) {
+        if (busy || !due(nowMono)) return Gate::WAIT;
+        if (waterOk) return Gate::FEED;
+        if (_blocked) return Gate::WAIT;
+        _blocked = true;
+        return Gate::BLOCKED;
+    }
+    // qualquer alimentação (agenda ou manual) encerra o episódio de bloqueio
+    void started() { _blocked = false; }
+    bool blocked() const { return _blocked; }
+
+private:
+    uint64_t _intervalMs;
+    uint64_t _lastMono = 0;
+    bool _fed = false;
+    bool _blocked = false;
+};
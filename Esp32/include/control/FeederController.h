@@ -1,20 +1,19 @@
 #pragma once
 #include <Arduino.h>
+#include "actuators/StepperEngine.h"
+#include "config/Thresholds.h"
 
 class FeederController {
 public:
     void begin(uint8_t in1, uint8_t in2, uint8_t in3, uint8_t in4);
-    bool request(int portions, int stepsPerPortion, bool waterOk);
+    bool request(int portions, int stepsPerPortion, bool waterOk,
+                 uint16_t stepsPerSec = FEED_STEP_RATE_HZ);
+    // só consome o evento de fim: os passos saem do timer
     void tick();
-    bool isBusy() const { return _busy; }
+    bool isBusy() const { return _engine.busy(); }
     uint64_t lastTimestamp() const { return _lastTs; }
 
 private:
-    uint8_t _in1, _in2, _in3, _in4;
-    bool _busy = false;
-    long _targetSteps = 0;
-    long _stepsDone = 0;
-    uint8_t _stepIndex = 0;
-    unsigned long _lastStepTime = 0;
+    StepperEngine _engine;
     uint64_t _lastTs = 0;
 };
@@ -1,12 +1,43 @@
 #pragma once
 #include <Arduino.h>
+#include "config/Thresholds.h"
+
+/**
+ * HeaterController — relé do aquecedor: histerese, anti bate-bate, fail-safe
+ * ---------------------------------------------------------------
+ *  - step() é a decisão de cada rodada da sonda; o App e o AquaSim chamam
+ *    a mesma função, então ajuste feito no simulador vale no aparelho
+ *  - Leitura inválida (NAN, fora de [minSafeC, maxSafeC]) desliga na hora,
+ *    em qualquer modo e sem esperar o anti bate-bate
+ *  - AUTO: liga abaixo de onThr(), desliga acima de offThr(), no máximo
+ *    uma troca a cada minSwitchMs
+ *  - MANUAL: set() manda no relé; step() só aplica o fail-safe
+ *  - Padrões de config/Thresholds.h
+ */
 class HeaterController {
 public:
+  struct Config {
+    float setC = T_SET;
+    float hystC = T_HYST;
+    float minSafeC = T_MIN_SAFE;
+    float maxSafeC = T_MAX_SAFE;
+    unsigned long minSwitchMs = MIN_SWITCH_MS;
+    float onThr() const { return setC - hystC; }
+    float offThr() const { return setC + hystC; }
+  };
+  // o que step() fez com o relé
+  enum class Action : uint8_t { NONE, ON_BELOW, OFF_ABOVE, OFF_FAIL_SAFE };
+
   void begin(uint8_t relayPin, bool activeLow);
-  bool update(float tC, float sp, float hyst, float minSafe, float maxSafe, unsigned long now, unsigned long minSwitchMs, bool& outStateChanged);
+  void configure(const Config& c) { cfg = c; }
+  const Config& config() const { return cfg; }
+  Action step(float tC, bool autoMode, unsigned long now);
+  void set(bool on);    // comando manual
   bool isOn() const { return state; }
+  bool valid(float tC) const { return isfinite(tC) && tC >= cfg.minSafeC && tC <= cfg.maxSafeC; }
   void forceOff();
 private:
   uint8_t pin=255; bool activeLow=true; bool state=false; unsigned long lastSwitch=0;
+  Config cfg;
   void write(bool on);
 };
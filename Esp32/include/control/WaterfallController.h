@@ -1,5 +1,6 @@
 #pragma once
 #include <Arduino.h>
+#include "core/SignalPipeline.h"
 
 class WaterfallController {
 public:
@@ -29,8 +30,6 @@ private:
     bool _forced = false;
     bool _lastAutoState = false;
 
-    // Float switch debounce
-    int _lastRaw = -1;
-    int _stableRaw = -1;
-    unsigned long _changeTime = 0;
+    // Float switch debounce: sobe (água OK) em 2 s, desce em 1 s
+    Signal::Pipeline<int, Signal::Debounce<int>> _float{Signal::Debounce<int>(2000, 1000)};
 };
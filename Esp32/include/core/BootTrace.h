@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * BootTrace — instante de cada fase do boot, em ms desde o reset
+ * ---------------------------------------------------------------
+ *  - mark("fase") grava a primeira ocorrência de cada nome (chamadas
+ *    repetidas, ex.: a cada reconexão, são ignoradas)
+ *  - Pode ser chamado de qualquer task, sem trava: o slot é reservado
+ *    por atomic (dois marks simultâneos do mesmo nome podem duplicar)
+ *  - Nomes precisam viver o programa todo (literais)
+ *  - Relógio: esp_timer, que começa a contar no início da aplicação
+ *  Sem dependência do Arduino: compila no host.
+ */
+namespace BootTrace {
+  constexpr uint8_t MAX_MARKS = 16;
+
+  struct Mark {
+    const char* name;
+    uint32_t ms;
+  };
+
+  void mark(const char* name);
+  bool has(const char* name);
+  uint8_t count();
+  Mark at(uint8_t i);   // slot ainda sendo preenchido → nome ""
+  uint32_t nowMs();
+}
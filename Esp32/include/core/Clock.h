@@ -1,11 +1,27 @@
 #pragma once
 #include <Arduino.h>
-#include <time.h>
 
+/**
+ * Clock — relógio de parede em ms a partir do relógio monotônico
+ * ---------------------------------------------------------------
+ *  - monoMillis(): esp_timer (64 bits, não dá a volta, nunca salta)
+ *  - Cada sincronização (NTP) grava o par epoch/mono do mesmo instante;
+ *    epoch = mono + offset, com resolução real de ms
+ *  - Entre sincronizações corrige a deriva do cristal (ppm), medida pelo
+ *    erro acumulado de uma referência para a outra
+ *  - Antes da primeira sincronização epochMillis() devolve 0 (nunca um
+ *    "1970" disfarçado); quem precisa datar guarda monoMillis() e
+ *    converte depois com toEpoch()
+ */
 namespace Clock {
-  inline uint64_t epochMillis() {
-    time_t s = time(nullptr);
-    if (s > 100000) return (uint64_t)s * 1000ULL;
-    return (uint64_t)millis();
-  }
+  uint64_t monoMillis();
+  bool synced();
+  uint64_t epochMillis();
+  uint64_t toEpoch(uint64_t monoMs);
+
+  // nova referência: epochMs e monoMs medidos no mesmo instante
+  void sync(uint64_t epochMs, uint64_t monoMs);
+
+  int32_t driftPpm();
+  uint32_t syncCount();
 }
@@ -0,0 +1,16 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * JsonScan — leitura mínima de JSON sem alocação
+ * ---------------------------------------------------------------
+ *  Usado para extrair folhas dos eventos put/patch do stream do RTDB.
+ *  find() navega por objetos aninhados seguindo `path` ("a/b/c") e copia
+ *  o valor escalar encontrado para `out` (strings sem aspas).
+ */
+namespace JsonScan {
+  bool find(const char* json, const char* path, char* out, size_t outLen);
+
+  // Copia um valor escalar "cru" (ex.: "\"manual\"" ou "true") sem aspas
+  void unquote(const char* raw, char* out, size_t outLen);
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * LoopProfiler — latência por seção do loop, em histograma fixo
+ * ---------------------------------------------------------------
+ *  - startTick() marca o início; lap(id) atribui à seção id o tempo desde
+ *    a marca anterior; endTick(id) registra o tick inteiro
+ *  - Seção condicional (ex.: leitura do sensor) chama lap() só quando roda:
+ *    as estatísticas são do custo de cada execução, não da média por tick
+ *  - Por seção: n, mín, máx, soma e histograma log-linear em µs (4 faixas
+ *    por oitava, até ~4 s; percentil com erro ≤ 25%). Sem heap, sem float
+ *  - Relógio: esp_timer (µs, imune à troca de frequência da CPU)
+ *  - Janela: reset() zera tudo; quem publica decide o período
+ *  Sem dependência do Arduino: compila no host.
+ */
+class LoopProfiler {
+public:
+  static constexpr uint8_t  MAX_SECTIONS = 16;
+  static constexpr uint8_t  SUB_BITS = 2;                         // 4 faixas por oitava
+  static constexpr uint8_t  TOP_BIT = 21;                         // 2^22 µs ≈ 4,2 s
+  static constexpr uint8_t  BUCKETS = (TOP_BIT - SUB_BITS + 2) << SUB_BITS;
+  static constexpr uint32_t MAX_US = (1UL << (TOP_BIT + 1)) - 1;  // acima disso satura
+
+  struct Summary {
+    uint32_t n;
+    uint32_t minUs;
+    uint32_t avgUs;
+    uint32_t p50Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+  };
+
+  // names precisa viver o programa todo (tabela em flash)
+  void begin(const char* const* names, uint8_t count);
+
+  void startTick() { _tick0 = _mark = nowUs(); }
+  void lap(uint8_t id) {
+    const uint64_t t = nowUs();
+    record(id, (uint32_t)(t - _mark));
+    _mark = t;
+  }
+  void endTick(uint8_t id) { record(id, (uint32_t)(nowUs() - _tick0)); }
+
+  void record(uint8_t id, uint32_t us);
+  void reset();
+
+  uint8_t count() const { return _count; }
+  const char* name(uint8_t id) const { return id < _count ? _names[id] : ""; }
+  // limite superior da faixa que contém o permille-ésimo (limitado ao máx)
+  uint32_t percentile(uint8_t id, uint16_t permille) const;
+  Summary summary(uint8_t id) const;
+  // {"n":..,"min":..,"avg":..,"p50":..,"p99":..,"max":..}; 0 = não coube
+  size_t toJson(uint8_t id, char* out, size_t len) const;
+
+  static uint8_t bucketOf(uint32_t us);
+  static uint32_t bucketTop(uint8_t b);
+  static uint64_t nowUs();
+
+private:
+  struct Section {
+    uint32_t n;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t sumUs;
+    uint32_t hist[BUCKETS];
+  };
+
+  const char* const* _names = nullptr;
+  uint8_t  _count = 0;
+  uint64_t _tick0 = 0;
+  uint64_t _mark = 0;
+  Section  _s[MAX_SECTIONS];
+};
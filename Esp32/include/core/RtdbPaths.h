@@ -0,0 +1,113 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * RtdbPaths — todos os caminhos /aquario/... conhecidos, em flash
+ * ---------------------------------------------------------------
+ *  - Caminhos fixos são constexpr: nada de String, nada de heap
+ *  - Caminhos com sufixo dinâmico (logs/<ts>, series/<nome>/<t0>) são
+ *    montados na pilha com PathBuf<N>, a partir dos prefixos da tabela
+ *  - MAX_LEN é calculado em compilação; quem guarda caminhos (ex.:
+ *    RtdbScheduler::PATH_LEN) faz static_assert contra ele
+ */
+namespace RtdbPaths {
+  // ---- estados ----
+  constexpr char RELAY_HEATER[]       = "/aquario/relay/heater";
+  constexpr char RELAY_WATERFALL[]    = "/aquario/relay/waterfall";
+  constexpr char WATER_OK[]           = "/aquario/float/water_ok";
+  constexpr char HEATER_STATE[]       = "/aquario/controle/heater/state";
+  constexpr char WATERFALL_STATE[]    = "/aquario/controle/waterfall/state";
+  constexpr char TEMP_CURRENT[]       = "/aquario/temperatura_current";
+  constexpr char PH_CURRENT[]         = "/aquario/ph_current";
+
+  // ---- status ----
+  constexpr char LAST_SEEN[]          = "/aquario/status/last_seen";
+  constexpr char FEEDER_BUSY[]        = "/aquario/status/feeder/busy";
+  constexpr char FEEDER_LAST_TS[]     = "/aquario/status/feeder/last_ts";
+
+  // ---- controle (stream + comandos edge) ----
+  constexpr char CONTROLE[]           = "/aquario/controle";
+  constexpr char HEATER_MODE[]        = "/aquario/controle/heater/mode";
+  constexpr char HEATER_ON_NOW[]      = "/aquario/controle/heater/turn_on_now";
+  constexpr char WATERFALL_MODE[]     = "/aquario/controle/waterfall/mode";
+  constexpr char WATERFALL_ON_NOW[]   = "/aquario/controle/waterfall/turn_on_now";
+  constexpr char FEED_NOW[]           = "/aquario/controle/feeder/feed_now";
+
+  // ---- config ----
+  constexpr char FEEDER_STEPS[]       = "/aquario/config/feeder/steps_per_portion";
+  constexpr char FEEDER_STEP_RATE[]   = "/aquario/config/feeder/step_rate_hz";
+  constexpr char FEEDER_MAX_PORTIONS[] = "/aquario/config/feeder/max_portions_per_event";
+
+  // ---- logs ----
+  constexpr char FEEDER_LOG_LAST_TS[] = "/aquario/feeder/logs/last_ts";
+
+  // ---- prefixos (sufixo montado com PathBuf) ----
+  constexpr char CONTROLE_PREFIX[]    = "/aquario/controle/";        // + <atuador>/mode | /logs/<ts>
+  constexpr char HEATER_LOGS[]        = "/aquario/controle/heater/logs/";  // + <ts>/<campo>
+  constexpr char SERIES[]             = "/aquario/series/";          // + <nome>/<t0>
+  constexpr char DIAG[]               = "/aquario/status/diag/";     // + <seção do loop>
+  constexpr char STATS[]              = "/aquario/stats/";           // + <série>/<ts da janela>
+  constexpr char BOOT[]               = "/aquario/status/boot/";     // + <fase> (ms desde o reset) | reset
+
+  constexpr const char* const ALL[] = {
+    RELAY_HEATER, RELAY_WATERFALL, WATER_OK, HEATER_STATE, WATERFALL_STATE,
+    TEMP_CURRENT, PH_CURRENT, LAST_SEEN, FEEDER_BUSY, FEEDER_LAST_TS,
+    CONTROLE, HEATER_MODE, HEATER_ON_NOW, WATERFALL_MODE, WATERFALL_ON_NOW,
+    FEED_NOW, FEEDER_STEPS, FEEDER_STEP_RATE, FEEDER_MAX_PORTIONS,
+    FEEDER_LOG_LAST_TS, CONTROLE_PREFIX, HEATER_LOGS, SERIES, DIAG, STATS, BOOT,
+  };
+  constexpr size_t COUNT = sizeof(ALL) / sizeof(ALL[0]);
+
+  constexpr size_t len(const char* s) { return *s ? 1 + len(s + 1) : 0; }
+  constexpr size_t maxLen(size_t i = 0, size_t best = 0) {
+    return i >= COUNT ? best : maxLen(i + 1, len(ALL[i]) > best ? len(ALL[i]) : best);
+  }
+  constexpr size_t MAX_LEN = maxLen();
+}
+
+/**
+ * PathBuf<N> — caminho montado na pilha, capacidade fixa
+ *  Estourou a capacidade → ok() == false e c_str() passa a devolver ""
+ *  (o RtdbScheduler recusa caminho vazio: nunca grava caminho truncado).
+ *  truncate() volta a um prefixo já montado para reaproveitar a base.
+ */
+template <size_t N>
+class PathBuf {
+public:
+  explicit PathBuf(const char* base = "") { _buf[0] = '\0'; add(base); }
+
+  PathBuf& add(const char* s) {
+    while (*s) add(*s++);
+    return *this;
+  }
+
+  PathBuf& add(char c) {
+    if (_len + 1 >= N) { _ok = false; return *this; }
+    _buf[_len++] = c;
+    _buf[_len] = '\0';
+    return *this;
+  }
+
+  PathBuf& addU64(uint64_t v) {
+    char tmp[21];
+    uint8_t n = 0;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+    while (n) add(tmp[--n]);
+    return *this;
+  }
+
+  PathBuf& truncate(size_t len) {
+    if (len < _len) { _len = len; _buf[_len] = '\0'; }
+    return *this;
+  }
+
+  const char* c_str() const { return _ok ? _buf : ""; }
+  size_t length() const { return _len; }
+  bool ok() const { return _ok; }
+
+private:
+  char   _buf[N];
+  size_t _len = 0;
+  bool   _ok = true;
+};
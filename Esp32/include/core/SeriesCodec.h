@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * SeriesCodec — séries temporais compactadas (estilo Gorilla)
+ * ---------------------------------------------------------------
+ *  Um chunk guarda várias amostras (t em ms, valor) num único nó do RTDB,
+ *  como string base64. Sem dependência do Arduino: compila no host.
+ *
+ *  Formato v1 (bits MSB-first):
+ *    cabeçalho  : versão(8) | casas decimais(8) | nº de amostras(8)
+ *    1ª amostra : t0 (48) | v0 quantizado em zigzag (32)
+ *    2ª amostra : delta t (32) | delta v
+ *    demais     : delta-of-delta t | delta v
+ *
+ *  Valores são quantizados (v * 10^decimais) e codificados como diferença
+ *  para o anterior. Delta-of-delta e delta v usam prefixos de tamanho
+ *  variável (zigzag):
+ *    '0' → 0 | '10'+6/7 bits | '110'+12 | '1110'+20 | '1111'+32
+ */
+namespace SeriesCodec {
+  static constexpr uint8_t VERSION = 1;
+
+  class Encoder {
+  public:
+    static constexpr size_t CAPACITY = 64;     // bytes do corpo
+
+    void begin(uint64_t t0Ms, float v0, uint8_t decimals);
+    // false = não cabe (ou tempo não crescente): feche o chunk e comece outro
+    bool append(uint64_t tMs, float v);
+    void reset() { _count = 0; _bits = 0; }
+
+    bool empty() const { return _count == 0; }
+    uint8_t count() const { return _count; }
+    uint64_t startMs() const { return _t0; }
+    uint64_t lastMs() const { return _lastT; }
+    size_t sizeBytes() const { return 3 + (_bits + 7) / 8; }
+
+    // base64 do chunk (cabeçalho + corpo); retorna o tamanho sem o '\0'
+    size_t toBase64(char* out, size_t outLen) const;
+
+  private:
+    uint8_t  _buf[CAPACITY] = {0};
+    size_t   _bits = 0;
+    uint8_t  _count = 0;
+    uint8_t  _decimals = 2;
+    uint64_t _t0 = 0, _lastT = 0;
+    int64_t  _lastDelta = 0;
+    int32_t  _lastQ = 0;
+
+    void put(uint64_t v, uint8_t nbits);
+    void putBucketed(int64_t v, uint8_t firstWidth);
+    int32_t quantize(float v) const;
+  };
+
+  // Decodifica um chunk base64; retorna nº de amostras escritas (≤ max)
+  size_t decodeBase64(const char* b64, uint64_t* tsOut, float* valuesOut, size_t max);
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+/**
+ * Signal — estágios de filtro compostos em tempo de compilação
+ * ---------------------------------------------------------------
+ *  - Estágio = struct com `T process(T x, uint32_t nowMs)` e `reset()`;
+ *    guarda só o próprio estado e a própria configuração
+ *  - Pipeline<T, A, B, C> aplica A → B → C: cada estágio é membro por
+ *    valor e a chamada é direta (sem virtual, sem heap): o compilador
+ *    achata a cadeia como se fosse escrita à mão
+ *  - Sensor novo = um typedef com os estágios e uma linha de construção;
+ *    nenhum estado copiado para o App
+ *  - Sem dependência do Arduino: compila no host; C++11
+ */
+namespace Signal {
+
+// ==== estágios ====
+
+// mediana das últimas N entradas (N ímpar); mata picos isolados
+template <typename T, uint8_t N>
+class Median {
+  static_assert(N % 2 == 1, "Median: N precisa ser impar");
+
+public:
+  T process(T x, uint32_t) {
+    _win[_head] = x;
+    _head = (_head + 1) % N;
+    if (_count < N) _count++;
+    T s[N];
+    for (uint8_t i = 0; i < _count; i++) {
+      // inserção: N pequeno, sem chamada de biblioteca
+      T v = _win[i];
+      uint8_t j = i;
+      while (j > 0 && s[j - 1] > v) { s[j] = s[j - 1]; j--; }
+      s[j] = v;
+    }
+    return s[_count / 2];
+  }
+  void reset() { _head = _count = 0; }
+
+private:
+  T _win[N];
+  uint8_t _head = 0;
+  uint8_t _count = 0;
+};
+
+// média móvel exponencial; a primeira entrada semeia
+class Ema {
+public:
+  explicit Ema(float alpha) : _alpha(alpha) {}
+  float process(float x, uint32_t) {
+    _y = _init ? _alpha * x + (1.0f - _alpha) * _y : x;
+    _init = true;
+    return _y;
+  }
+  float value() const { return _y; }
+  void reset() { _init = false; }
+
+private:
+  float _alpha;
+  float _y = 0.0f;
+  bool _init = false;
+};
+
+// saída só muda quando a entrada se afasta mais que band
+class Deadband {
+public:
+  explicit Deadband(float band) : _band(band) {}
+  float process(float x, uint32_t) {
+    if (!_init || fabsf(x - _y) > _band) _y = x;
+    _init = true;
+    return _y;
+  }
+  void reset() { _init = false; }
+
+private:
+  float _band;
+  float _y = 0.0f;
+  bool _init = false;
+};
+
+template <typename T>
+class Clamp {
+public:
+  Clamp(T lo, T hi) : _lo(lo), _hi(hi) {}
+  T process(T x, uint32_t) { return x < _lo ? _lo : (x > _hi ? _hi : x); }
+  void reset() {}
+
+private:
+  T _lo, _hi;
+};
+
+// y = gain * x + offset (calibração de dois pontos)
+class Linear {
+public:
+  Linear(float gain, float offset) : _gain(gain), _offset(offset) {}
+  float process(float x, uint32_t) { return _gain * x + _offset; }
+  void reset() {}
+
+private:
+  float _gain, _offset;
+};
+
+// nível discreto confirmado: a entrada precisa ficar parada riseMs para
+// subir (≠ 0) ou fallMs para descer (0); a primeira entrada semeia
+template <typename T>
+class Debounce {
+public:
+  Debounce(uint32_t riseMs, uint32_t fallMs) : _riseMs(riseMs), _fallMs(fallMs) {}
+  T process(T x, uint32_t nowMs) {
+    if (!_init) {
+      _stable = _last = x;
+      _init = true;
+    }
+    if (x != _last) {
+      _last = x;
+      _markMs = nowMs;
+    }
+    if (x != _stable && nowMs - _markMs >= (x ? _riseMs : _fallMs)) _stable = x;
+    return _stable;
+  }
+  T value() const { return _stable; }
+  void reset() { _init = false; }
+
+private:
+  uint32_t _riseMs, _fallMs;
+  uint32_t _markMs = 0;
+  T _stable = T();
+  T _last = T();
+  bool _init = false;
+};
+
+// ==== composição ====
+
+template <typename T, typename... Stages>
+class Pipeline;
+
+template <typename T>
+class Pipeline<T> {
+public:
+  T process(T x, uint32_t) { return x; }
+  void reset() {}
+};
+
+template <typename T, typename Head, typename... Tail>
+class Pipeline<T, Head, Tail...> {
+public:
+  Pipeline(const Head& head, const Tail&... tail) : _head(head), _tail(tail...) {}
+
+  T process(T x, uint32_t nowMs = 0) { return _tail.process(_head.process(x, nowMs), nowMs); }
+  void reset() {
+    _head.reset();
+    _tail.reset();
+  }
+
+  // acesso a um estágio (ex.: valor intermediário para log)
+  Head& head() { return _head; }
+  const Head& head() const { return _head; }
+  Pipeline<T, Tail...>& tail() { return _tail; }
+  const Pipeline<T, Tail...>& tail() const { return _tail; }
+
+private:
+  Head _head;
+  Pipeline<T, Tail...> _tail;
+};
+
+}  // namespace Signal
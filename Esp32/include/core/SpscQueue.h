@@ -0,0 +1,52 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * SpscQueue<T, N> — fila circular sem trava, um produtor e um consumidor
+ * ---------------------------------------------------------------
+ *  - Cada índice só é escrito por um lado: _head pelo produtor, _tail pelo
+ *    consumidor; acquire/release garante que o slot está completo antes de
+ *    o outro lado enxergar o índice novo
+ *  - Nunca bloqueia: push() com a fila cheia devolve false (quem produz
+ *    decide se descarta ou tenta de novo), pop() vazia devolve false
+ *  - N potência de 2; índices crescem livres e dão a volta sozinhos
+ *  - Seguro entre os dois núcleos do ESP32; não serve para ISR com mais de
+ *    um produtor. Sem dependência do Arduino: compila no host.
+ */
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue: N precisa ser potencia de 2");
+
+public:
+  // ---- produtor ----
+  bool push(const T& v) {
+    const uint32_t head = _head.load(std::memory_order_relaxed);
+    if (head - _tail.load(std::memory_order_acquire) == N) return false;
+    _buf[head & (N - 1)] = v;
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // ---- consumidor ----
+  bool pop(T& out) {
+    const uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (_head.load(std::memory_order_acquire) == tail) return false;
+    out = _buf[tail & (N - 1)];
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // aproximado quando lido pelo outro lado (só para métricas)
+  size_t size() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+  static constexpr size_t capacity() { return N; }
+
+private:
+  T _buf[N];
+  std::atomic<uint32_t> _head{0};
+  std::atomic<uint32_t> _tail{0};
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * WindowStats — resumo de uma janela de amostras em memória constante
+ * ---------------------------------------------------------------
+ *  - add(x) em O(1): n, média e variância por Welford (sem somas grandes
+ *    nem cancelamento), mínimo e máximo
+ *  - p5/p50/p95: exatos enquanto a janela cabe no buffer fixo (EXACT
+ *    amostras ordenadas — 5 min a cada 25 s = 12); passou disso, segue
+ *    pelo P² (Jain & Chlamtac), com os marcadores semeados do buffer
+ *  - reset() abre a próxima janela; memória fixa (~250 bytes)
+ *  Sem dependência do Arduino: compila no host.
+ */
+class WindowStats {
+public:
+  struct Summary {
+    uint32_t n;
+    float mean;
+    float stddev;   // amostral (n - 1); 0 com n < 2
+    float min;
+    float max;
+    float p5;
+    float p50;
+    float p95;
+  };
+
+  void add(float x);
+  void reset();
+  uint32_t count() const { return _n; }
+  Summary summary() const;
+  float quantile(float p) const;
+
+  // {"n":..,"avg":..,"sd":..,"min":..,"max":..,"p5":..,"p50":..,"p95":..}
+  // 0 = não coube (out vira "")
+  static size_t toJson(const Summary& s, char* out, size_t len, uint8_t decimals = 2);
+
+private:
+  // estimador P² de um quantil: 5 marcadores ajustados por interpolação
+  // parabólica a cada amostra
+  class P2 {
+  public:
+    explicit P2(float p) : _p(p) {}
+    void init(const float* sorted, uint32_t n);   // n >= 5
+    void add(float x);
+    float value() const { return _q[2]; }
+  private:
+    float _p;
+    float _q[5];      // alturas
+    float _np[5];     // posições desejadas
+    int32_t _pos[5];  // posições reais
+    float parabolic(int i, int d) const;
+    float linear(int i, int d) const;
+  };
+
+  static constexpr uint8_t EXACT = 16;
+
+  uint32_t _n = 0;
+  double _mean = 0.0;
+  double _m2 = 0.0;
+  float _min = 0.0f;
+  float _max = 0.0f;
+  float _sorted[EXACT];   // primeiras amostras da janela, ordenadas
+  P2 _p5{0.05f};
+  P2 _p50{0.50f};
+  P2 _p95{0.95f};
+};
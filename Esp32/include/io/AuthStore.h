@@ -0,0 +1,36 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * AuthToken — ID token do Firebase Auth + refresh token
+ *  expiresAt em epoch (s); só faz sentido com o relógio sincronizado.
+ */
+struct AuthToken {
+    static constexpr uint16_t ID_LEN      = 1400;
+    static constexpr uint16_t REFRESH_LEN = 512;
+
+    char     id[ID_LEN];
+    char     refresh[REFRESH_LEN];
+    uint32_t expiresAt;
+
+    void clear() { id[0] = '\0'; refresh[0] = '\0'; expiresAt = 0; }
+    bool hasRefresh() const { return refresh[0] != '\0'; }
+    // token ainda vale por pelo menos marginS segundos
+    bool validFor(uint32_t nowEpoch, uint32_t marginS) const {
+        return id[0] != '\0' && expiresAt > nowEpoch + marginS;
+    }
+};
+
+/**
+ * AuthStore — persiste o AuthToken em NVS (Preferences)
+ * ---------------------------------------------------------------
+ *  - Namespace "fbauth": id, refresh, exp e o hash do usuário; token de
+ *    outra conta (Secrets.h trocado) é ignorado
+ *  - Gravado a cada renovação (~1x por hora): desgaste de NVS desprezível
+ */
+class AuthStore {
+public:
+    bool load(AuthToken& t, const char* user);
+    bool save(const AuthToken& t, const char* user);
+    void clear();
+};
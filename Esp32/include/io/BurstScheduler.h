@@ -0,0 +1,72 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * BurstScheduler — tráfego periódico em janelas, modem sleep entre elas
+ * ---------------------------------------------------------------
+ *  - Uma janela periódica a cada PERIOD_MS: quem é periódico (heartbeat,
+ *    séries, diag, fila offline) espera por ela em vez de sair na hora
+ *  - Pedido urgente (SAFETY/CONTROL pendente, OTA) abre janela já
+ *  - Janela aberta → rádio acordado (WIFI_PS_NONE); fecha quando não há
+ *    mais nada pendente/em voo e passou MIN_OPEN_MS, ou em MAX_OPEN_MS
+ *  - Fechada → WIFI_PS_MAX_MODEM: o rádio só acorda nos beacons (DTIM);
+ *    o stream de comandos continua chegando, com atraso ≤ ~300 ms
+ *  - Não gerenciado (sem Firebase pronto): rádio sempre acordado
+ *  - Métricas: janelas (periódicas/urgentes), tempo com rádio acordado e
+ *    energia estimada por hora pelo modelo RADIO_MA/SLEEP_MA (estimativa;
+ *    calibrar com medição na bancada)
+ *  Lógica sem dependência do Arduino: compila no host (rádio vira no-op).
+ */
+class BurstScheduler {
+public:
+  static constexpr uint32_t PERIOD_MS   = 10000;   // = heartbeat
+  static constexpr uint32_t MIN_OPEN_MS = 300;     // respostas do update
+  static constexpr uint32_t MAX_OPEN_MS = 3000;
+  static constexpr uint32_t HOUR_MS     = 3600000;
+  static constexpr uint16_t RADIO_MA    = 100;     // RX/TX ativo, CPU 240 MHz
+  static constexpr uint16_t SLEEP_MA    = 30;      // modem sleep (média c/ beacons)
+  static constexpr uint16_t SUPPLY_MV   = 3300;
+
+  struct Hour {
+    uint32_t windows = 0;
+    uint32_t urgent = 0;       // janelas abertas fora do período
+    uint32_t awakeMs = 0;
+    uint32_t sleepMs = 0;
+    uint32_t mWh() const;      // energia estimada no intervalo
+    uint16_t awakePermille() const;
+  };
+
+  void begin(uint32_t now);
+  // managed = false → rádio acordado e nada adiado (boot, reconexão)
+  void setManaged(bool managed, uint32_t now);
+  // urgent: há tráfego que não pode esperar; busy: escritas pendentes ou
+  // em voo (segura a janela aberta até a resposta)
+  void tick(uint32_t now, bool urgent, bool busy);
+
+  // tráfego periódico pode sair?
+  bool open() const { return _open || !_managed; }
+  // true uma única vez por janela periódica (dispara o heartbeat)
+  bool periodicDue();
+
+  const Hour& lastHour() const { return _last; }
+  const Hour& thisHour() const { return _cur; }
+  size_t toJson(char* out, size_t len) const;
+  void printStats() const;
+
+private:
+  bool     _managed = false;
+  bool     _open = false;
+  bool     _periodicEdge = false;
+  uint32_t _nextAt = 0;
+  uint32_t _openedAt = 0;
+  uint32_t _markAt = 0;        // último acúmulo de awake/sleep
+  uint32_t _hourAt = 0;
+  Hour     _cur;
+  Hour     _last;
+
+  void openWindow(uint32_t now, bool periodic);
+  void closeWindow(uint32_t now);
+  void account(uint32_t now);
+  static void radioAwake(bool awake);
+};
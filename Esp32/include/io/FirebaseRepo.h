@@ -1,14 +1,27 @@
 #pragma once
 #include <Arduino.h>
-#include <WiFiClientSecure.h>
 #include <FirebaseClient.h>
+#include "io/RtdbScheduler.h"
+#include "io/TlsSessionClient.h"
+#include "io/OfflineQueue.h"
+#include "io/ShadowState.h"
+#include "core/SeriesCodec.h"
 
 /**
  * Módulo FirebaseRepo — compatível com mobizt/FirebaseClient v1.5.11
  * ---------------------------------------------------------------
  *  - Autenticação por e-mail/senha
+ *  - TLS verificado pelo bundle de CAs, com retomada de sessão
  *  - RTDB assíncrono (set/get)
  *  - Logs, heartbeat, séries, comandos edge
+ *  - Escritas agrupadas e priorizadas (RtdbScheduler): segurança >
+ *    controle > telemetria > logs, com fila limitada por classe
+ *  - Séries e logs gerados offline vão para uma fila em LittleFS e são
+ *    drenados em ordem quando o app volta a ficar pronto
+ *  - Caminhos vêm de RtdbPaths (constexpr) e sufixos são montados na
+ *    pilha: publicar não aloca heap
+ *  - Estados/instantâneos passam por um espelho (ShadowState): só
+ *    mudanças reais, com zona morta por nó e refresh periódico
  */
 class FirebaseRepo {
 public:
@@ -17,10 +30,11 @@ public:
              const char* userEmail,
              const char* userPass,
              const char* databaseUrl,
-             bool insecureTLS = true);
+             bool insecureTLS = false);
 
   void handle();
   bool ready();
+  void flush();
 
   // ---- estados / sensores ----
   void setHeaterState(bool on);
@@ -35,15 +49,21 @@ public:
   void setPhCurrent(float v);
 
   // ---- modos / auditoria ----
-  void setMode(const String& actuator, const String& modeStr);
-  void logManualOverride(const String& actuator, bool value, const char* reason);
+  void setMode(const char* actuator, const char* modeStr);
+  void logManualOverride(const char* actuator, bool value, const char* reason);
+  inline void setMode(const String& actuator, const String& modeStr) {
+    setMode(actuator.c_str(), modeStr.c_str());
+  }
+  inline void logManualOverride(const String& actuator, bool value, const char* reason) {
+    logManualOverride(actuator.c_str(), value, reason);
+  }
   void logHeaterDecision(float tC, bool newState, float onThr, float offThr, const char* reason);
 
   // ---- heartbeat ----
   void publishLastSeen();
   inline void lastSeen() { publishLastSeen(); }
 
-  // ---- séries históricas ----
+  // ---- séries históricas (chunks compactados por hora) ----
   void pushTempAvg(float avgC);
   void pushPHAvg(float avgPH);
   inline void pushPhAvg(float v) { pushPHAvg(v); }
@@ -65,17 +85,44 @@ public:
 
 private:
   // objetos FirebaseClient v1.5.11
-  WiFiClientSecure    _ssl;
+  TlsSessionClient    _ssl;
   network_config_data _net{};
   AsyncClientClass    _client{_ssl, _net};
   FirebaseApp         _app;
   RealtimeDatabase    _rtdb;
   UserAuth*           _auth{nullptr};
+  using Prio = RtdbScheduler::Prio;
+  RtdbScheduler       _sched;
+  OfflineQueue        _backlog;
+  uint32_t            _backlogDropMark{0};
+  ShadowState         _shadow;
+  bool                _wasReady{false};
+  // chunk aberto + amostras que não saíram ao vivo (offline)
+  struct Series {
+    SeriesCodec::Encoder enc;
+    bool unsent = false;
+  };
+  Series _tempSeries;
+  Series _phSeries;
+  static FirebaseRepo* _instance;
 
   String _apiKey, _email, _pass, _dbUrl;
   bool   _readyNotified{false};
   bool   _feederReady{false};
 
+  enum ShadowNode : uint8_t {
+    SH_RELAY_HEATER = 0,
+    SH_RELAY_WATERFALL,
+    SH_WATER_OK,
+    SH_TEMP_CURRENT,
+    SH_PH_CURRENT,
+    SH_FEEDER_BUSY,
+  };
+  static constexpr uint32_t STATE_REFRESH_MS = 600000;
+  static constexpr uint8_t  BACKLOG_DRAIN_MAX = 16;
+
+  void appendSeries(Series& s, const char* name, float v);
+  void writeChunk(const SeriesCodec::Encoder& enc, const char* name, bool live);
   static uint64_t epochMillisSafe();
   static void onAsync(AsyncResult& r);
 };
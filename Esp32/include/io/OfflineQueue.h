@@ -0,0 +1,69 @@
+#pragma once
+#include <Arduino.h>
+#include "io/RtdbScheduler.h"
+
+/**
+ * OfflineQueue — store-and-forward em LittleFS
+ * ---------------------------------------------------------------
+ *  - Guarda amostras/logs que não puderam ser enviados (Firebase fora)
+ *  - Segmentos só de acréscimo: o registro `seq` vai para o fim do
+ *    arquivo <dir>/<(seq-1)/SEG_RECORDS>. LittleFS é copy-on-write:
+ *    acrescentar regrava só o último bloco, enquanto escrever no meio de
+ *    um arquivo regravaria dali até o fim
+ *  - Segmento inteiro confirmado é apagado; cheio (MAX_SEGMENTS) descarta
+ *    o segmento mais antigo
+ *  - Só o último seq confirmado vai para um arquivo de controle, uma vez
+ *    por lote drenado (não a cada registro)
+ *  - Queda de energia no meio de um acréscimo: no boot o segmento da
+ *    cabeça é recortado até o último registro íntegro
+ *  - RAM constante: apenas contadores; registros são lidos sob demanda
+ */
+class OfflineQueue {
+public:
+    static constexpr uint16_t SEG_RECORDS  = 32;
+    static constexpr uint8_t  MAX_SEGMENTS = 8;    // 256 registros
+    static constexpr uint8_t  PATH_LEN     = RtdbScheduler::PATH_LEN;
+    static constexpr uint8_t  VALUE_LEN    = RtdbScheduler::VALUE_LEN;
+    static constexpr uint32_t INFLIGHT_TIMEOUT_MS = 30000;
+
+    bool begin(const char* dir, const char* ackFile);
+
+    bool push(const char* path, const char* rawJson);
+    bool pushFloat(const char* path, float v, uint8_t decimals = 3);
+    bool pushU64(const char* path, uint64_t v);
+    bool pushString(const char* path, const char* v);   // escapada como o setString
+
+    // Copia os registros mais antigos (em ordem) para o scheduler, até `max`
+    uint8_t drainInto(RtdbScheduler& sched, RtdbScheduler::Prio prio, uint8_t max, uint32_t now);
+    void commit();                 // último dreno entregue
+    void rollback();               // último dreno falhou → reenviar
+    void checkTimeout(uint32_t now);
+
+    uint32_t pending() const { return _headSeq - _ackedSeq; }
+    bool inFlight() const { return _inflightSeq != 0; }
+    bool ok() const { return _ok; }
+
+private:
+    struct Record {
+        uint32_t seq;
+        char     path[PATH_LEN];
+        char     value[VALUE_LEN];
+        uint32_t crc;
+    };
+
+    char     _dir[20] = {0};
+    char     _ackFile[24] = {0};
+    bool     _ok = false;
+    uint32_t _headSeq = 0;         // último seq gravado
+    uint32_t _ackedSeq = 0;        // último seq confirmado
+    uint32_t _inflightSeq = 0;     // último seq do dreno em voo
+    uint32_t _inflightAt = 0;
+    uint32_t _firstSeg = 0;        // segmento mais antigo que ainda pode existir
+
+    static uint32_t checksum(const Record& r);
+    static uint32_t segmentOf(uint32_t seq) { return (seq - 1) / SEG_RECORDS; }
+    void segmentPath(uint32_t seg, char* out, size_t len) const;
+    uint32_t repairSegment(uint32_t seg);
+    void dropSegmentsUpTo(uint32_t seq);
+    void saveAck();
+};
@@ -0,0 +1,129 @@
+#pragma once
+#include <Arduino.h>
+#include <FirebaseClient.h>
+
+/**
+ * RtdbScheduler — fila de escritas do RTDB com prioridade
+ * ---------------------------------------------------------------
+ *  - Pares caminho/valor vão para um pool limitado (MAX_ENTRIES)
+ *  - flush() monta um único update multi-caminho (PATCH na raiz) com até
+ *    MAX_PER_UPDATE entradas, da classe mais prioritária para a menos:
+ *      SAFETY → CONTROL → TELEMETRY → LOGS
+ *  - Merge: mesmo caminho ainda pendente → vale o último valor
+ *  - Back-pressure: com MAX_INFLIGHT updates sem resposta, só SAFETY sai
+ *  - Cota por classe: estourou → descarta a entrada pendente mais antiga
+ *    da classe; pool cheio → despeja a mais antiga de classe inferior;
+ *    SAFETY_RESERVE posições livres ficam sempre guardadas para SAFETY
+ *  - Entradas ficam "em voo" até a resposta: erro → voltam a pendentes
+ *    (salvo se já houver valor mais novo para o mesmo caminho, pendente
+ *    ou em voo num lote posterior)
+ *  - PATCH multi-caminho é tudo ou nada: lote recusado pelo servidor
+ *    (regra, caminhos sobrepostos) marca as entradas como suspeitas. Cada
+ *    suspeita sai sozinha num lote solo, alternando com os lotes normais
+ *    e sem passar na frente de SAFETY; MAX_REJECTS recusas → descartada e
+ *    o caminho fica lembrado (escrita nova nele já nasce suspeita)
+ *  - Descarte por cota/pool avisa o DropHook: quem espelha o valor
+ *    (ShadowState) sabe que aquele caminho não vai chegar
+ *
+ *  Respostas: cada flush sai com um uid próprio "<prefixo>#<lote>" e
+ *  onResult() casa pelo lote, não pela ordem. Resposta atrasada de um
+ *  lote que já expirou (RESULT_TIMEOUT_MS) é ignorada: as entradas dele
+ *  já voltaram para a fila e podem estar em outro lote.
+ */
+class RtdbScheduler {
+public:
+    enum class Prio : uint8_t { SAFETY = 0, CONTROL, TELEMETRY, LOGS, COUNT };
+
+    static constexpr uint8_t  MAX_ENTRIES    = 24;
+    static constexpr uint8_t  MAX_PER_UPDATE = 16;
+    static constexpr uint8_t  MAX_INFLIGHT   = 2;
+    static constexpr uint8_t  SAFETY_RESERVE = 2;    // posições só para SAFETY
+    static constexpr uint8_t  PATH_LEN       = 72;
+    static constexpr uint8_t  VALUE_LEN      = 104;  // cabe um chunk de série (base64)
+    static constexpr uint32_t RESULT_TIMEOUT_MS = 30000;
+    static constexpr uint8_t  MAX_REJECTS    = 3;    // recusas até descartar a entrada
+    static constexpr uint8_t  BAD_PATHS      = 4;    // caminhos recusados lembrados
+
+    // caminho (sem '/' inicial) que saiu da fila sem ser entregue
+    using DropHook = void (*)(void* ctx, const char* path);
+
+    struct ClassStats {
+        uint32_t enqueued = 0;
+        uint32_t merged = 0;
+        uint32_t dropped = 0;
+        uint32_t sent = 0;
+        uint32_t failed = 0;
+        uint32_t rejected = 0;       // descartadas por recusa do servidor
+        uint32_t waitTotalMs = 0;
+        uint32_t waitMaxMs = 0;
+        uint8_t  depth = 0;          // pendentes + em voo
+        uint8_t  maxDepth = 0;
+    };
+
+    bool setBool(const char* path, bool v, Prio p = Prio::TELEMETRY);
+    bool setInt(const char* path, long v, Prio p = Prio::TELEMETRY);
+    bool setU64(const char* path, uint64_t v, Prio p = Prio::TELEMETRY);
+    bool setFloat(const char* path, float v, Prio p = Prio::TELEMETRY, uint8_t decimals = 3);
+    bool setString(const char* path, const char* v, Prio p = Prio::TELEMETRY);
+    // valor já serializado em JSON (ex.: vindo da fila offline)
+    bool setRaw(const char* path, const char* rawJson, Prio p = Prio::TELEMETRY);
+    // serializa `v` como string JSON em out (len >= 4); devolve o tamanho
+    static size_t quote(const char* v, char* out, size_t len);
+
+    void setDropHook(DropHook fn, void* ctx) { _dropHook = fn; _dropCtx = ctx; }
+
+    bool hasPending() const;
+    uint8_t depth(Prio p) const { return _stats[(uint8_t)p].depth; }
+    uint8_t room(Prio p) const;
+    const ClassStats& stats(Prio p) const { return _stats[(uint8_t)p]; }
+    void printStats() const;
+
+    // Envia um update com as entradas mais prioritárias. false = nada enviado
+    bool flush(RealtimeDatabase& db, AsyncClientClass& client,
+               AsyncResultCallback cb, const char* uid, uint32_t now);
+    // uid do AsyncResult; false = não é um lote em voo (atrasado/alheio).
+    // rejected: o servidor recusou o conteúdo (HTTP 400/403), não a rede
+    bool onResult(const char* uid, bool ok, bool rejected = false);
+    void checkTimeout(uint32_t now);
+    static bool isBatchUid(const char* uid, const char* prefix);
+    const char* lastUid() const { return _uid; }
+    uint8_t inFlight() const { return _inflight; }
+
+private:
+    enum class State : uint8_t { FREE = 0, PENDING, INFLIGHT };
+
+    struct Entry {
+        char     path[PATH_LEN];
+        char     value[VALUE_LEN];
+        State    state = State::FREE;
+        Prio     prio = Prio::TELEMETRY;
+        uint32_t queuedAt = 0;
+        uint32_t sentAt = 0;
+        uint32_t gen = 0;
+        uint8_t  rejects = 0;        // > 0 = suspeita: só sai em lote solo
+    };
+
+    Entry      _entries[MAX_ENTRIES];
+    ClassStats _stats[(uint8_t)Prio::COUNT];
+    uint32_t   _gen = 0;             // último lote enviado
+    uint8_t    _inflight = 0;        // lotes sem resposta
+    char       _uid[32] = {0};
+    String     _json;
+    DropHook   _dropHook = nullptr;
+    void*      _dropCtx = nullptr;
+    uint32_t   _badPaths[BAD_PATHS] = {0};   // hash dos caminhos descartados por recusa
+    uint8_t    _badNext = 0;
+    bool       _soloTurn = false;   // próximo flush é de uma suspeita
+
+    bool put(const char* path, const char* rawJson, Prio p);
+    int8_t oldestPending(Prio p) const;
+    void release(Entry& e);
+    void evict(Entry& e);
+    bool superseded(const Entry& e) const;
+    bool settle(uint32_t gen, bool ok, bool rejected);
+    int8_t nextSuspect(bool safetyOnly) const;
+    void take(Entry& e, uint32_t gen, uint32_t now);
+    static uint32_t pathHash(const char* path);
+    bool knownBad(const char* path) const;
+    void forgetBad(const char* path);
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include "io/RtdbScheduler.h"
+
+/**
+ * ShadowState — cópia local dos nós de estado publicados
+ * ---------------------------------------------------------------
+ *  - Só enfileira o que realmente mudou: bool pela igualdade, float além
+ *    da zona morta (deadband) do nó
+ *  - maxStaleMs > 0: reenvia o último valor mesmo parado (refresh)
+ *  - Cada nó tem sua classe de prioridade no RtdbScheduler; a entrega
+ *    (e o reenvio em caso de erro) fica a cargo do scheduler
+ *  - attach(): o scheduler avisa quando descarta um caminho (cota/pool) e
+ *    o nó volta a sujo; pedido recusado também. refresh() reenvia quando a
+ *    classe tiver espaço
+ */
+class ShadowState {
+public:
+    using Prio = RtdbScheduler::Prio;
+    static constexpr uint8_t MAX_NODES = 12;
+
+    // um espelho por scheduler (o DropHook é único)
+    void attach(RtdbScheduler& sched);
+    void define(uint8_t id, const char* path, Prio prio,
+                float deadband = 0.0f, uint32_t maxStaleMs = 0);
+
+    bool publishBool(RtdbScheduler& sched, uint8_t id, bool v, uint32_t now);
+    bool publishFloat(RtdbScheduler& sched, uint8_t id, float v, uint32_t now);
+
+    // reenvia nós invalidados ou velhos (maxStaleMs)
+    void refresh(RtdbScheduler& sched, uint32_t now);
+    // esquece o que foi enviado (ex.: reconexão) → tudo é reenviado
+    void invalidate();
+
+    uint32_t suppressed() const { return _suppressed; }
+
+private:
+    enum class Kind : uint8_t { NONE, BOOL, FLOAT };
+
+    struct Node {
+        const char* path = nullptr;
+        Kind     kind = Kind::NONE;
+        Prio     prio = Prio::TELEMETRY;
+        float    deadband = 0.0f;
+        uint32_t maxStaleMs = 0;
+        float    desired = NAN;      // último valor pedido pelo app
+        float    sent = NAN;         // último valor enfileirado
+        bool     hasSent = false;
+        bool     dirty = false;
+        uint32_t sentAt = 0;
+    };
+
+    Node     _nodes[MAX_NODES];
+    uint32_t _suppressed = 0;
+
+    bool publish(RtdbScheduler& sched, uint8_t id, float v, uint32_t now);
+    bool enqueue(RtdbScheduler& sched, Node& n, uint32_t now);
+    void markDropped(const char* path);
+    static void onDropped(void* ctx, const char* path);
+};
@@ -1,3 +1,12 @@
 #pragma once
 #include <Arduino.h>
-void syncTimeTZ();
+
+/**
+ * TimeSync — SNTP em segundo plano alimentando o Clock
+ *  begin() só configura (não espera a rede); a cada resposta do servidor
+ *  o callback do SNTP grava a referência epoch/mono em Clock::sync().
+ *  Clock::synced() diz quando já dá para datar.
+ */
+namespace TimeSync {
+  void begin(long gmtOffsetSec, const char* server1, const char* server2);
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <Arduino.h>
+#include <Client.h>
+#include <WiFiClient.h>
+#include "mbedtls/ssl.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/x509_crt.h"
+
+/**
+ * TlsSessionClient — cliente TLS (mbedTLS sobre WiFiClient) com retomada
+ * ---------------------------------------------------------------
+ *  - Substitui WiFiClientSecure para o AsyncClient do FirebaseClient
+ *    (mesma interface Client)
+ *  - Verifica o servidor com um bundle de CAs (setCACert); setInsecure()
+ *    continua existindo só para depuração
+ *  - Após cada handshake completo a sessão (ticket/ID) é serializada num
+ *    cache em RTC: reconexões (queda de Wi-Fi, reauth, reset por
+ *    software) tentam o handshake abreviado antes do completo
+ *  - Cache compartilhado por host entre instâncias (o stream e o cliente
+ *    principal falam com o mesmo host do RTDB)
+ *  - Métricas: handshakes completos x retomados, tempo médio/máximo,
+ *    tickets recusados; também em RTC, zeradas só no power-on
+ */
+class TlsSessionClient : public Client {
+public:
+    static constexpr uint8_t  CACHE_SLOTS = 2;        // RTDB + Auth
+    static constexpr uint16_t SESSION_MAX = 2048;     // sessão serializada (inclui cert do par)
+    static constexpr uint8_t  HOST_LEN    = 64;
+
+    // POD: vive em RTC_NOINIT junto do cache de sessões
+    struct Stats {
+        uint32_t full;               // handshakes completos
+        uint32_t resumed;            // handshakes abreviados (sessão aceita)
+        uint32_t rejected;           // sessão oferecida e recusada → completo
+        uint32_t failed;             // handshake com erro / timeout
+        uint32_t fullMsTotal;
+        uint32_t resumedMsTotal;
+        uint32_t fullMsMax;
+        uint32_t lastMs;
+    };
+
+    TlsSessionClient();
+    ~TlsSessionClient();
+
+    void setCACert(const char* pem) { _ca = pem; }
+    void setInsecure() { _ca = nullptr; }
+    void setHandshakeTimeout(uint32_t ms) { _timeoutMs = ms; }
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    int connect(IPAddress ip, uint16_t port, int32_t timeoutMs) {
+        _timeoutMs = timeoutMs;
+        return connect(ip, port);
+    }
+    int connect(const char* host, uint16_t port, int32_t timeoutMs) {
+        _timeoutMs = timeoutMs;
+        return connect(host, port);
+    }
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override;
+    void flush() override;
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected(); }
+
+    // esquece a sessão guardada para o host (ex.: troca de credenciais)
+    static void forgetSession(const char* host);
+    static const Stats& stats();
+    static void printStats();
+
+private:
+    WiFiClient               _tcp;
+    mbedtls_ssl_context      _ssl;
+    mbedtls_ssl_config       _conf;
+    mbedtls_ctr_drbg_context _drbg;
+    mbedtls_entropy_context  _entropy;
+    mbedtls_x509_crt         _cacert;
+    const char* _ca = nullptr;
+    uint32_t    _timeoutMs = 15000;
+    bool        _init = false;
+    bool        _ready = false;
+    int         _peeked = -1;
+
+    bool setup(const char* host);
+    void teardown();
+    bool handshake(const char* host);
+
+    static int bioSend(void* ctx, const unsigned char* buf, size_t len);
+    static int bioRecv(void* ctx, unsigned char* buf, size_t len);
+};
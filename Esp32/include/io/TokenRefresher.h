@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+#include "io/AuthStore.h"
+#include "io/TlsSessionClient.h"
+
+/**
+ * TokenRefresher — renova o ID token pelo refresh token (securetoken)
+ * ---------------------------------------------------------------
+ *  - start(): conecta (handshake TLS, em geral retomado) e envia o POST
+ *    grant_type=refresh_token; HTTP/1.0 para a resposta vir sem chunked
+ *  - poll(): lê o que chegou, sem bloquear; com a conexão fechada
+ *    interpreta a resposta e preenche o AuthToken
+ *  - Não mexe no FirebaseApp: quem chama decide quando trocar o token
+ */
+class TokenRefresher {
+public:
+    enum class State : uint8_t { IDLE, READING, DONE, FAILED };
+
+    static constexpr uint16_t RESPONSE_LEN = 4096;   // cabeçalhos + 2 tokens
+    static constexpr uint32_t TIMEOUT_MS   = 15000;
+
+    void setCACert(const char* pem) { _tls.setCACert(pem); }
+
+    bool start(const char* apiKey, const char* refreshToken);
+    // DONE/FAILED são entregues uma vez; depois volta a IDLE
+    // (out só é sobrescrito em DONE)
+    State poll(AuthToken& out, uint32_t nowEpoch);
+    bool busy() const { return _state != State::IDLE; }
+
+private:
+    TlsSessionClient _tls;
+    char     _buf[RESPONSE_LEN];
+    size_t   _len = 0;
+    uint32_t _startedMs = 0;
+    State    _state = State::IDLE;
+
+    bool parse(AuthToken& out, uint32_t nowEpoch);
+};
@@ -1,8 +1,70 @@
 #pragma once
 #include <Arduino.h>
+
+/**
+ * WiFiManager — conexão Wi-Fi sem bloquear o loop
+ * ---------------------------------------------------------------
+ *  - begin() só dispara a primeira tentativa; handle() avança a máquina
+ *    de estados a cada tick (nunca espera o rádio)
+ *  - Eventos do driver (GOT_IP / DISCONNECTED) só marcam flags; a
+ *    transição acontece no próximo handle()
+ *  - Reconexão rápida: BSSID + canal do último AP ficam na NVS e a
+ *    primeira tentativa pula o scan; falhou → tentativa com scan
+ *  - Falhas seguidas → espera exponencial (1 s … 60 s)
+ *  - Métricas: tentativas, conexões (rápidas x com scan), quedas e
+ *    tempo até o IP (médio/máximo/último)
+ */
 class WiFiManager {
 public:
+  enum class State : uint8_t { IDLE, CONNECTING, CONNECTED, BACKOFF };
+
+  struct Stats {
+    uint32_t attempts = 0;
+    uint32_t connects = 0;
+    uint32_t fastConnects = 0;     // via BSSID/canal em cache
+    uint32_t failures = 0;
+    uint32_t drops = 0;            // quedas depois de conectado
+    uint32_t totalConnectMs = 0;
+    uint32_t maxConnectMs = 0;
+    uint32_t lastConnectMs = 0;
+    uint8_t  lastReason = 0;       // wifi_err_reason_t da última queda
+  };
+
+  static constexpr uint32_t FAST_TIMEOUT_MS = 4000;
+  static constexpr uint32_t SCAN_TIMEOUT_MS = 15000;
+  static constexpr uint32_t BACKOFF_MIN_MS  = 1000;
+  static constexpr uint32_t BACKOFF_MAX_MS  = 60000;
+
   void begin(const char* ssid, const char* pass);
-  void handle();
-  bool connected() const;
+  void handle(uint32_t now);
+  bool connected() const { return _state == State::CONNECTED; }
+  State state() const { return _state; }
+  // true uma única vez a cada (re)conexão
+  bool justConnected();
+  const Stats& stats() const { return _stats; }
+  void printStats() const;
+
+private:
+  const char* _ssid = nullptr;
+  const char* _pass = nullptr;
+  State    _state = State::IDLE;
+  Stats    _stats;
+  uint32_t _attemptAt = 0;
+  uint32_t _retryAt = 0;
+  uint8_t  _failStreak = 0;
+  bool     _fastAttempt = false;
+  bool     _connectedEdge = false;
+
+  uint8_t  _bssid[6] = {0};
+  uint8_t  _channel = 0;           // 0 = sem cache
+
+  volatile bool    _evGotIp = false;
+  volatile bool    _evLost = false;
+  volatile uint8_t _evReason = 0;
+
+  void startAttempt(uint32_t now);
+  void onConnected(uint32_t now);
+  void onFailed(uint32_t now);
+  void loadCache();
+  void saveCache();
 };
@@ -0,0 +1,30 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * AdcStream — ADC1 em modo contínuo (DMA), um canal, sem bloquear
+ * ---------------------------------------------------------------
+ *  - begin(): o controlador digital do ADC amostra o pino a SAMPLE_HZ e
+ *    o DMA enche um pool do driver em segundo plano (no ESP32, via I2S0)
+ *  - read(): copia o que já chegou, em contagens de 12 bits; nunca espera
+ *  - Pool cheio entre duas leituras → amostras antigas perdidas; conta em
+ *    overruns() (quem lê deve drenar a cada poucos ms)
+ *  - Só ADC1 (ADC2 é do Wi-Fi); com o modo contínuo ligado, analogRead()
+ *    no ADC1 deixa de ser confiável
+ *  - Core 2.x (IDF 4.4: adc_digi_*) e 3.x (IDF 5: adc_continuous_*)
+ */
+class AdcStream {
+public:
+  static constexpr uint32_t SAMPLE_HZ  = 20000;   // mínimo do controlador no ESP32
+  static constexpr uint32_t POOL_BYTES = 1024;    // ~25 ms de amostras no driver
+
+  bool begin(uint8_t pin);
+  // até max amostras (0..4095); 0 se nada chegou
+  size_t read(uint16_t* out, size_t max);
+  bool running() const { return _running; }
+  uint32_t overruns() const;
+
+private:
+  bool _running = false;
+  uint8_t _channel = 0;
+};
@@ -1,13 +1,58 @@
 #pragma once
 #include <Arduino.h>
+#include "sensors/AdcStream.h"
+#include "core/SignalPipeline.h"
+
+/**
+ * PhSensor — pH a partir do ADC contínuo, com filtro robusto
+ * ---------------------------------------------------------------
+ *  - poll(): drena o DMA (AdcStream) e soma blocos de OVERSAMPLE amostras
+ *    num anel de RING blocos: a 20 kHz, ~205 ms de sinal (10 ciclos de
+ *    50 Hz, 12 de 60 Hz). Chamar a cada poucos ms; custa µs
+ *  - readVolts(): média aparada do anel (descarta TRIM_PCT% de cada ponta):
+ *    picos e a ondulação da rede não passam; NAN até o anel ter dados
+ *  - readPH(): readVolts() → EMA → calibração → limites (Signal::Pipeline);
+ *    NAN sem dados
+ *  - trimmedMean() é portável (reordena o vetor recebido)
+ */
 class PhSensor {
 public:
-  void begin(uint8_t adcPin);
+  static constexpr uint8_t  OVERSAMPLE = 16;    // 16 x 4095 cabe em uint16_t
+  static constexpr uint16_t RING = 256;
+  static constexpr uint8_t  TRIM_PCT = 25;      // 25% = média interquartil
+
+  struct Stats {
+    uint32_t samples = 0;
+    uint32_t blocks = 0;
+    uint32_t pollUsMax = 0;
+    uint32_t filterUsLast = 0;
+    float spreadMvLast = NAN;     // faixa dos blocos mantidos (ruído)
+  };
+
+  PhSensor();
+  bool begin(uint8_t adcPin);
+  void poll();
+  float readVolts();
   float readPH();
-  float latest() const { return lastPH; }
+  float latest() const { return _lastPH; }
+  float filteredVolts() const { return _filter.head().value(); }   // saída da EMA
+  const Stats& stats() const { return _stats; }
+  void printStats() const;
+
+  // média de v[k..n-k) depois de separar as k menores e k maiores;
+  // spread recebe max - min dos mantidos
+  static float trimmedMean(uint16_t* v, size_t n, uint8_t trimPct, uint16_t* spread = nullptr);
+
 private:
-  uint8_t pin = 255;
-  bool init = false;
-  float emaV = 0.0f;
-  float lastPH = NAN;
+  AdcStream _adc;
+  uint16_t _ring[RING];
+  uint16_t _head = 0;
+  uint16_t _filled = 0;
+  uint32_t _blockSum = 0;
+  uint8_t  _blockN = 0;
+  Stats    _stats;
+
+  typedef Signal::Pipeline<float, Signal::Ema, Signal::Linear, Signal::Clamp<float>> Filter;
+  Filter   _filter;
+  float    _lastPH = NAN;
 };
@@ -1,10 +1,67 @@
 #pragma once
 #include <Arduino.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>
+
+/**
+ * TemperatureSensor — várias sondas DS18B20 no mesmo barramento, em duas fases
+ * ---------------------------------------------------------------
+ *  - start(): um único CONVERT T em broadcast (SKIP ROM) para todas as
+ *    sondas; volta na hora
+ *  - poll(): passado o tempo de conversão, lê UMA sonda por chamada direto
+ *    pelo ROM (sem busca); ROUND quando a última foi lida. O custo por tick
+ *    é o de uma leitura, com 1 ou N sondas
+ *  - Sonda 0 = tanque (controla o aquecedor); as demais (sump, perto do
+ *    aquecedor...) mantêm o índice entre boots: os ROMs ficam na NVS
+ *  - Boot: uma busca no barramento, casada com o cache; sonda nova ocupa
+ *    a vaga de uma que sumiu (troca) ou a próxima livre. Falha de leitura
+ *    → nova busca, no máximo a cada RESCAN_MS
+ *  - Sem sonda/sem presença o start() ainda gera rodada (NAN): quem controla
+ *    o aquecedor sempre recebe o fail-safe
+ */
 class TemperatureSensor {
 public:
-  void begin(uint8_t oneWirePin);
-  float readCelsius();
-  float latest() const { return lastC; }
+  static constexpr uint8_t  MAX_PROBES = 4;
+  static constexpr uint32_t RESCAN_MS  = 600000;   // 10 min
+
+  enum class Step : uint8_t { NONE, READ, ROUND };
+
+  struct Stats {
+    uint32_t rounds = 0;
+    uint32_t reads = 0;
+    uint32_t failures = 0;
+    uint32_t searches = 0;        // buscas no barramento (boot + após falha)
+    uint32_t startUsMax = 0;
+    uint32_t readUsMax = 0;       // uma sonda (scratchpad + CRC)
+    uint32_t readUsLast = 0;
+  };
+
+  void begin(uint8_t oneWirePin, uint8_t resolution = 12);
+  bool start(uint32_t nowMs);
+  Step poll(uint32_t nowMs);
+  bool busy() const { return _converting; }
+  uint8_t count() const { return _count; }
+  float latest(uint8_t probe = 0) const { return probe < _count ? _lastC[probe] : NAN; }
+  const Stats& stats() const { return _stats; }
+  void printStats() const;
+
 private:
-  float lastC = NAN;
+  OneWire _ow;
+  DallasTemperature _dt;
+  DeviceAddress _addr[MAX_PROBES] = {{0}};
+  uint8_t _count = 0;              // vagas ocupadas (cache + novas)
+  uint8_t _resolution = 12;
+
+  bool _converting = false;
+  bool _ok = false;
+  uint8_t _next = 0;               // próxima sonda da rodada
+  uint32_t _readyAtMs = 0;
+  bool _rescan = false;
+  uint32_t _lastScanMs = 0;
+  float _lastC[MAX_PROBES];
+  Stats _stats;
+
+  void enumerate(uint32_t nowMs);
+  void loadCache();
+  void saveCache();
 };
@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+
+class LiquidCrystal_I2C;
+
+/**
+ * LcdFrame — framebuffer-sombra do LCD 16x2: só manda o que mudou
+ * ---------------------------------------------------------------
+ *  - setLine() só escreve na RAM (completa a linha com espaços); nada vai
+ *    para o barramento
+ *  - flush() compara com o que está na tela e envia só as células
+ *    diferentes, em corridas: um setCursor por corrida; buracos de até
+ *    MERGE_GAP células iguais vão junto (reenviar 1 caractere custa o
+ *    mesmo que um setCursor)
+ *  - Cada byte do LCD, caractere ou comando, vira ~6 transações I2C no PCF8574
+ *    (4 bits x pulso de enable): tela parada = 0 bytes
+ *  - A cada RESYNC_MS reenvia tudo, para corrigir ruído na tela
+ *  - Métricas: bytes do LCD e µs por quadro (último/máximo)
+ */
+class LcdFrame {
+public:
+  static constexpr uint8_t  COLS = 16;
+  static constexpr uint8_t  ROWS = 2;
+  static constexpr uint8_t  MERGE_GAP = 1;
+  static constexpr uint32_t RESYNC_MS = 60000;
+
+  struct Stats {
+    uint32_t frames = 0;
+    uint32_t dirtyFrames = 0;     // quadros que tocaram o barramento
+    uint32_t bytesTotal = 0;
+    uint16_t bytesLast = 0;       // do último quadro com mudança
+    uint16_t bytesMax = 0;
+    uint32_t usLast = 0;
+    uint32_t usMax = 0;
+  };
+
+  void begin(LiquidCrystal_I2C* lcd);
+  void setLine(uint8_t row, const char* text);
+  // tela apagada/reiniciada por fora: próximo flush() reenvia tudo
+  void invalidate();
+  // bytes enviados ao LCD neste quadro
+  uint16_t flush(uint32_t nowMs);
+  const Stats& stats() const { return _stats; }
+  void printStats() const;
+
+private:
+  LiquidCrystal_I2C* _lcd = nullptr;
+  char _want[ROWS][COLS];
+  char _shown[ROWS][COLS];
+  uint32_t _lastResyncMs = 0;
+  Stats _stats;
+};
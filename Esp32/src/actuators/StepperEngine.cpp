@@ -0,0 +1,223 @@
+#include "actuators/StepperEngine.h"
+#include <esp_timer.h>
+
+StepperEngine* StepperEngine::_instance = nullptr;
+
+// bobinas por fase: bit 0 = IN1 … bit 3 = IN4
+static const uint8_t WAVE_SEQ[4] = {0x1, 0x2, 0x4, 0x8};
+static const uint8_t FULL_SEQ[4] = {0x3, 0x6, 0xC, 0x9};
+static const uint8_t HALF_SEQ[8] = {0x1, 0x3, 0x2, 0x6, 0x4, 0xC, 0x8, 0x9};
+
+// ==== timer (API do core Arduino 2.x e 3.x) ====
+bool StepperEngine::begin(uint8_t in1, uint8_t in2, uint8_t in3, uint8_t in4, uint8_t timerNum) {
+    _pins[0] = in1;
+    _pins[1] = in2;
+    _pins[2] = in3;
+    _pins[3] = in4;
+    for (uint8_t p : _pins) {
+        pinMode(p, OUTPUT);
+        _all.add(p);
+    }
+    buildPhases();
+    release();
+
+    _instance = this;
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    (void)timerNum;
+    _timer = timerBegin(1000000);                  // 1 MHz: contagem em µs
+    if (_timer) {
+        timerStop(_timer);
+        timerAttachInterrupt(_timer, &StepperEngine::onTimer);
+    }
+#else
+    _timer = timerBegin(timerNum, 80, true);       // APB 80 MHz / 80 = 1 MHz
+    if (_timer) timerAttachInterrupt(_timer, &StepperEngine::onTimer, true);
+#endif
+    if (!_timer) Serial.println("[STEP] Timer de hardware indisponivel");
+    return _timer != nullptr;
+}
+
+void StepperEngine::arm() {
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    timerWrite(_timer, 0);
+    timerAlarm(_timer, _periodUs, true, 0);
+    timerStart(_timer);
+#else
+    timerWrite(_timer, 0);
+    timerAlarmWrite(_timer, _periodUs, true);
+    timerAlarmEnable(_timer);
+#endif
+}
+
+// período novo vale a partir do próximo alarme (autoreload); chamado da ISR
+void IRAM_ATTR StepperEngine::retime() {
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    timerAlarm(_timer, _periodUs, true, 0);
+#else
+    timerAlarmWrite(_timer, _periodUs, true);
+#endif
+}
+
+void StepperEngine::disarm() {
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    timerStop(_timer);
+#else
+    timerAlarmDisable(_timer);
+#endif
+}
+
+// ==== bobinas ====
+// sequência do modo → máscaras prontas para a ISR (set = bobinas da fase,
+// clear = as outras do motor)
+void StepperEngine::buildPhases() {
+    const uint8_t* seq = HALF_SEQ;
+    _phaseCount = 8;
+    if (_mode == DriveMode::WAVE) { seq = WAVE_SEQ; _phaseCount = 4; }
+    else if (_mode == DriveMode::FULL) { seq = FULL_SEQ; _phaseCount = 4; }
+
+    for (uint8_t i = 0; i < _phaseCount; i++) {
+        FastGpio::Mask on;
+        for (uint8_t c = 0; c < 4; c++)
+            if (seq[i] & (1 << c)) on.add(_pins[c]);
+        _phases[i].set = on;
+        _phases[i].clr = _all & ~on;
+    }
+    _phase = 0;
+}
+
+bool StepperEngine::setMode(DriveMode mode) {
+    if (_running) return false;
+    _mode = mode;
+    buildPhases();
+    return true;
+}
+
+void StepperEngine::release() {
+    FastGpio::apply(FastGpio::Mask(), _all);
+}
+
+// ==== movimento ====
+// rampa linear na frequência: faltando `left` meio-passos de rampa
+uint32_t IRAM_ATTR StepperEngine::rampPeriodUs(uint16_t startHz, uint16_t rateHz, uint16_t left) {
+    const uint32_t hz = rateHz - (uint32_t)(rateHz - startHz) * left / RAMP_STEPS;
+    return 1000000UL / hz;
+}
+
+uint32_t StepperEngine::moveUs(int32_t steps, uint16_t stepsPerSec) {
+    uint32_t n = steps > 0 ? steps : -steps;
+    if (n == 0 || stepsPerSec == 0) return 0;
+    const uint16_t start = stepsPerSec > RAMP_START_HZ ? RAMP_START_HZ : stepsPerSec;
+    uint16_t left = start < stepsPerSec ? RAMP_STEPS : 0;
+    uint32_t us = 0;
+    for (uint32_t i = 0; i < n && left; i++)
+        us += rampPeriodUs(start, stepsPerSec, left--);
+    const uint32_t ramped = (start < stepsPerSec ? RAMP_STEPS : 0) - left;
+    return us + (n - ramped) * (1000000UL / stepsPerSec);
+}
+
+bool StepperEngine::move(int32_t steps, uint16_t stepsPerSec) {
+    if (!_timer || _running || steps == 0) return false;
+    if (stepsPerSec < MIN_RATE_HZ || stepsPerSec > MAX_RATE_HZ) return false;
+
+    _rateHz = stepsPerSec;
+    _startHz = stepsPerSec > RAMP_START_HZ ? RAMP_START_HZ : stepsPerSec;
+    _ramp = _startHz < _rateHz ? RAMP_STEPS : 0;
+    _periodUs = rampPeriodUs(_startHz, _rateHz, _ramp);
+    _dir = steps > 0 ? 1 : -1;
+    _remaining = steps > 0 ? steps : -steps;
+    _lastIsrUs = 0;
+    _moveIsrStartUs = _stats.isrSumUs;
+    _done = false;
+    _running = true;
+    _moveStartMs = millis();
+    _stats.moves++;
+    arm();
+    return true;
+}
+
+void StepperEngine::stop() {
+    if (!_running) return;
+    disarm();
+    _running = false;
+    _done = false;
+    _remaining = 0;
+    release();
+}
+
+StepperEngine::Event StepperEngine::poll() {
+    if (!_running || !_done) return Event::NONE;
+    disarm();
+    _running = false;
+    _stats.lastMoveMs = millis() - _moveStartMs;
+    _stats.lastMoveCpuUs = _stats.isrSumUs - _moveIsrStartUs;
+    return Event::DONE;
+}
+
+// ==== ISR ====
+void IRAM_ATTR StepperEngine::onTimer() {
+    if (_instance) _instance->isrStep();
+}
+
+void IRAM_ATTR StepperEngine::isrStep() {
+    if (_done) return;   // fim já marcado; poll() desarma
+
+    const int64_t now = esp_timer_get_time();
+    if (_lastIsrUs) {
+        const int64_t late = now - _lastIsrUs - (int64_t)_periodUs;
+        const uint32_t j = (uint32_t)(late < 0 ? -late : late);
+        if (j > _stats.jitterMaxUs) _stats.jitterMaxUs = j;
+        _stats.jitterSumUs += j;
+        _stats.jitterSamples++;
+    }
+    _lastIsrUs = now;
+
+    _phase = _dir > 0 ? (_phase + 1 == _phaseCount ? 0 : _phase + 1)
+                      : (_phase == 0 ? _phaseCount - 1 : _phase - 1);
+    const Phase& ph = _phases[_phase];
+    FastGpio::apply(ph.set, ph.clr);
+    _stats.steps++;
+
+    if (--_remaining <= 0) {
+        release();
+        _done = true;
+    } else if (_ramp) {
+        _periodUs = rampPeriodUs(_startHz, _rateHz, --_ramp);
+        retime();
+    }
+
+    const uint32_t cpu = (uint32_t)(esp_timer_get_time() - now);
+    if (cpu > _stats.isrMaxUs) _stats.isrMaxUs = cpu;
+    _stats.isrSumUs += cpu;
+}
+
+void StepperEngine::printStats() const {
+    const Stats s = _stats;
+    Serial.printf("[STEP] movimentos=%lu passos=%lu jitter med=%luus max=%luus ultimo=%lums "
+                  "(CPU %luus, ISR max %luus)\n",
+                  (unsigned long)s.moves, (unsigned long)s.steps,
+                  (unsigned long)(s.jitterSamples ? s.jitterSumUs / s.jitterSamples : 0),
+                  (unsigned long)s.jitterMaxUs, (unsigned long)s.lastMoveMs,
+                  (unsigned long)s.lastMoveCpuUs, (unsigned long)s.isrMaxUs);
+}
+
+// ==== benchmark ====
+bool StepperEngine::benchmark(uint32_t n, Bench& out) {
+    if (_running || n == 0) return false;
+
+    int64_t t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < n; i++)
+        for (uint8_t p : _pins) digitalWrite(p, LOW);
+    const int64_t dw = esp_timer_get_time() - t0;
+
+    t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < n; i++) {
+        FastGpio::apply(FastGpio::Mask(), _all);
+        __asm__ __volatile__("" ::: "memory");   // não deixa o laço ser colapsado
+    }
+    const int64_t reg = esp_timer_get_time() - t0;
+
+    out.n = n;
+    out.digitalWriteNs = (uint32_t)(dw * 1000 / n);
+    out.registerNs = (uint32_t)(reg * 1000 / n);
+    return true;
+}
@@ -1,30 +1,37 @@
 #include <Arduino.h>
 #include <math.h>
+#include <Preferences.h>
+#include <esp_system.h>
 #include "config/Secrets.h"
 #include "app/App.h"
+#include "core/JsonScan.h"
+#include "config/RootCA.h"
+#include "io/TimeSync.h"
 
 App *App::instance = nullptr;
 
-// ===== Flags locais para modos =====
+// ===== Profiler do loop =====
+#if LOOP_PROFILE
+#define PROF_LAP(p, id) (p).lap(id)
+#else
+#define PROF_LAP(p, id) ((void)0)
+#endif
+
+// um profiler por task (lap() não é thread-safe); nomes viram nós do diag
+static const char *const PROF_NET_SECTIONS[] = {
+    "net_tick", "wifi", "fb_loop", "auth", "fb_maint", "eventos", "diag", "flush",
+};
+static const char *const PROF_CTL_SECTIONS[] = {
+    "ctl_tick", "comandos", "boia", "temp", "ph", "medias", "ihm", "feeder",
+};
+
+// ===== Flags locais para modos (só a task de controle) =====
 static bool heaterModeAuto = true;
 static bool waterfallModeAuto = true;
 
 // ===== Pendências de publicação para evitar reentrância no callback =====
-static volatile bool pending_publish_heater = false;
-static volatile bool pending_publish_waterfall = false;
-static volatile bool pending_reset_feednow = false;
-
-// Callback "mudo" apenas para logar resultado das operações de escrita
-static void fbAck(AsyncResult &res)
-{
-    if (res.isError())
-    {
-        Serial.printf("[FB][%s] write ERROR %d: %s\n",
-                      res.uid().c_str(),
-                      res.error().code(),
-                      res.error().message().c_str());
-    }
-}
+// (callback e flush rodam na task de rede)
+static bool pending_reset_feednow = false;
 
 // ================= Firebase callback =================
 void App::processData(AsyncResult &aResult)
@@ -37,170 +44,414 @@ void App::processData(AsyncResult &aResult)
                       code,
                       aResult.error().message().c_str());
 
-        // Se token ficou inválido/expirou → reautentica com pequeno backoff
+        // Update não confirmado → entradas do lote voltam para a fila;
+        // 400/403 = conteúdo recusado (regra, caminhos sobrepostos)
+        if (RtdbScheduler::isBatchUid(aResult.uid().c_str(), "RTDB_Update"))
+            App::instance->sched.onResult(aResult.uid().c_str(), false, code == 400 || code == 403);
+
+        // Token recusado → serviceAuth() renova pelo refresh token (ou, sem
+        // ele, sign-in completo após pequeno backoff)
         if (code == 401)
         {
             App::instance->fb_need_reauth = true;
             App::instance->fb_cooldown_until = millis() + 2000;
             App::instance->fb_last_err = code;
-            Serial.println("[FB] 401 detectado → agendando reauth em 2s");
+            Serial.println("[FB] 401 detectado → renovando token");
+        }
+        return;
+    }
+
+    // ===== Confirmação dos updates =====
+    if (RtdbScheduler::isBatchUid(aResult.uid().c_str(), "RTDB_Update"))
+    {
+        if (aResult.available())
+            App::instance->sched.onResult(aResult.uid().c_str(), true);
+        return;
+    }
+
+    // ===== Stream de /aquario/controle =====
+    if (aResult.uid() == "controle_stream")
+    {
+        RealtimeDatabaseResult &stream = aResult.to<RealtimeDatabaseResult>();
+        if (!stream.isStream())
+            return;
+
+        App *app = App::instance;
+        app->lastStreamEventMs = millis();
+
+        const String event = stream.event();
+        if (event == "put" || event == "patch")
+        {
+            app->dispatchControl(stream.dataPath().c_str(), stream.to<const char *>());
+        }
+        else if (event == "cancel" || event == "auth_revoked")
+        {
+            // token trocado/revogado → reabre o stream no próximo tick
+            Serial.printf("[FB] Stream encerrado (%s), reabrindo\n", event.c_str());
+            app->streamStarted = false;
         }
         return;
     }
+}
 
-    // ===== Listener de MODO do HEATER =====
-    if (aResult.uid() == "heater_mode_listener")
+// ================= Comandos (stream) =================
+// Folhas de /aquario/controle consumidas pelo firmware
+static const char *const CONTROL_LEAVES[] = {
+    "heater/mode",
+    "heater/turn_on_now",
+    "waterfall/mode",
+    "waterfall/turn_on_now",
+    "feeder/feed_now",
+};
+
+// Um evento put/patch chega com o caminho relativo ao stream e um JSON
+// (escalar ou objeto). Para cada folha conhecida que esteja sob esse
+// caminho, extrai o valor e aplica.
+void App::dispatchControl(const char *dataPath, const char *data)
+{
+    if (!data)
+        return;
+    while (*dataPath == '/')
+        dataPath++;
+    const size_t baseLen = strlen(dataPath);
+
+    char value[24];
+    for (const char *leaf : CONTROL_LEAVES)
+    {
+        if (baseLen == 0)
+        {
+            if (JsonScan::find(data, leaf, value, sizeof(value)))
+                applyControl(leaf, value);
+        }
+        else if (strcmp(leaf, dataPath) == 0)
+        {
+            JsonScan::unquote(data, value, sizeof(value));
+            applyControl(leaf, value);
+        }
+        else if (strncmp(leaf, dataPath, baseLen) == 0 && leaf[baseLen] == '/')
+        {
+            if (JsonScan::find(data, leaf + baseLen + 1, value, sizeof(value)))
+                applyControl(leaf, value);
+        }
+    }
+}
+
+void App::applyControl(const char *leaf, const char *value)
+{
+    if (strcmp(value, "null") == 0)
+        return;
+
+    // Só traduz: quem mexe em relé/alimentador é a task de controle
+    const bool on = (strcmp(value, "true") == 0);
+    ControlCmd cmd;
+    if (strcmp(leaf, "heater/mode") == 0)
+        cmd = {ControlCmd::Kind::HEATER_MODE, strcmp(value, "manual") != 0};
+    else if (strcmp(leaf, "heater/turn_on_now") == 0)
+        cmd = {ControlCmd::Kind::HEATER_ON_NOW, on};
+    else if (strcmp(leaf, "waterfall/mode") == 0)
+        cmd = {ControlCmd::Kind::WATERFALL_MODE, strcmp(value, "manual") != 0};
+    else if (strcmp(leaf, "waterfall/turn_on_now") == 0)
+        cmd = {ControlCmd::Kind::WATERFALL_ON_NOW, on};
+    else if (strcmp(leaf, "feeder/feed_now") == 0)
+    {
+        if (!on)
+            return;
+        pending_reset_feednow = true;
+        cmd = {ControlCmd::Kind::FEED_NOW, 1};
+    }
+    else
+        return;
+
+    if (!cmdQueue.push(cmd))
+    {
+        cmdDrops++;
+        Serial.printf("[CMD] Fila cheia, %s=%s descartado\n", leaf, value);
+    }
+}
+
+// ================= Comandos (task de controle) =================
+void App::applyCommand(const ControlCmd &cmd)
+{
+    switch (cmd.kind)
+    {
+    // ===== MODO do HEATER =====
+    case ControlCmd::Kind::HEATER_MODE:
     {
-        RealtimeDatabaseResult &val = aResult.to<RealtimeDatabaseResult>();
-        String mode = val.to<String>();
         bool wasAuto = heaterModeAuto;
-        heaterModeAuto = (mode != "manual");
+        heaterModeAuto = cmd.arg;
 
         if (wasAuto != heaterModeAuto)
         {
             Serial.printf("[FB] Heater modo alterado: %s\n", heaterModeAuto ? "AUTO" : "MANUAL");
         }
-        return;
+        break;
     }
 
-    // ===== Listener de turn_on_now do HEATER =====
-    if (aResult.uid() == "heater_cmd_listener")
+    // ===== turn_on_now do HEATER =====
+    case ControlCmd::Kind::HEATER_ON_NOW:
     {
-        RealtimeDatabaseResult &val = aResult.to<RealtimeDatabaseResult>();
-        bool cmd = val.to<bool>();
+        bool on = cmd.arg;
 
         static bool lastHeaterCmd = false;
 
         if (!heaterModeAuto)
         {
-            if (cmd != lastHeaterCmd)
+            if (on != lastHeaterCmd)
             {
-                App *app = App::instance;
-
-                if (cmd)
-                {
-                    app->relayOn(PIN_RELAY_HEATER);
-                    app->heaterOn = true;
-                    pending_publish_heater = true;
-                    Serial.println("[CMD] Heater: LIGADO (manual via Firebase)");
-                }
-                else
-                {
-                    app->relayOff(PIN_RELAY_HEATER);
-                    app->heaterOn = false;
-                    pending_publish_heater = true;
-                    Serial.println("[CMD] Heater: DESLIGADO (manual via Firebase)");
-                }
+                heater.set(on);
+                Serial.println(on ? "[CMD] Heater: LIGADO (manual via Firebase)"
+                                  : "[CMD] Heater: DESLIGADO (manual via Firebase)");
             }
         }
 
-        lastHeaterCmd = cmd;
-        return;
+        lastHeaterCmd = on;
+        break;
     }
 
-    // ===== Listener de MODO da WATERFALL =====
-    if (aResult.uid() == "waterfall_mode_listener")
+    // ===== MODO da WATERFALL =====
+    case ControlCmd::Kind::WATERFALL_MODE:
     {
-        RealtimeDatabaseResult &val = aResult.to<RealtimeDatabaseResult>();
-        String mode = val.to<String>();
         bool wasAuto = waterfallModeAuto;
-        waterfallModeAuto = (mode != "manual");
+        waterfallModeAuto = cmd.arg;
 
         if (wasAuto != waterfallModeAuto)
         {
             Serial.printf("[FB] Waterfall modo alterado: %s\n", waterfallModeAuto ? "AUTO" : "MANUAL");
         }
-        return;
+        break;
     }
 
-    // ===== Listener de turn_on_now da WATERFALL =====
-    if (aResult.uid() == "waterfall_cmd_listener")
+    // ===== turn_on_now da WATERFALL =====
+    case ControlCmd::Kind::WATERFALL_ON_NOW:
     {
-        RealtimeDatabaseResult &val = aResult.to<RealtimeDatabaseResult>();
-        bool cmd = val.to<bool>();
+        bool on = cmd.arg;
 
         static bool lastWfCmd = false;
 
         if (!waterfallModeAuto)
         {
-            if (cmd != lastWfCmd)
+            if (on != lastWfCmd)
             {
-                App *app = App::instance;
-
-                if (cmd)
+                if (on)
                 {
-                    app->setWaterfall(true);
+                    setWaterfall(true);
                     Serial.println("[CMD] Waterfall: LIGADA (manual via Firebase)");
                 }
                 else
                 {
-                    app->setWaterfall(false);
+                    setWaterfall(false);
                     Serial.println("[CMD] Waterfall: DESLIGADA (manual via Firebase)");
                 }
             }
         }
 
-        lastWfCmd = cmd;
-        return;
+        lastWfCmd = on;
+        break;
     }
 
-    // ===== Listener de feed_now do FEEDER =====
-    if (aResult.uid() == "feeder_cmd_listener")
+    // ===== benchmark do alimentador (só parado) =====
+    case ControlCmd::Kind::BENCH_STEPPER:
     {
-        RealtimeDatabaseResult &val = aResult.to<RealtimeDatabaseResult>();
-        bool want = val.to<bool>();
-        if (want)
+        StepperEngine::Bench b;
+        if (!feeder.benchmark(20000, b))
         {
-            App *app = App::instance;
-            bool ok = app->feederRequest(1);
-
-            pending_reset_feednow = true;
+            Serial.println("[STEP] Benchmark: alimentador em movimento");
+            break;
+        }
+        Serial.printf("[STEP] Fase: digitalWrite x4 %luns | registrador %luns (%lu amostras)\n",
+                      (unsigned long)b.digitalWriteNs, (unsigned long)b.registerNs, (unsigned long)b.n);
+        Serial.printf("[STEP] Porcao (%d passos): %luus -> %luus de CPU\n", FEED_STEPS_PER_PORTION,
+                      (unsigned long)((uint64_t)b.digitalWriteNs * FEED_STEPS_PER_PORTION / 1000),
+                      (unsigned long)((uint64_t)b.registerNs * FEED_STEPS_PER_PORTION / 1000));
+        feeder.printStats();
+        break;
+    }
 
-            if (ok)
-            {
-                Serial.println("[FEEDER] feed_now acionado via Firebase");
-            }
-            else
-            {
-                Serial.println("[FEEDER] feed_now solicitado, mas ocupado ou nivel baixo");
-            }
+    // ===== feed_now do FEEDER =====
+    case ControlCmd::Kind::FEED_NOW:
+        if (feederRequest(cmd.arg))
+        {
+            Serial.println("[FEEDER] feed_now acionado via Firebase");
         }
-        return;
+        else
+        {
+            Serial.println("[FEEDER] feed_now solicitado, mas ocupado ou nivel baixo");
+        }
+        break;
     }
 }
 
-// ================= Wi-Fi / NTP / OTA =================
-void App::connectWiFi()
+// Controle → rede: nunca bloqueia; fila cheia conta descarte
+bool App::pushEvent(ControlEvent::Kind kind, float value, uint64_t monoMs)
 {
-    WiFi.mode(WIFI_MODE_STA);
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-    Serial.print("Conectando Wi-Fi");
-    while (WiFi.status() != WL_CONNECTED)
+    if (eventQueue.push({kind, value, monoMs}))
+        return true;
+    eventDrops.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void App::pushWindow(Stamped kind, uint8_t probe, uint64_t monoMs, const WindowStats::Summary &st)
+{
+    if (!windowQueue.push({kind, probe, monoMs, st}))
+        eventDrops.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Estados discretos vão só quando mudam; falhou o push → tenta no próximo tick
+void App::reportState(uint64_t monoMs)
+{
+    static constexpr ControlEvent::Kind KINDS[] = {
+        ControlEvent::Kind::HEATER,
+        ControlEvent::Kind::WATERFALL,
+        ControlEvent::Kind::WATER_OK,
+        ControlEvent::Kind::FEEDER_BUSY,
+    };
+    const bool cur[] = {heater.isOn(), waterfallOn, waterOk, feederBusy};
+    for (uint8_t i = 0; i < 4; i++)
     {
-        delay(250);
-        Serial.print(".");
+        if (reported[i] != (int8_t)cur[i] && pushEvent(KINDS[i], cur[i] ? 1.0f : 0.0f, monoMs))
+            reported[i] = (int8_t)cur[i];
     }
-    Serial.printf("\nWi-Fi OK. IP: %s\n", WiFi.localIP().toString().c_str());
+}
+
+// ================= Wi-Fi / NTP / OTA =================
+// Os dois clientes verificam o servidor pelo bundle de CAs e reaproveitam
+// a sessão TLS (cache em RTC) a cada reconexão/reauth
+void App::setupTls()
+{
+#if TLS_VERIFY_CA
+    sslClient.setCACert(FIREBASE_ROOT_CA);
+    streamSsl.setCACert(FIREBASE_ROOT_CA);
+#else
     sslClient.setInsecure();
+    streamSsl.setInsecure();
+#endif
+    sslClient.setHandshakeTimeout(TLS_HANDSHAKE_TIMEOUT_MS);
+    streamSsl.setHandshakeTimeout(TLS_HANDSHAKE_TIMEOUT_MS);
+#if TLS_VERIFY_CA
+    refresher.setCACert(FIREBASE_ROOT_CA);
+#endif
 }
 
-void App::syncTime()
+// ================= Autenticação =================
+// Sign-in completo (e-mail/senha): primeiro boot ou sem token utilizável
+void App::signIn(const char *uid)
 {
-    const long GMT_OFFSET_SEC = -3 * 3600; // America/Sao_Paulo
-    const int DST_OFFSET_SEC = 0;
-    configTime(GMT_OFFSET_SEC, DST_OFFSET_SEC, "pool.ntp.org", "time.nist.gov");
+    UserAuth *old = pAuth;
+    pAuth = new UserAuth(WEB_API_KEY, USER_EMAIL, USER_PASS, AUTH_TOKEN_TTL_S);
+    initializeApp(aClient, app, getAuth(*pAuth), App::processData, uid);
+    app.getApp<RealtimeDatabase>(Database);
+    Database.url(DATABASE_URL);
+    delete old;
 
-    time_t now = time(nullptr);
-    Serial.print("Sincronizando NTP");
-    int tries = 0;
-    while (now < 1700000000 && tries < 60)
+    authFromSignIn = true;
+    authCaptured = false;
+    authSignInAt = millis();
+}
+
+// Entrega ao FirebaseApp um ID token já obtido (NVS ou refresh): sem ida ao
+// Identity Toolkit, e as escritas na fila do scheduler continuam lá
+void App::applyToken(uint32_t nowEpoch)
+{
+    const uint32_t ttl = authToken.expiresAt > nowEpoch ? authToken.expiresAt - nowEpoch : 0;
+    IDToken *old = pIdToken;
+    pIdToken = new IDToken(WEB_API_KEY, authToken.id, ttl, authToken.refresh);
+    initializeApp(aClient, app, getAuth(*pIdToken), App::processData, "tokenTask");
+    app.getApp<RealtimeDatabase>(Database);
+    Database.url(DATABASE_URL);
+    delete old;
+
+    authFromSignIn = false;
+    streamStarted = false; // stream reabre com o token novo
+}
+
+// Primeira subida do Firebase (Wi-Fi + relógio prontos)
+void App::startFirebase()
+{
+    // Token salvo ainda válido → dispensa o sign-in
+    const uint32_t nowEpoch = (uint32_t)(Clock::epochMillis() / 1000);
+    if (authStore.load(authToken, USER_EMAIL) && authToken.validFor(nowEpoch, AUTH_REFRESH_AHEAD_S))
     {
-        delay(250);
-        Serial.print(".");
-        now = time(nullptr);
-        tries++;
+        Serial.println("[Auth] Token da NVS ainda válido, sem sign-in");
+        applyToken(nowEpoch);
     }
-    Serial.println();
+    else
+    {
+        authToken.clear();
+        signIn("authTask");
+    }
+    fbStarted = true;
+}
+
+// Renova o ID token AUTH_REFRESH_AHEAD_S antes de expirar (ou logo após um
+// 401) pelo refresh token, sem derrubar o app. Sign-in completo só depois
+// de AUTH_MAX_REFRESH_FAILS falhas seguidas.
+void App::serviceAuth(uint32_t now)
+{
+    const uint32_t nowEpoch = (uint32_t)(Clock::epochMillis() / 1000);
+
+    if (refresher.busy())
+    {
+        TokenRefresher::State st = refresher.poll(authToken, nowEpoch);
+        if (st == TokenRefresher::State::DONE)
+        {
+            Serial.printf("[Auth] Token renovado (vale %lus)\n", (unsigned long)(authToken.expiresAt - nowEpoch));
+            authStore.save(authToken, USER_EMAIL);
+            applyToken(nowEpoch);
+            authFailures = 0;
+            fb_need_reauth = false;
+        }
+        else if (st == TokenRefresher::State::FAILED)
+        {
+            authFailures++;
+            uint32_t backoff = 5000UL << (authFailures < 5 ? authFailures : 5);
+            authRetryAt = now + (backoff < 120000 ? backoff : 120000);
+            Serial.printf("[Auth] Falha ao renovar token (%u)\n", authFailures);
+            if (authFailures >= AUTH_MAX_REFRESH_FAILS)
+            {
+                // refresh token revogado/inválido → sign-in completo
+                authStore.clear();
+                authToken.clear();
+                authFailures = 0;
+                fb_need_reauth = true;
+                fb_cooldown_until = now;
+            }
+        }
+        return;
+    }
+
+    if (!wifi.connected() || !Clock::synced())
+        return;
+
+    // Token obtido por sign-in → NVS (o próximo boot pula o sign-in)
+    if (authFromSignIn && !authCaptured && app.ready())
+    {
+        authCaptured = true;
+        const String id = app.getToken();
+        const String refresh = app.getRefreshToken();
+        if (refresh.length() && id.length() < sizeof(authToken.id) && refresh.length() < sizeof(authToken.refresh))
+        {
+            strcpy(authToken.id, id.c_str());
+            strcpy(authToken.refresh, refresh.c_str());
+            authToken.expiresAt = nowEpoch + AUTH_TOKEN_TTL_S - (now - authSignInAt) / 1000;
+            authStore.save(authToken, USER_EMAIL);
+        }
+    }
+
+    const bool due = authToken.hasRefresh() &&
+                     (fb_need_reauth || authToken.expiresAt <= nowEpoch + AUTH_REFRESH_AHEAD_S);
+    if (due && (int32_t)(now - authRetryAt) >= 0)
+    {
+        Serial.println(fb_need_reauth ? "[Auth] 401 → renovando token" : "[Auth] Renovando token antes de expirar");
+        refresher.start(WEB_API_KEY, authToken.refresh);
+    }
+}
+
+void App::syncTime()
+{
+    const long GMT_OFFSET_SEC = -3 * 3600; // America/Sao_Paulo (sem horário de verão)
+    // SNTP roda em segundo plano e sincroniza assim que houver rede (e de
+    // hora em hora); startFirebase() espera o relógio (validade dos certificados)
+    TimeSync::begin(GMT_OFFSET_SEC, "pool.ntp.org", "time.nist.gov");
 }
 
 void App::setupOTA()
@@ -208,13 +459,13 @@ void App::setupOTA()
     ArduinoOTA.setHostname(HOSTNAME_DEFAULT);
     ArduinoOTA.setPort(OTA_PORT_DEFAULT);
     ArduinoOTA.onStart([]()
-                       { Serial.println("\nOTA: start"); });
+                       { App::instance->otaActive = true; Serial.println("\nOTA: start"); });
     ArduinoOTA.onEnd([]()
-                     { Serial.println("\nOTA: end"); });
+                     { App::instance->otaActive = false; Serial.println("\nOTA: end"); });
     ArduinoOTA.onProgress([](unsigned int progress, unsigned int total)
                           { Serial.printf("OTA: %u%%\r", (progress * 100U) / total); });
     ArduinoOTA.onError([](ota_error_t error)
-                       { Serial.printf("OTA: erro %u\n", error); });
+                       { App::instance->otaActive = false; Serial.printf("OTA: erro %u\n", error); });
 
     ArduinoOTA.begin();
     Serial.printf("OTA pronto. Host: %s:%d\n", HOSTNAME_DEFAULT, OTA_PORT_DEFAULT);
@@ -233,14 +484,6 @@ void App::setupOTA()
 }
 
 // ================= Helpers =================
-uint64_t App::epoch_ms()
-{
-    time_t s = time(nullptr);
-    if (s > 100000)
-        return (uint64_t)s * 1000ULL;
-    return (uint64_t)millis();
-}
-
 void App::buzzerPatternWaterLow()
 {
 #if BUZZER_ENABLE
@@ -309,13 +552,12 @@ void App::buzzerPatternWaterLow()
 
 void App::setWaterfall(bool on)
 {
-    if (RELAY_ACTIVE_LOW)
-        digitalWrite(PIN_RELAY_WATERFALL, on ? LOW : HIGH);
+    if (on)
+        relayOn(PIN_RELAY_WATERFALL);
     else
-        digitalWrite(PIN_RELAY_WATERFALL, on ? HIGH : LOW);
+        relayOff(PIN_RELAY_WATERFALL);
 
     waterfallOn = on;
-    pending_publish_waterfall = true;
 }
 
 // ================= LCD =================
@@ -334,33 +576,37 @@ uint8_t App::scanI2C()
     return found;
 }
 
+bool App::probeI2C(uint8_t addr)
+{
+    Wire.beginTransmission(addr);
+    return Wire.endTransmission() == 0;
+}
+
+// Endereço do PCF8574 fica na NVS: no boot normal é um único probe em vez
+// da varredura de 126 endereços; sem splash (o primeiro quadro já é o resumo)
 void App::initLCD()
 {
     Wire.begin(I2C_SDA, I2C_SCL);
-    delay(10);
-    uint8_t found = scanI2C();
-    if (found != 0)
-        lcdAddr = found;
+    Wire.setClock(LCD_I2C_HZ);
+    const uint8_t cached = loadBootByte("lcd");
+    bool fromCache = cached != 0 && probeI2C(cached);
+    if (fromCache)
+        lcdAddr = cached;
+    else
+    {
+        uint8_t found = scanI2C();
+        if (found != 0)
+        {
+            lcdAddr = found;
+            saveBootByte("lcd", found);
+        }
+    }
+    Serial.printf("[LCD] I2C @0x%02X (%s)\n", lcdAddr, fromCache ? "cache" : "varredura");
     lcd = LiquidCrystal_I2C(lcdAddr, 16, 2);
     lcd.init();
     lcd.backlight();
-
     lcd.clear();
-    lcd.setCursor(0, 0);
-    lcd.print("LCD I2C @0x");
-    char buf[5];
-    sprintf(buf, "%02X", lcdAddr);
-    lcd.print(buf);
-    lcd.setCursor(0, 1);
-    lcd.print("Inicializando...");
-    delay(500);
-    lcd.clear();
-}
-
-void App::lcdClearLine(uint8_t row)
-{
-    lcd.setCursor(0, row);
-    lcd.print("                ");
+    lcdFrame.begin(&lcd);
 }
 
 void App::drawResumo()
@@ -375,14 +621,10 @@ void App::drawResumo()
     else
         snprintf(l1, sizeof(l1), "T:--.-C pH:--.--");
 
-    snprintf(l2, sizeof(l2), "HTR:%s", heaterOn ? "ON " : "OFF");
+    snprintf(l2, sizeof(l2), "HTR:%s", heater.isOn() ? "ON " : "OFF");
 
-    lcdClearLine(0);
-    lcdClearLine(1);
-    lcd.setCursor(0, 0);
-    lcd.print(l1);
-    lcd.setCursor(0, 1);
-    lcd.print(l2);
+    lcdFrame.setLine(0, l1);
+    lcdFrame.setLine(1, l2);
 }
 
 void App::drawDetalhe()
@@ -391,14 +633,11 @@ void App::drawDetalhe()
     snprintf(l1, sizeof(l1), "CASC:%s", waterfallOn ? "ON " : "OFF");
     snprintf(l2, sizeof(l2), "NIV:%s", waterOk ? "OK " : "BAIX");
 
-    lcdClearLine(0);
-    lcdClearLine(1);
-    lcd.setCursor(0, 0);
-    lcd.print(l1);
-    lcd.setCursor(0, 1);
-    lcd.print(l2);
+    lcdFrame.setLine(0, l1);
+    lcdFrame.setLine(1, l2);
 }
 
+// Monta o quadro na RAM; só as células que mudaram vão para o I2C
 void App::updateLCD()
 {
     switch (currentScreen)
@@ -410,6 +649,7 @@ void App::updateLCD()
         drawDetalhe();
         break;
     }
+    lcdFrame.flush(millis());
 }
 
 void App::handleButton()
@@ -439,402 +679,709 @@ void App::handleButton()
 }
 
 // ================= Feeder =================
-void App::feederApplyStep(uint8_t idx)
+// Passos saem do timer (StepperEngine); aqui só o evento de fim
+void App::feederRun()
+{
+    if (feeder.poll() != StepperEngine::Event::DONE)
+        return;
+
+    feederBusy = false;
+    const uint64_t mono = Clock::monoMillis();
+    feedSchedule.done(mono);
+    pushEvent(ControlEvent::Kind::FEED_DONE, 0, mono);
+    Serial.printf("[FEEDER] Concluido em %lums\n", (unsigned long)feeder.stats().lastMoveMs);
+}
+
+bool App::feederRequest(uint8_t portions)
 {
-    switch (idx & 0x07)
+    if (portions == 0 || portions > MAX_PORTIONS_PER_EVENT)
+        return false;
+    if (feederBusy)
+        return false;
+    if (!waterOk)
+        return false;
+    long steps = (long)FEED_STEPS_PER_PORTION * (long)portions;
+    if (!feeder.move(steps, FEED_STEP_RATE_HZ))
+        return false;
+    feederBusy = true;
+    feedSchedule.started(); // qualquer alimentação encerra o episódio de bloqueio
+    Serial.printf("[FEEDER] Iniciando: %u porcao(oes), %ld passos a %u/s\n", portions, steps, (unsigned)FEED_STEP_RATE_HZ);
+    return true;
+}
+
+// ================= Firebase publishers/logs =================
+// Estados passam pelo espelho: só entram no lote se mudaram
+void App::publicarHeater(bool on)
+{
+    shadow.publishBool(sched, SH_HEATER, on, millis());
+}
+
+void App::publicarWaterOk(bool ok)
+{
+    shadow.publishBool(sched, SH_WATER_OK, ok, millis());
+}
+
+void App::publicarWaterfall(bool on)
+{
+    shadow.publishBool(sched, SH_WATERFALL, on, millis());
+}
+
+// Chamado a cada tick da rede com a cópia dos estados que a task de
+// controle reportou (o espelho descarta o que não mudou)
+void App::publishState(uint32_t now)
+{
+    publicarHeater(netState.heater);
+    publicarWaterfall(netState.waterfall);
+    publicarWaterOk(netState.waterOk);
+    shadow.publishBool(sched, SH_FEEDER_BUSY, netState.feederBusy, now);
+    shadow.refresh(sched, now);
+}
+
+// Eventos da task de controle → espelho/séries/logs (tudo na task de rede)
+void App::drainEvents(uint32_t now)
+{
+    ControlEvent ev;
+    while (eventQueue.pop(ev))
     {
-    case 0:
-        digitalWrite(FEED_IN1, 1);
-        digitalWrite(FEED_IN2, 0);
-        digitalWrite(FEED_IN3, 0);
-        digitalWrite(FEED_IN4, 0);
-        break;
-    case 1:
-        digitalWrite(FEED_IN1, 1);
-        digitalWrite(FEED_IN2, 1);
-        digitalWrite(FEED_IN3, 0);
-        digitalWrite(FEED_IN4, 0);
-        break;
-    case 2:
-        digitalWrite(FEED_IN1, 0);
-        digitalWrite(FEED_IN2, 1);
-        digitalWrite(FEED_IN3, 0);
-        digitalWrite(FEED_IN4, 0);
-        break;
-    case 3:
-        digitalWrite(FEED_IN1, 0);
-        digitalWrite(FEED_IN2, 1);
-        digitalWrite(FEED_IN3, 1);
-        digitalWrite(FEED_IN4, 0);
-        break;
-    case 4:
-        digitalWrite(FEED_IN1, 0);
-        digitalWrite(FEED_IN2, 0);
-        digitalWrite(FEED_IN3, 1);
-        digitalWrite(FEED_IN4, 0);
+        switch (ev.kind)
+        {
+        case ControlEvent::Kind::HEATER:
+            netState.heater = ev.value != 0;
+            break;
+        case ControlEvent::Kind::WATERFALL:
+            netState.waterfall = ev.value != 0;
+            break;
+        case ControlEvent::Kind::WATER_OK:
+            netState.waterOk = ev.value != 0;
+            break;
+        case ControlEvent::Kind::FEEDER_BUSY:
+            netState.feederBusy = ev.value != 0;
+            break;
+        case ControlEvent::Kind::TEMP_NOW: // só a sonda 0 (tanque)
+            shadow.publishFloat(sched, SH_TEMP_CURRENT, ev.value, now);
+            break;
+        case ControlEvent::Kind::PH_NOW:
+            shadow.publishFloat(sched, SH_PH_CURRENT, ev.value, now);
+            break;
+        case ControlEvent::Kind::FEED_DONE:
+            stampSample(Stamped::FEED_DONE, ev.value, ev.monoMs);
+            break;
+        case ControlEvent::Kind::FEED_LOG:
+            stampSample(Stamped::FEED_LOG, ev.value, ev.monoMs);
+            break;
+        case ControlEvent::Kind::FEED_BLOCKED:
+            Serial.println("[FEEDER] BLOQUEADO: nivel baixo de agua (aguardando o nivel voltar)");
+            break;
+        }
+    }
+
+    WindowReport w;
+    while (windowQueue.pop(w))
+    {
+        stampSample(w.kind, w.stats.mean, w.monoMs, w.probe);
+        publishWindow(w);
+    }
+}
+
+void App::logHeaterDecision(float tC, bool newState, float onThr, float offThr, const char *reason)
+{
+    Serial.printf("[CTRL] Aquecedor: %s | t=%.2f°C | Liga<%.2f  Desliga>%.2f | %s\n",
+                  newState ? "ON " : "OFF", tC, onThr, offThr, reason);
+}
+
+void App::publicarLastSeen()
+{
+    const uint64_t ts = Clock::epochMillis();
+    if (!fbReady() || !ts)
+        return;
+    sched.setU64(RtdbPaths::LAST_SEEN, ts, Prio::TELEMETRY);
+}
+
+// Série compactada: as médias de 5 min de uma hora vão num único nó
+// /aquario/series/<nome>/<t0>, reescrito a cada amostra (vai junto do lote
+// do tick). Chunk cheio, virada de hora ou relógio voltando → chunk novo.
+// Offline o chunk só cresce na RAM: volta ao vivo na próxima amostra com a
+// rede de pé, ou vai para o backlog uma única vez, completo, quando fecha.
+// Assim o backlog guarda um registro por chunk, e o dreno (LOGS) nunca
+// regrava um chunk que o caminho ao vivo ainda vai reescrever.
+void App::appendSeries(Series &s, const char *name, uint64_t ts, float v)
+{
+    const uint64_t HOUR_MS = 3600000ULL;
+    const bool live = fbReady() && !fb_need_reauth;
+    bool sameHour = !s.enc.empty() && (ts / HOUR_MS) == (s.enc.startMs() / HOUR_MS);
+    if (!sameHour || !s.enc.append(ts, v))
+    {
+        if (s.unsent)
+            writeChunk(s.enc, name, live);
+        s.enc.begin(ts, v, 2);
+    }
+
+    s.unsent = !live;
+    if (live)
+        writeChunk(s.enc, name, true);
+}
+
+void App::writeChunk(const SeriesCodec::Encoder &enc, const char *name, bool live)
+{
+    PathBuf<RtdbScheduler::PATH_LEN> path(RtdbPaths::SERIES);
+    path.add(name).add('/').addU64(enc.startMs());
+    char chunk[RtdbScheduler::VALUE_LEN];
+    chunk[0] = '"';
+    size_t n = enc.toBase64(chunk + 1, sizeof(chunk) - 2);
+    chunk[n + 1] = '"';
+    chunk[n + 2] = '\0';
+
+    if (live)
+        sched.setRaw(path.c_str(), chunk, Prio::TELEMETRY);
+    else if (backlog.push(path.c_str(), chunk))
+        Serial.printf("[Backlog] Offline: %s guardado (%lu na fila)\n", path.c_str(), (unsigned long)backlog.pending());
+}
+
+// Tudo que leva timestamp passa por aqui, com o instante monotônico da
+// medição: com relógio sincronizado sai já datado; antes do NTP fica guardado
+void App::stampSample(Stamped kind, float v, uint64_t monoMs, uint8_t probe)
+{
+    const uint64_t ts = Clock::toEpoch(monoMs);
+    if (ts)
+    {
+        emitSample(kind, ts, v, probe);
+        return;
+    }
+    if (preSyncCount == PRESYNC_MAX)
+    {
+        memmove(preSync, preSync + 1, sizeof(preSync[0]) * (PRESYNC_MAX - 1));
+        preSyncCount--;
+    }
+    preSync[preSyncCount++] = {monoMs, v, kind, probe};
+}
+
+void App::emitSample(Stamped kind, uint64_t ts, float v, uint8_t probe)
+{
+    switch (kind)
+    {
+    case Stamped::TEMP_AVG:
+    {
+        char name[16];
+        seriesName(kind, probe, name, sizeof(name));
+        appendSeries(tempSeries[probe], name, ts, v);
         break;
-    case 5:
-        digitalWrite(FEED_IN1, 0);
-        digitalWrite(FEED_IN2, 0);
-        digitalWrite(FEED_IN3, 1);
-        digitalWrite(FEED_IN4, 1);
+    }
+    case Stamped::PH_AVG:
+        appendSeries(phSeries, "ph", ts, v);
         break;
-    case 6:
-        digitalWrite(FEED_IN1, 0);
-        digitalWrite(FEED_IN2, 0);
-        digitalWrite(FEED_IN3, 0);
-        digitalWrite(FEED_IN4, 1);
+    case Stamped::FEED_DONE:
+        lastFeedTs = ts;
+        if (fbReady())
+            sched.setU64(RtdbPaths::FEEDER_LAST_TS, ts, Prio::CONTROL);
+        else
+            backlog.pushU64(RtdbPaths::FEEDER_LAST_TS, ts);
         break;
-    case 7:
-        digitalWrite(FEED_IN1, 1);
-        digitalWrite(FEED_IN2, 0);
-        digitalWrite(FEED_IN3, 0);
-        digitalWrite(FEED_IN4, 1);
+    case Stamped::FEED_LOG:
+        if (fbReady())
+            sched.setU64(RtdbPaths::FEEDER_LOG_LAST_TS, ts, Prio::LOGS);
+        else
+            backlog.pushU64(RtdbPaths::FEEDER_LOG_LAST_TS, ts);
         break;
     }
 }
 
-void App::feederReleaseCoils()
+// sonda 0 mantém o nome antigo; as demais viram temperatura_<i>
+void App::seriesName(Stamped kind, uint8_t probe, char *out, size_t len)
 {
-    digitalWrite(FEED_IN1, 0);
-    digitalWrite(FEED_IN2, 0);
-    digitalWrite(FEED_IN3, 0);
-    digitalWrite(FEED_IN4, 0);
+    if (kind == Stamped::PH_AVG)
+        snprintf(out, len, "ph");
+    else if (probe == 0)
+        snprintf(out, len, "temperatura");
+    else
+        snprintf(out, len, "temperatura_%u", probe);
 }
 
-void App::feederBeginMove(long stepsCW)
+// Resumo da janela: antes do NTP só a média sobrevive (preSync)
+void App::publishWindow(const WindowReport &w)
 {
-    feederTargetSteps = stepsCW;
-    feederRemainingSteps = stepsCW;
-    feederStepIndex = 0;
-    feederBusy = true;
-    tLastStep = 0;
+    const uint64_t ts = Clock::toEpoch(w.monoMs);
+    char json[RtdbScheduler::VALUE_LEN];
+    if (!ts || !WindowStats::toJson(w.stats, json, sizeof(json)))
+        return;
+
+    char name[16];
+    seriesName(w.kind, w.probe, name, sizeof(name));
+    PathBuf<RtdbScheduler::PATH_LEN> path(RtdbPaths::STATS);
+    path.add(name).add('/').addU64(ts);
 
-    if (fbReady())
-        Database.set<bool>(aClient, "/aquario/status/feeder/busy", true, processData, "RTDB_Status_feeder_busy");
+    if (fbReady() && !fb_need_reauth)
+        sched.setRaw(path.c_str(), json, Prio::TELEMETRY);
+    else
+        backlog.push(path.c_str(), json);
 }
 
-void App::feederRun()
+// Primeira sincronização: re-data o que foi medido antes dela, em ordem
+void App::flushPreSync()
 {
-    if (!feederBusy)
+    Serial.printf("[NTP] Relógio sincronizado, re-datando %u amostra(s)\n", preSyncCount);
+    for (uint8_t i = 0; i < preSyncCount; i++)
+        emitSample(preSync[i].kind, Clock::toEpoch(preSync[i].monoMs), preSync[i].value, preSync[i].probe);
+    preSyncCount = 0;
+}
+
+// Envia um update multi-caminho por tick, mais prioritário primeiro
+void App::flushWrites()
+{
+    const uint32_t now = millis();
+    sched.checkTimeout(now);
+    backlog.checkTimeout(now);
+
+    // Fila offline: só avança quando tudo o que foi drenado foi entregue
+    // (classe LOGS zerada) sem descarte no meio do caminho
+    if (backlog.inFlight())
+    {
+        if (sched.stats(Prio::LOGS).dropped != backlogDropMark)
+            backlog.rollback();
+        else if (sched.depth(Prio::LOGS) == 0)
+            backlog.commit();
+    }
+
+    if (!fbReady() || fb_need_reauth)
         return;
-    const unsigned long now = millis();
-    if (now - tLastStep < FEED_STEP_INTERVAL_MS)
+    // fora da janela: tudo espera na fila (mesmo caminho = último valor)
+    if (!radio.open())
         return;
 
-    feederApplyStep(feederStepIndex++);
-    feederRemainingSteps--;
-    tLastStep = now;
+    if (backlog.pending() && !backlog.inFlight())
+    {
+        uint8_t room = sched.room(Prio::LOGS);
+        backlogDropMark = sched.stats(Prio::LOGS).dropped;
+        backlog.drainInto(sched, Prio::LOGS, room < BACKLOG_DRAIN_MAX ? room : BACKLOG_DRAIN_MAX, now);
+    }
 
-    if (feederRemainingSteps <= 0)
+    sched.flush(Database, aClient, processData, "RTDB_Update", now);
+
+#if LOG_HEARTBEAT
+    static uint32_t lastStats = 0;
+    if (now - lastStats >= 600000)
     {
-        feederBusy = false;
-        feederReleaseCoils();
-        lastFeedTs = epoch_ms();
+        lastStats = now;
+        sched.printStats();
+        TlsSessionClient::printStats();
+        wifi.printStats();
+        radio.printStats();
+        Serial.printf("[NTP] sincronizacoes=%lu deriva=%ldppm\n",
+                      (unsigned long)Clock::syncCount(), (long)Clock::driftPpm());
+    }
+#endif
+}
 
-        if (fbReady())
+// ================= Profiler do loop =================
+// Janela de DIAG_PUBLISH_MS: um nó por seção em /aquario/status/diag/<seção>,
+// alguns por tick, só enquanto sobra folga na TELEMETRY (nunca derruba
+// telemetria). Publicou todas → janela nova.
+void App::publishDiag(uint32_t now)
+{
+    if (diagCursor == 0 && now - diagWindowAt < DIAG_PUBLISH_MS)
+        return;
+    if (!fbReady() || fb_need_reauth)
+        return;
+
+    // seções da rede e depois as do controle (leitura do profiler da outra
+    // task sem trava: diagnóstico, um campo pode vir uma amostra adiantado)
+    const uint8_t total = profNet.count() + profCtl.count();
+    char json[RtdbScheduler::VALUE_LEN];
+    while (diagCursor < total && sched.room(Prio::TELEMETRY) > DIAG_ROOM_KEEP)
+    {
+        const bool net = diagCursor < profNet.count();
+        const LoopProfiler &p = net ? profNet : profCtl;
+        const uint8_t id = net ? diagCursor : diagCursor - profNet.count();
+        PathBuf<RtdbScheduler::PATH_LEN> path(RtdbPaths::DIAG);
+        path.add(p.name(id));
+        if (p.toJson(id, json, sizeof(json)))
+            sched.setRaw(path.c_str(), json, Prio::TELEMETRY);
+        diagCursor++;
+    }
+    if (diagCursor < total)
+        return;
+
+    // rádio por último: hora fechada (ou parcial) de tempo acordado/energia
+    if (radio.toJson(json, sizeof(json)))
+        sched.setRaw(PathBuf<RtdbScheduler::PATH_LEN>(RtdbPaths::DIAG).add("radio").c_str(), json, Prio::TELEMETRY);
+
+    diagCursor = 0;
+    diagWindowAt = now;
+    profNet.reset();
+    profCtlReset = true; // a task de controle zera o dela no próximo tick
+}
+
+void App::printDiag()
+{
+    Serial.printf("[DIAG] janela de %lus (µs)\n", (unsigned long)((millis() - diagWindowAt) / 1000));
+    Serial.printf("[DIAG] %-9s %8s %8s %8s %8s %8s %8s\n", "secao", "n", "min", "avg", "p50", "p99", "max");
+    for (const LoopProfiler *p : {&profNet, &profCtl})
+    {
+        for (uint8_t i = 0; i < p->count(); i++)
         {
-            Database.set<uint64_t>(aClient, "/aquario/status/feeder/last_ts", lastFeedTs, processData, "RTDB_Status_feeder_ts");
-            Database.set<bool>(aClient, "/aquario/status/feeder/busy", false, processData, "RTDB_Status_feeder_busy");
+            const LoopProfiler::Summary r = p->summary(i);
+            Serial.printf("[DIAG] %-9s %8lu %8lu %8lu %8lu %8lu %8lu\n", p->name(i),
+                          (unsigned long)r.n, (unsigned long)r.minUs, (unsigned long)r.avgUs,
+                          (unsigned long)r.p50Us, (unsigned long)r.p99Us, (unsigned long)r.maxUs);
         }
-        Serial.println("[FEEDER] Concluido");
     }
+    printBoot();
+    feeder.printStats();
+    tempSensor.printStats();
+    phSensor.printStats();
+    lcdFrame.printStats();
+    radio.printStats();
+    Serial.printf("[DIAG] filas: eventos %u/%u (descartados %lu), comandos descartados %lu\n",
+                  (unsigned)eventQueue.size(), (unsigned)eventQueue.capacity(),
+                  (unsigned long)eventDrops.load(), (unsigned long)cmdDrops);
 }
 
-bool App::feederRequest(uint8_t portions)
+// 'p' = imprime a janela atual, 'r' = zera a janela,
+// 'b' = benchmark do alimentador (roda na task de controle)
+void App::handleSerialCommands()
 {
-    if (portions == 0 || portions > MAX_PORTIONS_PER_EVENT)
-        return false;
-    if (feederBusy)
-        return false;
-    if (!waterOk)
+    while (Serial.available() > 0)
     {
-        Serial.println("[FEEDER] BLOQUEADO: nivel baixo de agua");
-        return false;
+        const int c = Serial.read();
+        if (c == 'p')
+            printDiag();
+        else if (c == 'r')
+        {
+            profNet.reset();
+            profCtlReset = true;
+            diagCursor = 0;
+            diagWindowAt = millis();
+            Serial.println("[DIAG] janela zerada");
+        }
+        else if (c == 'b' && !cmdQueue.push({ControlCmd::Kind::BENCH_STEPPER, 0}))
+            cmdDrops++;
     }
-    long steps = (long)FEED_STEPS_PER_PORTION * (long)portions;
-    feederBeginMove(steps);
-    Serial.printf("[FEEDER] Iniciando: %u porcao(oes), %ld passos\n", portions, steps);
-    return true;
 }
 
-// ================= Firebase publishers/logs =================
-void App::publicarHeater(bool on)
+// ================= Boot =================
+const char *App::resetReasonName()
 {
-    pending_publish_heater = true;
-
-    pending_heater_state_publish = false;
+    switch (esp_reset_reason())
+    {
+    case ESP_RST_POWERON:
+        return "poweron";
+    case ESP_RST_EXT:
+        return "externo";
+    case ESP_RST_SW:
+        return "software"; // inclui fim de OTA
+    case ESP_RST_PANIC:
+        return "panic";
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+        return "watchdog";
+    case ESP_RST_DEEPSLEEP:
+        return "deepsleep";
+    case ESP_RST_BROWNOUT:
+        return "brownout";
+    default:
+        return "desconhecido";
+    }
 }
 
-void App::publicarWaterOk(bool ok)
+// Namespace "boot" na NVS: endereço do LCD e versão dos nós do RTDB.
+// Só grava quando o valor muda (sem desgaste a cada boot)
+uint8_t App::loadBootByte(const char *key)
 {
-    if (!fbReady())
-        return;
-    Database.set<bool>(aClient, "/aquario/float/water_ok", ok, processData, "RTDB_Float_WaterOk");
+    Preferences p;
+    if (!p.begin("boot", true))
+        return 0;
+    const uint8_t v = p.getUChar(key, 0);
+    p.end();
+    return v;
 }
 
-void App::publicarWaterfall(bool on)
+void App::saveBootByte(const char *key, uint8_t v)
 {
-    pending_publish_waterfall = true;
+    Preferences p;
+    if (!p.begin("boot", false))
+        return;
+    if (p.getUChar(key, 0) != v)
+        p.putUChar(key, v);
+    p.end();
 }
 
-void App::logHeaterDecision(float tC, bool newState, float onThr, float offThr, const char *reason)
+void App::printBoot()
 {
-    Serial.printf("[CTRL] Aquecedor: %s | t=%.2f°C | Liga<%.2f  Desliga>%.2f | %s\n",
-                  newState ? "ON " : "OFF", tC, onThr, offThr, reason);
+    Serial.printf("[BOOT] reset=%s fases (ms desde o reset):", resetReasonName());
+    for (uint8_t i = 0; i < BootTrace::count(); i++)
+    {
+        const BootTrace::Mark m = BootTrace::at(i);
+        if (m.name[0])
+            Serial.printf(" %s=%lu", m.name, (unsigned long)m.ms);
+    }
+    Serial.println();
 }
 
-void App::publicarLastSeen()
+// /aquario/status/boot/<fase> = ms desde o reset; sobrescrito a cada boot
+void App::publishBoot()
 {
-    if (!fbReady())
-        return;
-    Database.set<uint64_t>(aClient, "/aquario/status/last_seen", (uint64_t)epoch_ms(), processData, "RTDB_LastSeen");
+    PathBuf<RtdbScheduler::PATH_LEN> path(RtdbPaths::BOOT);
+    const size_t base = path.length();
+    for (uint8_t i = 0; i < BootTrace::count(); i++)
+    {
+        const BootTrace::Mark m = BootTrace::at(i);
+        if (!m.name[0])
+            continue;
+        sched.setInt(path.truncate(base).add(m.name).c_str(), (long)m.ms, Prio::LOGS);
+    }
+    sched.setString(path.truncate(base).add("reset").c_str(), resetReasonName(), Prio::LOGS);
 }
 
-// ================= Firebase Listeners Setup =================
-void App::setupFirebaseListeners()
+// ================= Firebase Stream Setup =================
+// Um único stream (SSE) em /aquario/controle, num cliente dedicado: o
+// primeiro "put" traz o snapshot completo e os seguintes só o que mudou.
+void App::startControlStream()
 {
     if (!fbReady())
         return;
 
-    Serial.println("[FB] Configurando listeners...");
-
-    Database.get(aClient, "/aquario/controle/heater/mode", processData, false, "heater_mode_listener");
-
-    Database.get(aClient, "/aquario/controle/heater/turn_on_now", processData, false, "heater_cmd_listener");
-
-    Database.get(aClient, "/aquario/controle/waterfall/mode", processData, false, "waterfall_mode_listener");
+    streamClient.stopAsync();
+    streamClient.setSSEFilters("get,put,patch,keep-alive,cancel,auth_revoked");
+    Database.get(streamClient, RtdbPaths::CONTROLE, processData, true, "controle_stream");
 
-    Database.get(aClient, "/aquario/controle/waterfall/turn_on_now", processData, false, "waterfall_cmd_listener");
-
-    Database.get(aClient, "/aquario/controle/feeder/feed_now", processData, false, "feeder_cmd_listener");
-
-    Serial.println("[FB] Listeners iniciais solicitados");
+    streamStarted = true;
+    lastStreamEventMs = millis();
+    BootTrace::mark("stream");
+    Serial.println("[FB] Stream de /aquario/controle solicitado");
 }
 
-// ================= Public: begin/tick =================
+// ================= Public: begin =================
+// Ordem do boot: relés em estado seguro → sensores/LCD → task de controle →
+// só então rede. Nada aqui espera Wi-Fi, NTP ou Firebase: o aquário fica
+// sob controle local poucas dezenas de ms após o reset.
 void App::begin()
 {
+    BootTrace::mark("inicio");
     App::instance = this;
-    Serial.begin(115200);
-    delay(200);
-    Serial.println("\nBoot ESP32 + DS18B20 + Sensor pH + FirebaseClient + OTA + HeaterCtrl + FloatSwitch + LCD + Feeder");
-
-    analogReadResolution(12);
-    analogSetAttenuation(ADC_11db);
+    static_assert(sizeof(PROF_NET_SECTIONS) / sizeof(PROF_NET_SECTIONS[0]) == PN_COUNT, "PROF_NET_SECTIONS fora de ordem");
+    static_assert(sizeof(PROF_CTL_SECTIONS) / sizeof(PROF_CTL_SECTIONS[0]) == PC_COUNT, "PROF_CTL_SECTIONS fora de ordem");
+    profNet.begin(PROF_NET_SECTIONS, PN_COUNT);
+    profCtl.begin(PROF_CTL_SECTIONS, PC_COUNT);
 
-    pinMode(PIN_RELAY_HEATER, OUTPUT);
-    relayOff(PIN_RELAY_HEATER);
-    heaterOn = false;
+    // Relés primeiro: após brownout/OTA os pinos voltam flutuando
+    heater.begin(PIN_RELAY_HEATER, RELAY_ACTIVE_LOW);
 
     pinMode(PIN_RELAY_WATERFALL, OUTPUT);
     setWaterfall(true);
 
     pinMode(PIN_FLOAT_SWITCH, INPUT_PULLUP);
     waterOk = (readFloatAsBoia() == 1);
-    publicarWaterOk(waterOk);
 
     pinMode(PIN_BUZZER, OUTPUT);
     buzzerOff();
 
     pinMode(PIN_BTN, INPUT_PULLUP);
+    BootTrace::mark("gpio");
 
-    pinMode(FEED_IN1, OUTPUT);
-    pinMode(FEED_IN2, OUTPUT);
-    pinMode(FEED_IN3, OUTPUT);
-    pinMode(FEED_IN4, OUTPUT);
-    feederReleaseCoils();
-
-    connectWiFi();
-    syncTime();
-    setupOTA();
+    // Sem delay: a UART já aceita bytes; o monitor perde no máximo o banner
+    Serial.begin(115200);
+    Serial.printf("\nBoot ESP32 + DS18B20 + Sensor pH + FirebaseClient + OTA + HeaterCtrl + FloatSwitch + LCD + Feeder (reset: %s)\n",
+                  resetReasonName());
 
-    if (pAuth)
-    {
-        delete pAuth;
-        pAuth = nullptr;
-    }
-    pAuth = new UserAuth(WEB_API_KEY, USER_EMAIL, USER_PASS);
-    initializeApp(aClient, app, getAuth(*pAuth), App::processData, "authTask");
-    app.getApp<RealtimeDatabase>(Database);
-    Database.url(DATABASE_URL);
+    // pH por ADC contínuo (DMA); analogRead() não é mais usado no ADC1
+    phSensor.begin(PH_ADC_PIN);
+    tempSensor.begin(ONE_WIRE_BUS);
 
-    sensors.begin();
+    // begin() roda na loopTask (núcleo 1): a ISR do timer fica no mesmo
+    // núcleo da task de controle
+    feeder.begin(FEED_IN1, FEED_IN2, FEED_IN3, FEED_IN4);
+    BootTrace::mark("sensores");
 
     initLCD();
     updateLCD();
     tLastLcd = millis();
     tLastRotate = millis();
+    BootTrace::mark("lcd");
+
+    shadow.attach(sched); // descarte na fila → nó volta a sujo
+    shadow.define(SH_HEATER, RtdbPaths::HEATER_STATE, Prio::CONTROL, 0.0f, STATE_REFRESH_MS);
+    shadow.define(SH_WATERFALL, RtdbPaths::WATERFALL_STATE, Prio::CONTROL, 0.0f, STATE_REFRESH_MS);
+    shadow.define(SH_WATER_OK, RtdbPaths::WATER_OK, Prio::SAFETY, 0.0f, STATE_REFRESH_MS);
+    shadow.define(SH_FEEDER_BUSY, RtdbPaths::FEEDER_BUSY, Prio::CONTROL, 0.0f, STATE_REFRESH_MS);
+    shadow.define(SH_TEMP_CURRENT, RtdbPaths::TEMP_CURRENT, Prio::TELEMETRY, 0.05f, STATE_REFRESH_MS);
+    shadow.define(SH_PH_CURRENT, RtdbPaths::PH_CURRENT, Prio::TELEMETRY, 0.02f, STATE_REFRESH_MS);
+
+    // Controle no núcleo 1 com prioridade maior; rede no núcleo 0, junto do
+    // driver Wi-Fi/lwIP. Uma escrita TLS lenta não atrasa relé nem passo.
+    xTaskCreatePinnedToCore(controlTaskEntry, "control", CONTROL_STACK, this, CONTROL_PRIO, nullptr, 1);
+
+    // Daqui para baixo só a rede: o controle já está rodando
+    nodesVersion = loadBootByte("nodes");
+    backlog.begin("/backlog", "/backlog.ack");
+
+    // Rede sobe em segundo plano (Wi-Fi com BSSID/canal da NVS, SNTP
+    // assíncrono); o Firebase começa no primeiro tick com Wi-Fi + relógio
+    wifi.begin(WIFI_SSID, WIFI_PASSWORD);
+    syncTime();
+    setupTls();
+    radio.begin(millis());
 
-    pending_heater_state_publish = true;
+    xTaskCreatePinnedToCore(networkTaskEntry, "network", NET_STACK, this, NET_PRIO, nullptr, 0);
 }
 
-void App::tick()
+// ================= Tasks =================
+void App::controlTaskEntry(void *arg)
 {
-    app.loop();
-    ArduinoOTA.handle();
+    App *self = static_cast<App *>(arg);
+    const TickType_t period = pdMS_TO_TICKS(CONTROL_PERIOD_MS);
+    TickType_t last = xTaskGetTickCount();
+    BootTrace::mark("controle");
+    for (;;)
+    {
+        self->controlTick();
+        // estourou o período (ex.: conversão do DS18B20): não tenta
+        // recuperar os ticks perdidos em rajada
+        if (xTaskGetTickCount() - last > period)
+            last = xTaskGetTickCount();
+        vTaskDelayUntil(&last, period);
+    }
+}
 
-    // === Flush de pendências de publicação ===
-    if (fbReady() && !fb_need_reauth)
+void App::networkTaskEntry(void *arg)
+{
+    App *self = static_cast<App *>(arg);
+    for (;;)
+    {
+        self->networkTick();
+        vTaskDelay(pdMS_TO_TICKS(NET_PERIOD_MS)); // deixa o IDLE0 alimentar o watchdog
+    }
+}
+
+// Task de rede: Wi-Fi, Firebase, auth, publicação. Pode demorar à vontade
+// (TLS, DNS, LittleFS): nada aqui segura a task de controle.
+void App::networkTick()
+{
+#if LOOP_PROFILE
+    profNet.startTick();
+#endif
+    // Wi-Fi nunca bloqueia: sem link, só o controle local roda
+    wifi.handle(millis());
+    if (wifi.justConnected() && !otaStarted)
+    {
+        BootTrace::mark("wifi");
+        setupOTA();
+        otaStarted = true;
+    }
+    if (wifi.connected() && !fbStarted)
     {
-        if (pending_publish_heater)
+        if (Clock::synced())
         {
-            Database.set<bool>(aClient, "/aquario/controle/heater/state",
-                               heaterOn, fbAck, "RTDB_Set_Heater_state");
-            pending_publish_heater = false;
+            BootTrace::mark("ntp");
+            startFirebase();
         }
-        if (pending_publish_waterfall)
+        else if (!clockWaitLogged)
         {
-            Database.set<bool>(aClient, "/aquario/controle/waterfall/state",
-                               waterfallOn, fbAck, "RTDB_Set_Waterfall_state");
-            pending_publish_waterfall = false;
+            Serial.println("[FB] Aguardando NTP para validar certificados");
+            clockWaitLogged = true;
         }
+    }
+    PROF_LAP(profNet, PN_WIFI);
+
+    // Cliente do Firebase só roda com link: sem Wi-Fi cada tentativa de
+    // conexão bloquearia até o timeout de TCP
+    if (fbStarted && wifi.connected())
+    {
+        app.loop();
+        Database.loop();
+    }
+    if (otaStarted)
+        ArduinoOTA.handle();
+    if (preSyncCount && Clock::synced())
+        flushPreSync();
+    PROF_LAP(profNet, PN_FB_LOOP);
+
+    // === Flush de pendências de publicação ===
+    if (fbReady() && !fb_need_reauth)
+    {
         if (pending_reset_feednow)
         {
-            Database.set<bool>(aClient, "/aquario/controle/feeder/feed_now",
-                               false, fbAck, "RTDB_Reset_FeedNow");
+            sched.setBool(RtdbPaths::FEED_NOW, false, Prio::CONTROL);
             pending_reset_feednow = false;
         }
     }
 
     const uint32_t now = millis();
 
-    if (fb_need_reauth && (int32_t)(now - fb_cooldown_until) >= 0)
+    if (fbStarted)
+        serviceAuth(now);
+
+    // Sem refresh token (ou refresh esgotado) → sign-in completo
+    if (fb_need_reauth && !authToken.hasRefresh() && !refresher.busy() &&
+        (int32_t)(now - fb_cooldown_until) >= 0)
     {
         Serial.println("[FB] Reauth iniciando...");
-        if (!pAuth)
-            pAuth = new UserAuth(WEB_API_KEY, USER_EMAIL, USER_PASS);
-
-        initializeApp(aClient, app, getAuth(*pAuth), App::processData, "reauthTask");
-        app.getApp<RealtimeDatabase>(Database);
-        Database.url(DATABASE_URL);
+        signIn("reauthTask");
 
         fb_need_reauth = false;
         fb_ready_notified = false;
+        streamStarted = false;
         fb_cooldown_until = now + 500;
     }
+    PROF_LAP(profNet, PN_AUTH);
 
-    if (WiFi.status() != WL_CONNECTED)
-        connectWiFi();
-
-    if (fbReady() && pending_heater_state_publish)
-    {
-        publicarHeater(heaterOn);
-    }
-
-    static uint8_t initStep = 0;
-    static uint32_t lastInitStep = 0;
-
+    // Criação/normalização dos nós de controle: um único update multi-caminho.
+    // Versão na NVS igual → os nós já existem: pula o update (e não volta os
+    // modos do usuário para "auto" a cada boot) e abre o stream na hora.
     if (fbReady() && !feederFbInitDone)
     {
-        if (now - lastInitStep >= 500)
+        if (nodesVersion == NODES_VERSION)
         {
-            lastInitStep = now;
-
-            switch (initStep)
-            {
-            case 0:
-                Database.set<bool>(aClient, "/aquario/controle/feeder/feed_now", false, processData, "RTDB_Init_FeedNow");
-                delay(50);
-                break;
-            case 1:
-                Database.set<bool>(aClient, "/aquario/status/feeder/busy", false, processData, "RTDB_Init_FeederBusy");
-                delay(50);
-                break;
-            case 2:
-                Database.set<uint64_t>(aClient, "/aquario/status/feeder/last_ts", 0, processData, "RTDB_Init_FeederTs");
-                delay(50);
-                break;
-            case 3:
-                Database.set<int>(aClient, "/aquario/config/feeder/steps_per_portion", FEED_STEPS_PER_PORTION, processData, "RTDB_Init_Steps");
-                delay(50);
-                break;
-            case 4:
-                Database.set<int>(aClient, "/aquario/config/feeder/step_interval_ms", (int)FEED_STEP_INTERVAL_MS, processData, "RTDB_Init_Interval");
-                delay(50);
-                break;
-            case 5:
-                Database.set<int>(aClient, "/aquario/config/feeder/max_portions_per_event", (int)MAX_PORTIONS_PER_EVENT, processData, "RTDB_Init_MaxPort");
-                delay(50);
-                break;
-            case 6:
-                Database.set<const char *>(aClient, "/aquario/controle/heater/mode", "auto", processData, "RTDB_Init_HeaterMode");
-                delay(50);
-                break;
-            case 7:
-                Database.set<bool>(aClient, "/aquario/controle/heater/turn_on_now", false, processData, "RTDB_Init_HeaterCmd");
-                delay(50);
-                break;
-            case 8:
-                Database.set<const char *>(aClient, "/aquario/controle/waterfall/mode", "auto", processData, "RTDB_Init_WfMode");
-                delay(50);
-                break;
-            case 9:
-                Database.set<bool>(aClient, "/aquario/controle/waterfall/turn_on_now", false, processData, "RTDB_Init_WfCmd");
-                delay(50);
-                feederFbInitDone = true;
-                Serial.println("[FB] Nós do feeder + modos criados/atualizados.");
-                break;
-            }
-
-            initStep++;
+            streamNotBefore = now;
+            Serial.println("[FB] Nós já criados (NVS), init pulado.");
         }
-    }
-
-    static bool listenersSetup = false;
-    static uint32_t nodesCreatedAt = 0;
-
-    if (feederFbInitDone && !listenersSetup)
-    {
-        if (nodesCreatedAt == 0)
-        {
-            nodesCreatedAt = now;
-        }
-        else if (now - nodesCreatedAt >= 2000)
+        else
         {
-            setupFirebaseListeners();
-            listenersSetup = true;
+            sched.setBool(RtdbPaths::FEED_NOW, false, Prio::CONTROL);
+            sched.setBool(RtdbPaths::FEEDER_BUSY, false, Prio::CONTROL);
+            sched.setU64(RtdbPaths::FEEDER_LAST_TS, 0, Prio::CONTROL);
+            sched.setInt(RtdbPaths::FEEDER_STEPS, FEED_STEPS_PER_PORTION, Prio::CONTROL);
+            sched.setInt(RtdbPaths::FEEDER_STEP_RATE, (int)FEED_STEP_RATE_HZ, Prio::CONTROL);
+            sched.setInt(RtdbPaths::FEEDER_MAX_PORTIONS, (int)MAX_PORTIONS_PER_EVENT, Prio::CONTROL);
+            sched.setString(RtdbPaths::HEATER_MODE, "auto", Prio::CONTROL);
+            sched.setBool(RtdbPaths::HEATER_ON_NOW, false, Prio::CONTROL);
+            sched.setString(RtdbPaths::WATERFALL_MODE, "auto", Prio::CONTROL);
+            sched.setBool(RtdbPaths::WATERFALL_ON_NOW, false, Prio::CONTROL);
+            streamNotBefore = now + 2000;
+            nodesSavePending = true;
+            Serial.println("[FB] Nós do feeder + modos criados/atualizados.");
         }
+        feederFbInitDone = true;
     }
 
-    static uint32_t lastCmdPoll = 0;
-    static uint8_t cmdPollIndex = 0;
-
-    if (fbReady() && listenersSetup && (now - lastCmdPoll >= 5000))
+    // CONTROL vazia = update de init confirmado (erro devolve a entrada à fila)
+    if (nodesSavePending && sched.depth(Prio::CONTROL) == 0)
     {
-        lastCmdPoll = now;
+        saveBootByte("nodes", NODES_VERSION);
+        nodesVersion = NODES_VERSION;
+        nodesSavePending = false;
+    }
 
-        switch (cmdPollIndex)
+    if (feederFbInitDone && fbReady() && !fb_need_reauth)
+    {
+        if (!streamStarted && (int32_t)(now - streamNotBefore) >= 0)
         {
-        case 0:
-            Database.get(aClient, "/aquario/controle/heater/mode", processData, false, "heater_mode_listener");
-            break;
-        case 1:
-            Database.get(aClient, "/aquario/controle/heater/turn_on_now", processData, false, "heater_cmd_listener");
-            break;
-        case 2:
-            Database.get(aClient, "/aquario/controle/waterfall/mode", processData, false, "waterfall_mode_listener");
-            break;
-        case 3:
-            Database.get(aClient, "/aquario/controle/waterfall/turn_on_now", processData, false, "waterfall_cmd_listener");
-            break;
-        case 4:
-            Database.get(aClient, "/aquario/controle/feeder/feed_now", processData, false, "feeder_cmd_listener");
-            break;
+            startControlStream();
+        }
+        else if (streamStarted && now - lastStreamEventMs >= STREAM_IDLE_MS)
+        {
+            // o RTDB manda keep-alive a cada ~30 s; silêncio maior = conexão morta
+            Serial.println("[FB] Stream sem eventos, reabrindo");
+            startControlStream();
         }
-
-        cmdPollIndex++;
-        if (cmdPollIndex > 4)
-            cmdPollIndex = 0;
-
-        delay(100);
     }
 
     // --- HEARTBEAT: publicar /status/last_seen ---
     if (!fb_was_ready && fbReady())
     {
+        // (re)conectou: o que estava no RTDB pode ter mudado sem nós
+        BootTrace::mark("fb_ready");
+        shadow.invalidate();
         publicarLastSeen();
-        lastSeenAt = now;
         fb_was_ready = true;
     }
     if (!fbReady())
@@ -842,209 +1389,208 @@ void App::tick()
         fb_was_ready = false;
     }
 
-    if (fbReady() && !fb_need_reauth && (now - lastSeenAt >= 10000))
+    // Fases do boot: uma vez, depois que o stream abriu (última fase)
+    if (streamStarted && !bootPublished)
     {
-        publicarLastSeen();
-        lastSeenAt = now;
+        printBoot();
+        publishBoot();
+        bootPublished = true;
     }
 
-    // (A) BOIA + CASCATA (debounce)
+    // Rádio: fora das janelas fica em modem sleep. Estado de relé/boia,
+    // comandos (SAFETY/CONTROL) e refresh do token abrem janela na hora; o
+    // resto espera a periódica. Só gerencia com o stream de pé e sem OTA.
+    radio.setManaged(streamStarted && fbReady() && !fb_need_reauth && !otaActive, now);
     {
-        static uint32_t tMark = 0;
-        static int stableLogical = readFloatAsBoia();
-        static int lastLogical = stableLogical;
+        const bool urgent = sched.depth(Prio::SAFETY) || sched.depth(Prio::CONTROL) || refresher.busy();
+        const bool busy = urgent || sched.depth(Prio::TELEMETRY) || sched.depth(Prio::LOGS);
+        radio.tick(now, urgent, busy);
+    }
 
-        int nowLogical = readFloatAsBoia();
+    if (radio.periodicDue() && fbReady() && !fb_need_reauth)
+        publicarLastSeen();
+    PROF_LAP(profNet, PN_FB_MAINT);
 
-        if (nowLogical != lastLogical)
-        {
-            tMark = now;
-            lastLogical = nowLogical;
-        }
+    // Eventos da task de controle (estados, leituras, médias, alimentador)
+    drainEvents(now);
+    PROF_LAP(profNet, PN_EVENTS);
 
-        if (nowLogical != stableLogical)
-        {
-            uint32_t elapsed = now - tMark;
+    // Diagnóstico: janela dos profilers → RTDB; comandos pela serial
+#if LOOP_PROFILE
+    publishDiag(now);
+    handleSerialCommands();
+#endif
+    PROF_LAP(profNet, PN_DIAG);
+
+    // Flush: estados que mudaram + todas as escritas deste tick numa única requisição
+    publishState(now);
+    flushWrites();
+    PROF_LAP(profNet, PN_FLUSH);
+#if LOOP_PROFILE
+    profNet.endTick(PN_TICK);
+#endif
+}
 
-            bool quedaConfirmada = (nowLogical == 0) && (elapsed >= T_LOW_CONFIRM_MS);
-            bool retornoConfirmado = (nowLogical == 1) && (elapsed >= T_HIGH_CONFIRM_MS);
+// Task de controle: sensores, relés, alimentador, LCD. Não toca em rede:
+// comandos chegam por cmdQueue, tudo que vai ao RTDB sai por eventQueue.
+void App::controlTick()
+{
+#if LOOP_PROFILE
+    if (profCtlReset.exchange(false))
+        profCtl.reset();
+    profCtl.startTick();
+#endif
+    const uint32_t now = millis();
 
-            if (quedaConfirmada || retornoConfirmado)
-            {
-                stableLogical = nowLogical;
-                bool newWaterOk = (stableLogical == 1);
+    ControlCmd cmd;
+    while (cmdQueue.pop(cmd))
+        applyCommand(cmd);
+    PROF_LAP(profCtl, PC_CMDS);
 
-                if (newWaterOk != waterOk)
+    // (A) BOIA + CASCATA (debounce: queda confirma em T_LOW_CONFIRM_MS,
+    // retorno em T_HIGH_CONFIRM_MS)
+    {
+        const bool newWaterOk = floatFilter.process(readFloatAsBoia(), now) == 1;
+
+        if (newWaterOk != waterOk)
+        {
+            waterOk = newWaterOk;
+
+            if (waterfallModeAuto)
+            {
+                if (waterOk)
                 {
-                    waterOk = newWaterOk;
-                    publicarWaterOk(waterOk);
-
-                    if (waterfallModeAuto)
-                    {
-                        if (waterOk)
-                        {
-                            setWaterfall(true);
-                            Serial.println("[ÁGUA] Nível: OK     | Cascata: LIGADA (auto)");
-                        }
-                        else
-                        {
-                            setWaterfall(false);
-                            Serial.println("[ÁGUA] Nível: BAIXO  | Cascata: DESLIGADA (auto)");
-                        }
-                    }
-                    else
-                    {
-                        Serial.printf("[ÁGUA] Nível: %s | Cascata em modo MANUAL (sem ação auto)\n",
-                                      waterOk ? "OK" : "BAIXO");
-                    }
+                    setWaterfall(true);
+                    Serial.println("[ÁGUA] Nível: OK     | Cascata: LIGADA (auto)");
                 }
+                else
+                {
+                    setWaterfall(false);
+                    Serial.println("[ÁGUA] Nível: BAIXO  | Cascata: DESLIGADA (auto)");
+                }
+            }
+            else
+            {
+                Serial.printf("[ÁGUA] Nível: %s | Cascata em modo MANUAL (sem ação auto)\n",
+                              waterOk ? "OK" : "BAIXO");
             }
         }
     }
 
+    PROF_LAP(profCtl, PC_BOIA);
+
     // (B) TEMPERATURA + HEATER
-    if (now - lastSampleTemp >= SAMPLE_MS)
+    if (now - lastSampleTemp >= SAMPLE_MS && !tempSensor.busy())
     {
         lastSampleTemp = now;
+        tempSensor.start(now);
+        PROF_LAP(profCtl, PC_TEMP);
+    }
 
-        sensors.requestTemperatures();
-        float tC = sensors.getTempCByIndex(0);
+    // uma sonda lida por tick; o aquecedor decide quando a rodada fecha
+    const TemperatureSensor::Step tempStep = tempSensor.poll(now);
+    if (tempStep == TemperatureSensor::Step::ROUND)
+    {
+        for (uint8_t i = 0; i < tempSensor.count(); i++)
+        {
+            const float c = tempSensor.latest(i);
+            if (!isnan(c))
+                tempWin[i].add(c);
+        }
+
+        // sonda 0 = tanque
+        float tC = tempSensor.latest(0);
 
-        if (tC != DEVICE_DISCONNECTED_C)
+        if (!isnan(tC))
         {
-            sumTemp += tC;
-            nTemp++;
             gLastTempC = tC;
+            pushEvent(ControlEvent::Kind::TEMP_NOW, tC, Clock::monoMillis());
 
 #if LOG_HEARTBEAT
             Serial.printf("[AMOSTRA] Temp=%.2f°C | Agua=%s | Cascata=%s | Heater=%s\n",
                           tC,
                           waterOk ? "OK" : "BAIXO",
                           waterfallOn ? "LIGADA" : "DESLIGADA",
-                          heaterOn ? "ON" : "OFF");
+                          heater.isOn() ? "ON" : "OFF");
 #endif
-
-            bool changed = false;
-
-            if (!isfinite(tC) || tC < T_MIN_SAFE || tC > T_MAX_SAFE)
-            {
-                if (heaterOn)
-                {
-                    relayOff(PIN_RELAY_HEATER);
-                    heaterOn = false;
-                    changed = true;
-                    logHeaterDecision(tC, heaterOn, T_MIN_ON(), T_MAX_OFF(),
-                                      heaterModeAuto ? "fail-safe" : "fail-safe (manual)");
-                }
-                Serial.println("[CTRL] Fail-safe: temperatura fora da faixa. Aquecedor OFF");
-            }
-            else if (heaterModeAuto)
-            {
-                bool canSwitch = (now - lastSwitchMs) >= MIN_SWITCH_MS;
-
-                if (!heaterOn && tC < T_MIN_ON() && canSwitch)
-                {
-                    relayOn(PIN_RELAY_HEATER);
-                    heaterOn = true;
-                    changed = true;
-                    lastSwitchMs = now;
-                    logHeaterDecision(tC, heaterOn, T_MIN_ON(), T_MAX_OFF(), "abaixo do limiar");
-                }
-                else if (heaterOn && tC > T_MAX_OFF() && canSwitch)
-                {
-                    relayOff(PIN_RELAY_HEATER);
-                    heaterOn = false;
-                    changed = true;
-                    lastSwitchMs = now;
-                    logHeaterDecision(tC, heaterOn, T_MIN_ON(), T_MAX_OFF(), "acima do limiar");
-                }
-            }
-
-            if (changed)
-                publicarHeater(heaterOn);
         }
-        else
+
+        // decisão em HeaterController::step (a mesma que o AquaSim exercita)
+        const HeaterController::Config &hc = heater.config();
+        switch (heater.step(tC, heaterModeAuto, now))
         {
-            if (heaterOn)
-            {
-                relayOff(PIN_RELAY_HEATER);
-                heaterOn = false;
-                publicarHeater(heaterOn);
-                logHeaterDecision(NAN, heaterOn, T_MIN_ON(), T_MAX_OFF(), "sensor desconectado");
-            }
-            Serial.println("[CTRL] DS18B20 desconectado. Aquecedor OFF (fail-safe).");
+        case HeaterController::Action::ON_BELOW:
+            logHeaterDecision(tC, true, hc.onThr(), hc.offThr(), "abaixo do limiar");
+            break;
+        case HeaterController::Action::OFF_ABOVE:
+            logHeaterDecision(tC, false, hc.onThr(), hc.offThr(), "acima do limiar");
+            break;
+        case HeaterController::Action::OFF_FAIL_SAFE:
+            logHeaterDecision(tC, false, hc.onThr(), hc.offThr(),
+                              isnan(tC) ? "sensor desconectado" : heaterModeAuto ? "fail-safe" : "fail-safe (manual)");
+            break;
+        case HeaterController::Action::NONE:
+            break;
         }
+        if (isnan(tC))
+            Serial.println("[CTRL] DS18B20 desconectado. Aquecedor OFF (fail-safe).");
+        else if (!heater.valid(tC))
+            Serial.println("[CTRL] Fail-safe: temperatura fora da faixa. Aquecedor OFF");
     }
+    if (tempStep != TemperatureSensor::Step::NONE)
+        PROF_LAP(profCtl, PC_TEMP);
 
-    // (C) Upload das MÉDIAS a cada 5 min
-    if ((now - lastUploadTemp >= UPLOAD_MS) && nTemp > 0)
+    // (C) Resumo da janela de 5 min, uma série por sonda
+    if ((now - lastUploadTemp >= UPLOAD_MS) && tempSamples() > 0)
     {
         lastUploadTemp = now;
-        float media5m = sumTemp / nTemp;
-        sumTemp = 0.0;
-        nTemp = 0;
-
-        char path[64];
-        uint64_t ts = epoch_ms();
-        snprintf(path, sizeof(path), "/aquario/temperatura/%llu", (unsigned long long)ts);
-        Database.set<float>(aClient, path, media5m, processData, "RTDB_Set_Temp");
-        Serial.printf("[ENVIO] Temp média (5 min): %.2f °C → %s\n", media5m, path);
-    }
-
-    // (D) pH: amostra ~25 s, envia 5 min
-    if (now - lastSamplePH >= SAMPLE_MS)
-    {
-        lastSamplePH = now;
-        const int N = 12;
-        long somaADC = 0;
-        for (int i = 0; i < N; i++)
+        const uint64_t mono = Clock::monoMillis();
+        for (uint8_t i = 0; i < TemperatureSensor::MAX_PROBES; i++)
         {
-            somaADC += analogRead(PH_ADC_PIN);
-            delayMicroseconds(100);
+            if (tempWin[i].count() == 0)
+                continue;
+            const WindowStats::Summary st = tempWin[i].summary();
+            tempWin[i].reset();
+
+            pushWindow(Stamped::TEMP_AVG, i, mono, st);
+            Serial.printf("[ENVIO] Temp sonda %u (5 min): média %.2f  mín %.2f  máx %.2f  dp %.3f °C → série\n",
+                          i, st.mean, st.min, st.max, st.stddev);
         }
-        const float adc = somaADC / (float)N;
-        const float volts = adc * (ADC_VREF / ADC_MAX_COUNTS);
+        PROF_LAP(profCtl, PC_MEDIAS);
+    }
 
-        if (!phInit)
-        {
-            emaV = volts;
-            phInit = true;
-        }
-        else
-        {
-            emaV = ALPHA * volts + (1.0f - ALPHA) * emaV;
-        }
+    // (D) pH: o DMA amostra o ADC o tempo todo; aqui só drena o anel.
+    // Amostra (média aparada → EMA → calibração) ~25 s, envia 5 min
+    phSensor.poll();
+    PROF_LAP(profCtl, PC_PH);
 
-        float pH = M_PH * emaV + B_PH;
-        if (pH < PH_MIN)
-            pH = PH_MIN;
-        if (pH > PH_MAX)
-            pH = PH_MAX;
+    const float pH = (now - lastSamplePH >= SAMPLE_MS) ? phSensor.readPH() : NAN;
+    if (!isnan(pH))
+    {
+        lastSamplePH = now;
 
-        sumPH += pH;
-        nPH++;
+        phWin.add(pH);
         gLastPH = pH;
+        pushEvent(ControlEvent::Kind::PH_NOW, pH, Clock::monoMillis());
 
 #if LOG_HEARTBEAT
         Serial.printf("[AMOSTRA] pH=%.2f (V=%.3f) | Agua=%s | Cascata=%s\n",
-                      pH, emaV,
+                      pH, phSensor.filteredVolts(),
                       waterOk ? "OK" : "BAIXO",
                       waterfallOn ? "LIGADA" : "DESLIGADA");
 #endif
+        PROF_LAP(profCtl, PC_PH);
     }
 
-    if ((now - lastUploadPH >= UPLOAD_MS) && nPH > 0)
+    if ((now - lastUploadPH >= UPLOAD_MS) && phWin.count() > 0)
     {
         lastUploadPH = now;
-        float mediaPH5m = sumPH / nPH;
-        sumPH = 0.0;
-        nPH = 0;
+        const WindowStats::Summary st = phWin.summary();
+        phWin.reset();
 
-        char path[64];
-        uint64_t ts = epoch_ms();
-        snprintf(path, sizeof(path), "/aquario/ph/%llu", (unsigned long long)ts);
-        Database.set<float>(aClient, path, mediaPH5m, processData, "RTDB_Set_pH");
-        Serial.printf("[ENVIO] pH médio (5 min): %.2f → %s\n", mediaPH5m, path);
+        pushWindow(Stamped::PH_AVG, 0, Clock::monoMillis(), st);
+        Serial.printf("[ENVIO] pH (5 min): médio %.2f  mín %.2f  máx %.2f → série\n", st.mean, st.min, st.max);
+        PROF_LAP(profCtl, PC_MEDIAS);
     }
 
     // (E) BUZZER
@@ -1066,32 +1612,35 @@ void App::tick()
         currentScreen = (currentScreen == Screen::RESUMO) ? Screen::DETALHE : Screen::RESUMO;
         updateLCD();
     }
+    PROF_LAP(profCtl, PC_IHM);
 
     // (G) Serviço do alimentador
     feederRun();
 
-    // (H) Agenda simples: 12h entre alimentações
+    // (H) Agenda simples: 12h entre alimentações (FeedSchedule::gate, o
+    // mesmo passo do AquaSim). Nível baixo: avisa uma vez e espera a água
     {
-        static bool firstInit = true;
-        const uint64_t nowEpoch = epoch_ms();
-
-        if (firstInit)
-        {
-            if (lastFeedTs == 0)
-            {
-                lastFeedTs = (nowEpoch > FEED_INTERVAL_MS ? nowEpoch - FEED_INTERVAL_MS : 0);
-            }
-            firstInit = false;
-        }
-
-        if (!feederBusy && (nowEpoch - lastFeedTs >= FEED_INTERVAL_MS))
+        const uint64_t nowMono = Clock::monoMillis();
+        switch (feedSchedule.gate(nowMono, feederBusy, waterOk))
         {
-            feederRequest(1);
-            if (fbReady())
+        case FeedSchedule::Gate::FEED:
+            if (feederRequest(1))
             {
-                Database.set<uint64_t>(aClient, "/aquario/feeder/logs/last_ts", nowEpoch, App::processData, "RTDB_Log_Feeder_ts");
+                pushEvent(ControlEvent::Kind::FEED_LOG, 0, nowMono);
+                Serial.println("[FEEDER] Alimentacao automatica (agenda 12h) solicitada");
             }
-            Serial.println("[FEEDER] Alimentacao automatica (agenda 12h) solicitada");
+            break;
+        case FeedSchedule::Gate::BLOCKED:
+            pushEvent(ControlEvent::Kind::FEED_BLOCKED, 0, nowMono); // log sai na task de rede
+            break;
+        case FeedSchedule::Gate::WAIT:
+            break;
         }
     }
+    PROF_LAP(profCtl, PC_FEEDER);
+
+    reportState(Clock::monoMillis());
+#if LOOP_PROFILE
+    profCtl.endTick(PC_TICK);
+#endif
 }
@@ -1,16 +1,21 @@
 #include "control/HeaterController.h"
+#include "actuators/FastGpio.h"
 
 void HeaterController::begin(uint8_t p, bool al){ pin=p; activeLow=al; pinMode(pin,OUTPUT); write(false); }
-void HeaterController::write(bool on){ state=on; digitalWrite(pin, activeLow ? !on : on); }
+void HeaterController::write(bool on){ state=on; FastGpio::write(pin, activeLow ? !on : on); }
 void HeaterController::forceOff(){ write(false); }
+void HeaterController::set(bool on){ write(on); }
 
-bool HeaterController::update(float tC, float sp, float hyst, float minSafe, float maxSafe, unsigned long now, unsigned long minSwitchMs, bool& changed){
-  changed=false;
-  if (!isfinite(tC) || tC < minSafe || tC > maxSafe){ if (state){ write(false); changed=true; } return changed; }
-  float onThr  = sp - hyst;
-  float offThr = sp + hyst;
-  bool canSwitch = (now - lastSwitch) >= minSwitchMs;
-  if (!state && tC < onThr && canSwitch){ write(true);  changed=true; lastSwitch=now; }
-  else if (state && tC > offThr && canSwitch){ write(false); changed=true; lastSwitch=now; }
-  return changed;
+HeaterController::Action HeaterController::step(float tC, bool autoMode, unsigned long now){
+  if (!valid(tC)){
+    if (!state) return Action::NONE;
+    write(false);
+    return Action::OFF_FAIL_SAFE;
+  }
+  if (!autoMode) return Action::NONE;
+  bool canSwitch = (now - lastSwitch) >= cfg.minSwitchMs;
+  if (!canSwitch) return Action::NONE;
+  if (!state && tC < cfg.onThr()){ write(true);  lastSwitch=now; return Action::ON_BELOW; }
+  if (state && tC > cfg.offThr()){ write(false); lastSwitch=now; return Action::OFF_ABOVE; }
+  return Action::NONE;
 }
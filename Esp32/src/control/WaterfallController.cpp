@@ -17,24 +17,8 @@ void WaterfallController::set(bool on) {
 }
 
 bool WaterfallController::processFloatRaw(int raw, unsigned long now, bool& waterOkOut) {
-    bool changed = false;
-
-    if (raw != _lastRaw) {
-        _changeTime = now;
-        _lastRaw = raw;
-    }
-
-    if (raw != _stableRaw) {
-        unsigned long elapsed = now - _changeTime;
-        
-        unsigned long requiredStable = (raw == 1) ? 2000 : 1000;
-        
-        if (elapsed >= requiredStable) {
-            _stableRaw = raw;
-            changed = true;
-        }
-    }
-
-    waterOkOut = (_stableRaw == 1);
-    return changed;
+    const int before = _float.head().value();
+    const int stable = _float.process(raw, now);
+    waterOkOut = (stable == 1);
+    return stable != before;
 }
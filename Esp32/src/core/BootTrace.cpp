@@ -0,0 +1,48 @@
+#include "core/BootTrace.h"
+#include <string.h>
+#include <atomic>
+
+#ifdef ARDUINO
+#include <esp_timer.h>
+uint32_t BootTrace::nowMs() { return (uint32_t)(esp_timer_get_time() / 1000); }
+#else
+#include <chrono>
+uint32_t BootTrace::nowMs() {
+  using namespace std::chrono;
+  static const steady_clock::time_point t0 = steady_clock::now();
+  return (uint32_t)duration_cast<milliseconds>(steady_clock::now() - t0).count();
+}
+#endif
+
+// slot reservado por fetch_add; o nome é publicado por último (release):
+// nome nulo = slot ainda sendo preenchido, leitores pulam
+static uint32_t s_ms[BootTrace::MAX_MARKS];
+static std::atomic<const char*> s_names[BootTrace::MAX_MARKS];
+static std::atomic<uint8_t> s_claimed{0};
+
+uint8_t BootTrace::count() {
+  const uint8_t n = s_claimed.load(std::memory_order_acquire);
+  return n < MAX_MARKS ? n : MAX_MARKS;
+}
+
+bool BootTrace::has(const char* name) {
+  for (uint8_t i = 0; i < count(); i++) {
+    const char* n = s_names[i].load(std::memory_order_acquire);
+    if (n && strcmp(n, name) == 0) return true;
+  }
+  return false;
+}
+
+void BootTrace::mark(const char* name) {
+  const uint32_t ms = nowMs();
+  if (has(name)) return;
+  const uint8_t i = s_claimed.fetch_add(1, std::memory_order_acq_rel);
+  if (i >= MAX_MARKS) return;
+  s_ms[i] = ms;
+  s_names[i].store(name, std::memory_order_release);
+}
+
+BootTrace::Mark BootTrace::at(uint8_t i) {
+  const char* n = i < count() ? s_names[i].load(std::memory_order_acquire) : nullptr;
+  return n ? Mark{n, s_ms[i]} : Mark{"", 0};
+}
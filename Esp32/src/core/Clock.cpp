@@ -1,7 +1,60 @@
 #include "core/Clock.h"
-#include <time.h>
-uint64_t epoch_ms(){
-  time_t s = time(nullptr);
-  if (s > 100000) return (uint64_t)s * 1000ULL;
-  return (uint64_t)millis();
+#include <esp_timer.h>
+
+// sync() vem da task do lwIP (callback do SNTP); leituras vêm do loop
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static bool     s_synced = false;
+static int64_t  s_offset = 0;      // epoch - mono na última referência
+static uint64_t s_refMono = 0;
+static int32_t  s_driftPpm = 0;
+static uint32_t s_syncs = 0;
+
+static constexpr int64_t DRIFT_MIN_SPAN_MS = 10 * 60 * 1000;  // referências muito próximas: erro do NTP domina
+static constexpr int64_t DRIFT_MAX_ERR_MS  = 5000;            // erro maior = ajuste manual/salto, não deriva
+static constexpr int32_t DRIFT_MAX_PPM     = 500;
+
+uint64_t Clock::monoMillis() { return (uint64_t)(esp_timer_get_time() / 1000); }
+
+bool Clock::synced() { return s_synced; }
+
+static int64_t project(uint64_t monoMs, int64_t offset, uint64_t refMono, int32_t ppm) {
+  int64_t dt = (int64_t)monoMs - (int64_t)refMono;
+  return (int64_t)monoMs + offset + dt * ppm / 1000000;
 }
+
+uint64_t Clock::toEpoch(uint64_t monoMs) {
+  portENTER_CRITICAL(&s_mux);
+  const bool ok = s_synced;
+  const int64_t offset = s_offset;
+  const uint64_t refMono = s_refMono;
+  const int32_t ppm = s_driftPpm;
+  portEXIT_CRITICAL(&s_mux);
+  if (!ok) return 0;
+  return (uint64_t)project(monoMs, offset, refMono, ppm);
+}
+
+uint64_t Clock::epochMillis() { return toEpoch(monoMillis()); }
+
+void Clock::sync(uint64_t epochMs, uint64_t monoMs) {
+  portENTER_CRITICAL(&s_mux);
+  if (s_synced) {
+    const int64_t span = (int64_t)monoMs - (int64_t)s_refMono;
+    const int64_t err = (int64_t)epochMs - project(monoMs, s_offset, s_refMono, s_driftPpm);
+    if (span >= DRIFT_MIN_SPAN_MS && err > -DRIFT_MAX_ERR_MS && err < DRIFT_MAX_ERR_MS) {
+      int32_t measured = s_driftPpm + (int32_t)(err * 1000000 / span);
+      int32_t ppm = (3 * s_driftPpm + measured) / 4;   // média móvel
+      if (ppm > DRIFT_MAX_PPM) ppm = DRIFT_MAX_PPM;
+      if (ppm < -DRIFT_MAX_PPM) ppm = -DRIFT_MAX_PPM;
+      s_driftPpm = ppm;
+    }
+  }
+  s_offset = (int64_t)epochMs - (int64_t)monoMs;
+  s_refMono = monoMs;
+  s_synced = true;
+  s_syncs++;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+int32_t Clock::driftPpm() { return s_driftPpm; }
+
+uint32_t Clock::syncCount() { return s_syncs; }
@@ -0,0 +1,100 @@
+#include "core/JsonScan.h"
+
+static const char* skipWs(const char* p) {
+  while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+  return p;
+}
+
+// Avança sobre uma string JSON (p aponta para a aspa de abertura)
+static const char* skipString(const char* p) {
+  p++;
+  while (*p && *p != '"') {
+    if (*p == '\\' && p[1]) p++;
+    p++;
+  }
+  return *p ? p + 1 : p;
+}
+
+// Avança sobre qualquer valor (escalar, objeto ou array)
+static const char* skipValue(const char* p) {
+  p = skipWs(p);
+  if (*p == '"') return skipString(p);
+  if (*p == '{' || *p == '[') {
+    int depth = 0;
+    while (*p) {
+      if (*p == '"') { p = skipString(p); continue; }
+      if (*p == '{' || *p == '[') depth++;
+      else if (*p == '}' || *p == ']') { if (--depth == 0) return p + 1; }
+      p++;
+    }
+    return p;
+  }
+  while (*p && *p != ',' && *p != '}' && *p != ']') p++;
+  return p;
+}
+
+static void copyScalar(const char* p, char* out, size_t outLen) {
+  if (!outLen) return;
+  p = skipWs(p);
+  // strings saem direto do buffer (tokens passam de 1 KB); o resto é curto
+  if (*p == '"') { JsonScan::unquote(p, out, outLen); return; }
+  const char* end = skipValue(p);
+  while (end > p && (end[-1] == ' ' || end[-1] == '\r' || end[-1] == '\n')) end--;
+  size_t n = (size_t)(end - p);
+  if (n >= outLen) n = outLen - 1;
+  memcpy(out, p, n);
+  out[n] = '\0';
+}
+
+void JsonScan::unquote(const char* raw, char* out, size_t outLen) {
+  if (!outLen) return;
+  raw = skipWs(raw);
+  size_t n = 0;
+  if (*raw == '"') {
+    raw++;
+    while (*raw && *raw != '"' && n < outLen - 1) {
+      if (*raw == '\\' && raw[1]) raw++;
+      out[n++] = *raw++;
+    }
+  } else {
+    while (*raw && n < outLen - 1) out[n++] = *raw++;
+  }
+  out[n] = '\0';
+}
+
+bool JsonScan::find(const char* json, const char* path, char* out, size_t outLen) {
+  const char* p = skipWs(json);
+  while (*path == '/') path++;
+
+  while (*path) {
+    const char* seg = path;
+    const char* segEnd = strchr(seg, '/');
+    size_t segLen = segEnd ? (size_t)(segEnd - seg) : strlen(seg);
+
+    if (*p != '{') return false;
+    p = skipWs(p + 1);
+
+    bool found = false;
+    while (*p && *p != '}') {
+      if (*p != '"') return false;
+      const char* key = p + 1;
+      const char* keyEnd = skipString(p);
+      size_t keyLen = (size_t)(keyEnd - key) - 1;
+      p = skipWs(keyEnd);
+      if (*p != ':') return false;
+      p = skipWs(p + 1);
+
+      if (keyLen == segLen && strncmp(key, seg, segLen) == 0) { found = true; break; }
+
+      p = skipWs(skipValue(p));
+      if (*p == ',') p = skipWs(p + 1);
+    }
+    if (!found) return false;
+
+    path = segEnd ? segEnd + 1 : seg + segLen;
+  }
+
+  if (*p == '{' || *p == '[') return false;
+  copyScalar(p, out, outLen);
+  return true;
+}
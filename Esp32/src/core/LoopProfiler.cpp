@@ -0,0 +1,93 @@
+#include "core/LoopProfiler.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <esp_timer.h>
+uint64_t LoopProfiler::nowUs() { return (uint64_t)esp_timer_get_time(); }
+#else
+#include <chrono>
+uint64_t LoopProfiler::nowUs() {
+  using namespace std::chrono;
+  return (uint64_t)duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+void LoopProfiler::begin(const char* const* names, uint8_t count) {
+  _names = names;
+  _count = count < MAX_SECTIONS ? count : MAX_SECTIONS;
+  reset();
+}
+
+void LoopProfiler::reset() {
+  memset(_s, 0, sizeof(_s));
+  for (Section& s : _s) s.minUs = UINT32_MAX;
+}
+
+// faixas 0..3: 1 µs cada; depois, 4 faixas por oitava (2 bits após o MSB)
+uint8_t LoopProfiler::bucketOf(uint32_t us) {
+  if (us > MAX_US) us = MAX_US;
+  if (us < (1U << SUB_BITS)) return (uint8_t)us;
+  const uint8_t msb = 31 - __builtin_clz(us);
+  const uint8_t sub = (us >> (msb - SUB_BITS)) & ((1U << SUB_BITS) - 1);
+  return (uint8_t)(((msb - SUB_BITS + 1) << SUB_BITS) | sub);
+}
+
+uint32_t LoopProfiler::bucketTop(uint8_t b) {
+  if (b < (1U << SUB_BITS)) return b;
+  const uint8_t msb = (b >> SUB_BITS) + SUB_BITS - 1;
+  const uint32_t sub = b & ((1U << SUB_BITS) - 1);
+  const uint32_t low = ((1U << SUB_BITS) | sub) << (msb - SUB_BITS);
+  return low + (1U << (msb - SUB_BITS)) - 1;
+}
+
+void LoopProfiler::record(uint8_t id, uint32_t us) {
+  if (id >= _count) return;
+  Section& s = _s[id];
+  s.n++;
+  s.sumUs += us;
+  if (us < s.minUs) s.minUs = us;
+  if (us > s.maxUs) s.maxUs = us;
+  s.hist[bucketOf(us)]++;
+}
+
+uint32_t LoopProfiler::percentile(uint8_t id, uint16_t permille) const {
+  if (id >= _count || _s[id].n == 0) return 0;
+  const Section& s = _s[id];
+  // posição (1-based) da amostra no ranking, arredondada para cima
+  const uint32_t rank = (uint32_t)(((uint64_t)s.n * permille + 999) / 1000);
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < BUCKETS; b++) {
+    seen += s.hist[b];
+    if (seen >= rank && seen) {
+      const uint32_t top = bucketTop(b);
+      return top < s.maxUs ? top : s.maxUs;
+    }
+  }
+  return s.maxUs;
+}
+
+LoopProfiler::Summary LoopProfiler::summary(uint8_t id) const {
+  Summary r{};
+  if (id >= _count || _s[id].n == 0) return r;
+  const Section& s = _s[id];
+  r.n = s.n;
+  r.minUs = s.minUs;
+  r.avgUs = (uint32_t)(s.sumUs / s.n);
+  r.p50Us = percentile(id, 500);
+  r.p99Us = percentile(id, 990);
+  r.maxUs = s.maxUs;
+  return r;
+}
+
+size_t LoopProfiler::toJson(uint8_t id, char* out, size_t len) const {
+  const Summary r = summary(id);
+  int n = snprintf(out, len, "{\"n\":%lu,\"min\":%lu,\"avg\":%lu,\"p50\":%lu,\"p99\":%lu,\"max\":%lu}",
+                   (unsigned long)r.n, (unsigned long)r.minUs, (unsigned long)r.avgUs,
+                   (unsigned long)r.p50Us, (unsigned long)r.p99Us, (unsigned long)r.maxUs);
+  if (n <= 0 || (size_t)n >= len) {
+    if (len) out[0] = '\0';
+    return 0;
+  }
+  return (size_t)n;
+}
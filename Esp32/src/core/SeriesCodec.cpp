@@ -0,0 +1,191 @@
+#include "core/SeriesCodec.h"
+#include <math.h>
+#include <string.h>
+
+namespace {
+  const char B64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  // pior caso de uma amostra: 2 × ('1111' + 32 bits)
+  constexpr size_t MAX_SAMPLE_BITS = 72;
+
+  inline uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+  inline int64_t unzigzag(uint64_t z) { return (int64_t)(z >> 1) ^ -(int64_t)(z & 1); }
+
+  struct BitReader {
+    const uint8_t* buf;
+    size_t lenBits;
+    size_t pos;
+
+    bool get(uint8_t nbits, uint64_t& out) {
+      if (pos + nbits > lenBits) return false;
+      out = 0;
+      for (uint8_t i = 0; i < nbits; i++, pos++)
+        out = (out << 1) | ((buf[pos >> 3] >> (7 - (pos & 7))) & 1);
+      return true;
+    }
+
+    bool getBucketed(uint8_t firstWidth, int64_t& out) {
+      static const uint8_t widths[] = {0, 0, 12, 20, 32};
+      uint64_t bit;
+      uint8_t prefix = 0;
+      while (prefix < 4) {
+        if (!get(1, bit)) return false;
+        if (!bit) break;
+        prefix++;
+      }
+      if (prefix == 0) { out = 0; return true; }
+      uint8_t w = (prefix == 1) ? firstWidth : widths[prefix];
+      uint64_t z;
+      if (!get(w, z)) return false;
+      out = unzigzag(z);
+      return true;
+    }
+  };
+
+  int8_t b64Index(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+  }
+}
+
+namespace SeriesCodec {
+
+// ==== encoder ====
+void Encoder::put(uint64_t v, uint8_t nbits) {
+  for (int8_t i = nbits - 1; i >= 0; i--, _bits++) {
+    uint8_t& byte = _buf[_bits >> 3];
+    if ((_bits & 7) == 0) byte = 0;
+    if ((v >> i) & 1) byte |= (uint8_t)(0x80 >> (_bits & 7));
+  }
+}
+
+void Encoder::putBucketed(int64_t v, uint8_t firstWidth) {
+  if (v == 0) { put(0, 1); return; }
+  uint64_t z = zigzag(v);
+  if (z < (1ULL << firstWidth)) { put(0b10, 2);   put(z, firstWidth); }
+  else if (z < (1ULL << 12))    { put(0b110, 3);  put(z, 12); }
+  else if (z < (1ULL << 20))    { put(0b1110, 4); put(z, 20); }
+  else                          { put(0b1111, 4); put(z, 32); }
+}
+
+int32_t Encoder::quantize(float v) const {
+  float scale = 1.0f;
+  for (uint8_t i = 0; i < _decimals; i++) scale *= 10.0f;
+  return (int32_t)lroundf(v * scale);
+}
+
+void Encoder::begin(uint64_t t0Ms, float v0, uint8_t decimals) {
+  _bits = 0;
+  _decimals = decimals;
+  _t0 = _lastT = t0Ms;
+  _lastDelta = 0;
+  _lastQ = quantize(v0);
+  put(t0Ms & 0xFFFFFFFFFFFFULL, 48);
+  put(zigzag(_lastQ), 32);
+  _count = 1;
+}
+
+bool Encoder::append(uint64_t tMs, float v) {
+  if (_count == 0 || _count == 0xFF || tMs <= _lastT) return false;
+  if (_bits + MAX_SAMPLE_BITS > CAPACITY * 8) return false;
+
+  int64_t delta = (int64_t)(tMs - _lastT);
+  if (delta > 0xFFFFFFFFLL) return false;
+
+  if (_count == 1) put((uint64_t)delta, 32);
+  else putBucketed(delta - _lastDelta, 7);
+
+  int32_t q = quantize(v);
+  putBucketed((int64_t)q - _lastQ, 6);
+
+  _lastDelta = delta;
+  _lastT = tMs;
+  _lastQ = q;
+  _count++;
+  return true;
+}
+
+size_t Encoder::toBase64(char* out, size_t outLen) const {
+  uint8_t raw[3 + CAPACITY];
+  raw[0] = VERSION;
+  raw[1] = _decimals;
+  raw[2] = _count;
+  size_t n = (_bits + 7) / 8;
+  memcpy(raw + 3, _buf, n);
+  n += 3;
+
+  size_t need = ((n + 2) / 3) * 4;
+  if (outLen < need + 1) { if (outLen) out[0] = '\0'; return 0; }
+
+  size_t o = 0;
+  for (size_t i = 0; i < n; i += 3) {
+    uint32_t chunk = (uint32_t)raw[i] << 16;
+    if (i + 1 < n) chunk |= (uint32_t)raw[i + 1] << 8;
+    if (i + 2 < n) chunk |= raw[i + 2];
+    out[o++] = B64[(chunk >> 18) & 63];
+    out[o++] = B64[(chunk >> 12) & 63];
+    out[o++] = (i + 1 < n) ? B64[(chunk >> 6) & 63] : '=';
+    out[o++] = (i + 2 < n) ? B64[chunk & 63] : '=';
+  }
+  out[o] = '\0';
+  return o;
+}
+
+// ==== decoder ====
+size_t decodeBase64(const char* b64, uint64_t* tsOut, float* valuesOut, size_t max) {
+  uint8_t raw[3 + Encoder::CAPACITY + 3];
+  size_t n = 0;
+  uint32_t acc = 0;
+  uint8_t accBits = 0;
+  for (const char* p = b64; *p && *p != '='; p++) {
+    int8_t idx = b64Index(*p);
+    if (idx < 0) return 0;
+    acc = (acc << 6) | (uint32_t)idx;
+    accBits += 6;
+    if (accBits >= 8) {
+      accBits -= 8;
+      if (n >= sizeof(raw)) return 0;
+      raw[n++] = (uint8_t)(acc >> accBits);
+    }
+  }
+  if (n < 3 || raw[0] != VERSION) return 0;
+
+  const uint8_t decimals = raw[1];
+  const size_t count = raw[2];
+  float scale = 1.0f;
+  for (uint8_t i = 0; i < decimals; i++) scale *= 10.0f;
+
+  BitReader br{raw + 3, (n - 3) * 8, 0};
+  uint64_t t, z;
+  int64_t q, delta = 0, dod, dq;
+
+  if (count == 0 || max == 0) return 0;
+  if (!br.get(48, t) || !br.get(32, z)) return 0;
+  q = unzigzag(z);
+  tsOut[0] = t;
+  valuesOut[0] = q / scale;
+
+  size_t i = 1;
+  for (; i < count && i < max; i++) {
+    if (i == 1) {
+      uint64_t d;
+      if (!br.get(32, d)) break;
+      delta = (int64_t)d;
+    } else {
+      if (!br.getBucketed(7, dod)) break;
+      delta += dod;
+    }
+    if (!br.getBucketed(6, dq)) break;
+    t += (uint64_t)delta;
+    q += dq;
+    tsOut[i] = t;
+    valuesOut[i] = q / scale;
+  }
+  return i;
+}
+
+}
@@ -0,0 +1,122 @@
+#include "core/WindowStats.h"
+#include <math.h>
+#include <stdio.h>
+
+// ==== P² ====
+// marcadores nas posições desejadas para as n amostras já vistas
+void WindowStats::P2::init(const float* sorted, uint32_t n) {
+  const float last = (float)(n - 1);
+  _np[0] = 0.0f;
+  _np[1] = last * _p / 2.0f;
+  _np[2] = last * _p;
+  _np[3] = last * (1.0f + _p) / 2.0f;
+  _np[4] = last;
+  for (int i = 0; i < 5; i++) {
+    // estritamente crescentes, com lugar para os marcadores seguintes
+    int32_t pos = (int32_t)lroundf(_np[i]);
+    if (pos > (int32_t)n - 5 + i) pos = (int32_t)n - 5 + i;
+    if (i > 0 && pos <= _pos[i - 1]) pos = _pos[i - 1] + 1;
+    _pos[i] = pos;
+    _q[i] = sorted[pos];
+  }
+}
+
+void WindowStats::P2::add(float x) {
+  int k;
+  if (x < _q[0]) { _q[0] = x; k = 0; }
+  else if (x >= _q[4]) { _q[4] = x; k = 3; }
+  else { k = 0; while (x >= _q[k + 1]) k++; }
+
+  for (int i = k + 1; i < 5; i++) _pos[i]++;
+  const float dn[5] = {0.0f, _p / 2.0f, _p, (1.0f + _p) / 2.0f, 1.0f};
+  for (int i = 0; i < 5; i++) _np[i] += dn[i];
+
+  for (int i = 1; i <= 3; i++) {
+    const float d = _np[i] - _pos[i];
+    if ((d >= 1.0f && _pos[i + 1] - _pos[i] > 1) || (d <= -1.0f && _pos[i - 1] - _pos[i] < -1)) {
+      const int s = d > 0 ? 1 : -1;
+      const float qp = parabolic(i, s);
+      _q[i] = (_q[i - 1] < qp && qp < _q[i + 1]) ? qp : linear(i, s);
+      _pos[i] += s;
+    }
+  }
+}
+
+float WindowStats::P2::parabolic(int i, int d) const {
+  const float n0 = _pos[i - 1], n1 = _pos[i], n2 = _pos[i + 1];
+  return _q[i] + d / (n2 - n0) *
+         ((n1 - n0 + d) * (_q[i + 1] - _q[i]) / (n2 - n1) +
+          (n2 - n1 - d) * (_q[i] - _q[i - 1]) / (n1 - n0));
+}
+
+float WindowStats::P2::linear(int i, int d) const {
+  return _q[i] + d * (_q[i + d] - _q[i]) / (float)(_pos[i + d] - _pos[i]);
+}
+
+// ==== janela ====
+void WindowStats::add(float x) {
+  _n++;
+  const double delta = x - _mean;
+  _mean += delta / _n;
+  _m2 += delta * (x - _mean);
+  if (_n == 1 || x < _min) _min = x;
+  if (_n == 1 || x > _max) _max = x;
+
+  if (_n <= EXACT) {
+    int i = (int)_n - 1;
+    while (i > 0 && _sorted[i - 1] > x) { _sorted[i] = _sorted[i - 1]; i--; }
+    _sorted[i] = x;
+    return;
+  }
+  if (_n == EXACT + 1) {
+    _p5.init(_sorted, EXACT);
+    _p50.init(_sorted, EXACT);
+    _p95.init(_sorted, EXACT);
+  }
+  _p5.add(x);
+  _p50.add(x);
+  _p95.add(x);
+}
+
+// exato (interpolação entre amostras ordenadas) até EXACT amostras
+float WindowStats::quantile(float p) const {
+  if (_n == 0) return NAN;
+  if (_n > EXACT) return p <= 0.05f ? _p5.value() : (p >= 0.95f ? _p95.value() : _p50.value());
+  const float r = p * (_n - 1);
+  const uint32_t lo = (uint32_t)r;
+  if (lo + 1 >= _n) return _sorted[_n - 1];
+  return _sorted[lo] + (r - lo) * (_sorted[lo + 1] - _sorted[lo]);
+}
+
+void WindowStats::reset() {
+  _n = 0;
+  _mean = _m2 = 0.0;
+}
+
+WindowStats::Summary WindowStats::summary() const {
+  Summary s;
+  s.n = _n;
+  s.mean = _n ? (float)_mean : NAN;
+  s.stddev = _n > 1 ? (float)sqrt(_m2 / (_n - 1)) : 0.0f;
+  s.min = _n ? _min : NAN;
+  s.max = _n ? _max : NAN;
+  // P² pode sair um pouco da faixa observada nos extremos
+  s.p5 = fmaxf(quantile(0.05f), s.min);
+  s.p50 = quantile(0.50f);
+  s.p95 = fminf(quantile(0.95f), s.max);
+  return s;
+}
+
+size_t WindowStats::toJson(const Summary& s, char* out, size_t len, uint8_t decimals) {
+  const int d = decimals;
+  int n = snprintf(out, len,
+                   "{\"n\":%lu,\"avg\":%.*f,\"sd\":%.*f,\"min\":%.*f,\"max\":%.*f,"
+                   "\"p5\":%.*f,\"p50\":%.*f,\"p95\":%.*f}",
+                   (unsigned long)s.n, d, s.mean, d + 1, s.stddev, d, s.min, d, s.max,
+                   d, s.p5, d, s.p50, d, s.p95);
+  if (s.n == 0 || n <= 0 || (size_t)n >= len) {
+    if (len) out[0] = '\0';
+    return 0;
+  }
+  return (size_t)n;
+}
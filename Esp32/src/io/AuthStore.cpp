@@ -0,0 +1,42 @@
+#include "io/AuthStore.h"
+#include <Preferences.h>
+
+static const char* NVS_NS = "fbauth";
+
+static uint32_t userHash(const char* user) {
+    uint32_t h = 2166136261u;   // FNV-1a
+    for (const char* c = user; *c; c++) { h ^= (uint8_t)*c; h *= 16777619u; }
+    return h;
+}
+
+bool AuthStore::load(AuthToken& t, const char* user) {
+    t.clear();
+    Preferences p;
+    if (!p.begin(NVS_NS, true)) return false;
+    bool ok = p.getUInt("user", 0) == userHash(user) &&
+              p.getString("id", t.id, sizeof(t.id)) > 0 &&
+              p.getString("refresh", t.refresh, sizeof(t.refresh)) > 0;
+    t.expiresAt = ok ? p.getUInt("exp", 0) : 0;
+    p.end();
+    if (!ok) t.clear();
+    return ok;
+}
+
+bool AuthStore::save(const AuthToken& t, const char* user) {
+    Preferences p;
+    if (!p.begin(NVS_NS, false)) return false;
+    bool ok = p.putString("id", t.id) > 0 &&
+              p.putString("refresh", t.refresh) > 0 &&
+              p.putUInt("exp", t.expiresAt) > 0 &&
+              p.putUInt("user", userHash(user)) > 0;
+    p.end();
+    if (!ok) Serial.println("[Auth] Falha ao gravar token na NVS");
+    return ok;
+}
+
+void AuthStore::clear() {
+    Preferences p;
+    if (!p.begin(NVS_NS, false)) return;
+    p.clear();
+    p.end();
+}
@@ -0,0 +1,127 @@
+#include "io/BurstScheduler.h"
+#include <stdio.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_wifi.h>
+// troca só o modo de economia; a associação e os sockets continuam de pé
+void BurstScheduler::radioAwake(bool awake) {
+  esp_wifi_set_ps(awake ? WIFI_PS_NONE : WIFI_PS_MAX_MODEM);
+}
+#else
+void BurstScheduler::radioAwake(bool) {}
+#endif
+
+// ==== métricas ====
+// mA·ms × mV → mWh: ÷ 3.6e6 (ms/h) ÷ 1000 (mV/V)
+uint32_t BurstScheduler::Hour::mWh() const {
+  const uint64_t mAms = (uint64_t)awakeMs * RADIO_MA + (uint64_t)sleepMs * SLEEP_MA;
+  return (uint32_t)(mAms * SUPPLY_MV / 3600000000ULL);
+}
+
+uint16_t BurstScheduler::Hour::awakePermille() const {
+  const uint64_t total = (uint64_t)awakeMs + sleepMs;
+  return total ? (uint16_t)((uint64_t)awakeMs * 1000 / total) : 0;
+}
+
+void BurstScheduler::account(uint32_t now) {
+  const uint32_t dt = now - _markAt;
+  if (open()) _cur.awakeMs += dt;
+  else _cur.sleepMs += dt;
+  _markAt = now;
+  if (now - _hourAt >= HOUR_MS) {
+    _last = _cur;
+    _cur = Hour();
+    _hourAt = now;
+  }
+}
+
+// ==== janelas ====
+void BurstScheduler::begin(uint32_t now) {
+  _nextAt = now + PERIOD_MS;
+  _markAt = _hourAt = now;
+  _managed = _open = false;
+  radioAwake(true);
+}
+
+void BurstScheduler::setManaged(bool managed, uint32_t now) {
+  if (managed == _managed) return;
+  account(now);
+  _managed = managed;
+  _open = false;
+  radioAwake(!managed);
+}
+
+void BurstScheduler::openWindow(uint32_t now, bool periodic) {
+  account(now);
+  _open = true;
+  _openedAt = now;
+  if (periodic) _cur.windows++;
+  else _cur.urgent++;
+  radioAwake(true);
+}
+
+void BurstScheduler::closeWindow(uint32_t now) {
+  account(now);
+  _open = false;
+  radioAwake(false);
+}
+
+void BurstScheduler::tick(uint32_t now, bool urgent, bool busy) {
+  account(now);
+
+  // período corre mesmo sem gerenciar: o heartbeat segue o mesmo relógio
+  const bool due = (int32_t)(now - _nextAt) >= 0;
+  if (due) {
+    _nextAt += PERIOD_MS;
+    if ((int32_t)(now - _nextAt) >= 0) _nextAt = now + PERIOD_MS;  // atrasou: sem rajada
+    _periodicEdge = true;
+  }
+  if (!_managed) return;
+
+  if (due) {
+    if (_open) _openedAt = now;  // janela urgente vira a periódica
+    else openWindow(now, true);
+  } else if (!_open && urgent) {
+    openWindow(now, false);
+  }
+
+  if (_open) {
+    const uint32_t held = now - _openedAt;
+    if ((held >= MIN_OPEN_MS && !busy && !urgent) || held >= MAX_OPEN_MS) closeWindow(now);
+  }
+}
+
+bool BurstScheduler::periodicDue() {
+  const bool e = _periodicEdge;
+  _periodicEdge = false;
+  return e;
+}
+
+// ==== relatório ====
+// hora fechada quando houver; antes disso, a parcial (completa = 0)
+size_t BurstScheduler::toJson(char* out, size_t len) const {
+  const bool full = _last.awakeMs || _last.sleepMs;
+  const Hour& h = full ? _last : _cur;
+  int n = snprintf(out, len, "{\"completa\":%d,\"janelas\":%lu,\"urgentes\":%lu,\"on_ms\":%lu,\"on_pm\":%u,\"mwh\":%lu}",
+                   full ? 1 : 0, (unsigned long)h.windows, (unsigned long)h.urgent,
+                   (unsigned long)h.awakeMs, (unsigned)h.awakePermille(), (unsigned long)h.mWh());
+  if (n <= 0 || (size_t)n >= len) {
+    if (len) out[0] = '\0';
+    return 0;
+  }
+  return (size_t)n;
+}
+
+#ifdef ARDUINO
+void BurstScheduler::printStats() const {
+  for (const Hour* h : {&_last, &_cur}) {
+    Serial.printf("[Radio] %s: janelas=%lu urgentes=%lu acordado=%lums (%u‰) energia~%lumWh\n",
+                  h == &_last ? "ultima hora" : "hora atual", (unsigned long)h->windows,
+                  (unsigned long)h->urgent, (unsigned long)h->awakeMs, (unsigned)h->awakePermille(),
+                  (unsigned long)h->mWh());
+  }
+}
+#else
+void BurstScheduler::printStats() const {}
+#endif
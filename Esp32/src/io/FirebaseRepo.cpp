@@ -1,16 +1,22 @@
 #include "io/FirebaseRepo.h"
-#include <time.h>
+#include "core/RtdbPaths.h"
+#include "config/RootCA.h"
+#include "core/Clock.h"
 
 // ==== util epoch ms ====
-static uint64_t epoch_ms_safe() {
-  time_t s = time(nullptr);
-  if (s > 100000) return (uint64_t)s * 1000ULL;
-  return (uint64_t)millis();
-}
-uint64_t FirebaseRepo::epochMillisSafe() { return epoch_ms_safe(); }
+// 0 até o primeiro NTP: quem grava com timestamp descarta em vez de usar 1970
+uint64_t FirebaseRepo::epochMillisSafe() { return Clock::epochMillis(); }
+
+FirebaseRepo* FirebaseRepo::_instance = nullptr;
 
 // ==== callback padrão ====
 void FirebaseRepo::onAsync(AsyncResult& r) {
+  // confirmação/falha dos updates do escalonador
+  // 400/403 = conteúdo recusado (regra, caminhos sobrepostos), não a rede
+  if (_instance && RtdbScheduler::isBatchUid(r.uid().c_str(), "update") && (r.isError() || r.available())) {
+    const int code = r.isError() ? r.error().code() : 0;
+    _instance->_sched.onResult(r.uid().c_str(), !r.isError(), code == 400 || code == 403);
+  }
   if (r.isError()) {
     const int code = r.error().code();
     Serial.printf("[FB-Repo][%s] ERROR %d: %s\n",
@@ -33,6 +39,7 @@ void FirebaseRepo::begin(const char* apiKey,
   _dbUrl  = databaseUrl;
 
   if (insecureTLS) _ssl.setInsecure();
+  else _ssl.setCACert(FIREBASE_ROOT_CA);
 
   if (_auth) { delete _auth; _auth = nullptr; }
   _auth = new UserAuth(_apiKey.c_str(), _email.c_str(), _pass.c_str());
@@ -43,6 +50,18 @@ void FirebaseRepo::begin(const char* apiKey,
 
   _readyNotified = false;
   _feederReady   = false;
+
+  _instance = this;
+  _backlog.begin("/repo_q", "/repo_q.ack");
+
+  // nós de estado: só mudanças reais; instantâneos com zona morta
+  _shadow.attach(_sched); // descarte na fila → nó volta a sujo
+  _shadow.define(SH_RELAY_HEATER,    RtdbPaths::RELAY_HEATER,    Prio::CONTROL,   0.0f,  STATE_REFRESH_MS);
+  _shadow.define(SH_RELAY_WATERFALL, RtdbPaths::RELAY_WATERFALL, Prio::CONTROL,   0.0f,  STATE_REFRESH_MS);
+  _shadow.define(SH_WATER_OK,        RtdbPaths::WATER_OK,        Prio::SAFETY,    0.0f,  STATE_REFRESH_MS);
+  _shadow.define(SH_TEMP_CURRENT,    RtdbPaths::TEMP_CURRENT,    Prio::TELEMETRY, 0.05f, STATE_REFRESH_MS);
+  _shadow.define(SH_PH_CURRENT,      RtdbPaths::PH_CURRENT,      Prio::TELEMETRY, 0.02f, STATE_REFRESH_MS);
+  _shadow.define(SH_FEEDER_BUSY,     RtdbPaths::FEEDER_BUSY,     Prio::CONTROL,   0.0f,  STATE_REFRESH_MS);
 }
 
 void FirebaseRepo::handle() {
@@ -52,86 +71,158 @@ void FirebaseRepo::handle() {
     Serial.println("[FirebaseRepo] App autenticado e pronto.");
   }
   if (_app.ready() && !_feederReady) ensureFeederNodes();
+  if (_app.ready() && !_wasReady) _shadow.invalidate();   // reconectou: reenvia estados
+  _wasReady = _app.ready();
+  _shadow.refresh(_sched, millis());
+  flush();
+}
+
+// envia o que foi enfileirado desde o último handle(), por prioridade
+void FirebaseRepo::flush() {
+  const uint32_t now = millis();
+  _sched.checkTimeout(now);
+
+  // fila offline: só avança quando tudo o que foi drenado foi entregue
+  // (classe LOGS zerada) sem descarte no meio do caminho
+  if (_backlog.inFlight()) {
+    if (_sched.stats(Prio::LOGS).dropped != _backlogDropMark) _backlog.rollback();
+    else if (_sched.depth(Prio::LOGS) == 0) _backlog.commit();
+  }
+
+  if (!ready()) return;
+
+  if (_backlog.pending() && !_backlog.inFlight()) {
+    uint8_t room = _sched.room(Prio::LOGS);
+    _backlogDropMark = _sched.stats(Prio::LOGS).dropped;
+    _backlog.drainInto(_sched, Prio::LOGS, room < BACKLOG_DRAIN_MAX ? room : BACKLOG_DRAIN_MAX, now);
+  }
+
+  _sched.flush(_rtdb, _client, onAsync, "update", now);
 }
 
 bool FirebaseRepo::ready() { return _app.ready(); }
 
 // ==== estados ====
+// estados e instantâneos passam pelo espelho; offline só atualizam o
+// valor desejado, que sai quando o lote voltar a ser enviado
 void FirebaseRepo::setHeaterState(bool on) {
-  if (!ready()) return;
-  _rtdb.set<bool>(_client, "/aquario/relay/heater", on, onAsync, "relay_heater");
+  _shadow.publishBool(_sched, SH_RELAY_HEATER, on, millis());
 }
 
 void FirebaseRepo::setWaterfallState(bool on) {
-  if (!ready()) return;
-  _rtdb.set<bool>(_client, "/aquario/relay/waterfall", on, onAsync, "relay_waterfall");
+  _shadow.publishBool(_sched, SH_RELAY_WATERFALL, on, millis());
 }
 
 void FirebaseRepo::setWaterOk(bool ok) {
-  if (!ready()) return;
-  _rtdb.set<bool>(_client, "/aquario/float/water_ok", ok, onAsync, "water_ok");
+  _shadow.publishBool(_sched, SH_WATER_OK, ok, millis());
 }
 
 // ==== instantâneo ====
 void FirebaseRepo::setTempCurrent(float v){
-  if (!ready()) return;
-  _rtdb.set<float>(_client, "/aquario/temperatura_current", v, onAsync, "temp_cur");
+  _shadow.publishFloat(_sched, SH_TEMP_CURRENT, v, millis());
 }
 
 void FirebaseRepo::setPhCurrent(float v){
-  if (!ready()) return;
-  _rtdb.set<float>(_client, "/aquario/ph_current", v, onAsync, "ph_cur");
+  _shadow.publishFloat(_sched, SH_PH_CURRENT, v, millis());
 }
 
 // ==== modos / auditoria ====
-void FirebaseRepo::setMode(const String& actuator, const String& modeStr) {
-  if (!ready()) return;
-  String path = "/aquario/controle/" + actuator + "/mode";
-  _rtdb.set<String>(_client, path.c_str(), modeStr, onAsync, "mode");
-}
+// caminhos montados na pilha (PathBuf) a partir de RtdbPaths: nenhuma
+// alocação de heap por chamada
+using Path = PathBuf<RtdbScheduler::PATH_LEN>;
 
-void FirebaseRepo::logManualOverride(const String& actuator, bool value, const char* reason) {
+void FirebaseRepo::setMode(const char* actuator, const char* modeStr) {
   if (!ready()) return;
-  char key[24]; snprintf(key, sizeof(key), "%llu", (unsigned long long)epochMillisSafe());
-  String base = String("/aquario/controle/") + actuator + "/logs/" + key;
+  Path path(RtdbPaths::CONTROLE_PREFIX);
+  path.add(actuator).add("/mode");
+  _sched.setString(path.c_str(), modeStr, Prio::CONTROL);
+}
 
-  _rtdb.set<String>(_client, (base + "/origin").c_str(), "manual", onAsync);
-  _rtdb.set<bool  >(_client, (base + "/value").c_str(),  value, onAsync);
-  _rtdb.set<String>(_client, (base + "/reason").c_str(), String(reason), onAsync);
+void FirebaseRepo::logManualOverride(const char* actuator, bool value, const char* reason) {
+  const uint64_t ts = epochMillisSafe();
+  if (!ts) return;
+  Path p(RtdbPaths::CONTROLE_PREFIX);
+  p.add(actuator).add("/logs/").addU64(ts);
+  const size_t key = p.length();
+
+  if (!ready()) {
+    _backlog.push(p.add("/origin").c_str(), "\"manual\"");
+    _backlog.push(p.truncate(key).add("/value").c_str(), value ? "true" : "false");
+    _backlog.pushString(p.truncate(key).add("/reason").c_str(), reason);
+    return;
+  }
+  _sched.setString(p.add("/origin").c_str(), "manual", Prio::LOGS);
+  _sched.setBool  (p.truncate(key).add("/value").c_str(), value, Prio::LOGS);
+  _sched.setString(p.truncate(key).add("/reason").c_str(), reason, Prio::LOGS);
 }
 
 void FirebaseRepo::logHeaterDecision(float tC, bool newState, float onThr, float offThr, const char* reason) {
-  if (!ready()) return;
-  char key[24]; snprintf(key, sizeof(key), "%llu", (unsigned long long)epochMillisSafe());
-  String base = String("/aquario/controle/heater/logs/") + key;
+  const uint64_t ts = epochMillisSafe();
+  if (!ts) return;
+  Path p(RtdbPaths::HEATER_LOGS);
+  p.addU64(ts);
+  const size_t key = p.length();
+
+  if (!ready()) {
+    _backlog.pushFloat(p.add("/temp").c_str(), tC);
+    _backlog.push     (p.truncate(key).add("/state").c_str(), newState ? "true" : "false");
+    _backlog.pushFloat(p.truncate(key).add("/on_thr").c_str(), onThr);
+    _backlog.pushFloat(p.truncate(key).add("/off_thr").c_str(), offThr);
+    _backlog.pushString(p.truncate(key).add("/reason").c_str(), reason);
+    return;
+  }
 
-  _rtdb.set<float>(_client, (base + "/temp").c_str(), tC, onAsync, "heater_temp");
-  _rtdb.set<bool >(_client, (base + "/state").c_str(), newState, onAsync, "heater_state");
-  _rtdb.set<float>(_client, (base + "/on_thr").c_str(), onThr, onAsync, "heater_on");
-  _rtdb.set<float>(_client, (base + "/off_thr").c_str(), offThr, onAsync, "heater_off");
-  _rtdb.set<String>(_client, (base + "/reason").c_str(), String(reason), onAsync, "heater_reason");
+  _sched.setFloat (p.add("/temp").c_str(), tC, Prio::LOGS);
+  _sched.setBool  (p.truncate(key).add("/state").c_str(), newState, Prio::LOGS);
+  _sched.setFloat (p.truncate(key).add("/on_thr").c_str(), onThr, Prio::LOGS);
+  _sched.setFloat (p.truncate(key).add("/off_thr").c_str(), offThr, Prio::LOGS);
+  _sched.setString(p.truncate(key).add("/reason").c_str(), reason, Prio::LOGS);
 }
 
 // ==== heartbeat ====
 void FirebaseRepo::publishLastSeen() {
-  if (!ready()) return;
-  _rtdb.set<uint64_t>(_client, "/aquario/status/last_seen",
-                      epochMillisSafe(), onAsync, "last_seen");
+  const uint64_t ts = epochMillisSafe();
+  if (!ready() || !ts) return;
+  _sched.setU64(RtdbPaths::LAST_SEEN, ts);
 }
 
 // ==== séries ====
+// um nó por hora em /aquario/series/<nome>/<t0> (chunk compactado, base64).
+// Offline o chunk só cresce na RAM e vai para o backlog uma vez, ao fechar
+// (ou sai ao vivo na próxima amostra com a rede de pé)
+void FirebaseRepo::appendSeries(Series& s, const char* name, float v) {
+  const uint64_t HOUR_MS = 3600000ULL;
+  const uint64_t ts = epochMillisSafe();
+  if (!ts) return;
+  const bool live = ready();
+  bool sameHour = !s.enc.empty() && (ts / HOUR_MS) == (s.enc.startMs() / HOUR_MS);
+  if (!sameHour || !s.enc.append(ts, v)) {
+    if (s.unsent) writeChunk(s.enc, name, live);
+    s.enc.begin(ts, v, 2);
+  }
+  s.unsent = !live;
+  if (live) writeChunk(s.enc, name, true);
+}
+
+void FirebaseRepo::writeChunk(const SeriesCodec::Encoder& enc, const char* name, bool live) {
+  Path path(RtdbPaths::SERIES);
+  path.add(name).add('/').addU64(enc.startMs());
+  char chunk[RtdbScheduler::VALUE_LEN];
+  chunk[0] = '"';
+  size_t n = enc.toBase64(chunk + 1, sizeof(chunk) - 2);
+  chunk[n + 1] = '"';
+  chunk[n + 2] = '\0';
+
+  if (live) _sched.setRaw(path.c_str(), chunk);
+  else _backlog.push(path.c_str(), chunk);
+}
+
 void FirebaseRepo::pushTempAvg(float avgC) {
-  if (!ready()) return;
-  String key = String((uint64_t)epochMillisSafe());
-  String path = "/aquario/temperatura/" + key;
-  _rtdb.set<float>(_client, path.c_str(), avgC, onAsync, "avg_temp");
+  appendSeries(_tempSeries, "temperatura", avgC);
 }
 
 void FirebaseRepo::pushPHAvg(float avgPH) {
-  if (!ready()) return;
-  String key = String((uint64_t)epochMillisSafe());
-  String path = "/aquario/ph/" + key;
-  _rtdb.set<float>(_client, path.c_str(), avgPH, onAsync, "avg_ph");
+  appendSeries(_phSeries, "ph", avgPH);
 }
 
 // ==== feeder ====
@@ -139,15 +230,15 @@ void FirebaseRepo::ensureFeederNodes() {
   if (!ready() || _feederReady) return;
 
   // feeder edge
-  _rtdb.set<bool>(_client, "/aquario/controle/feeder/feed_now", false, onAsync, "feed_now");
+  _sched.setBool(RtdbPaths::FEED_NOW, false, Prio::CONTROL);
 
   // comandos edge
-  _rtdb.set<bool>(_client, "/aquario/controle/heater/turn_on_now", false, onAsync, "heater_ton");
-  _rtdb.set<bool>(_client, "/aquario/controle/waterfall/turn_on_now", false, onAsync, "wf_ton");
+  _sched.setBool(RtdbPaths::HEATER_ON_NOW, false, Prio::CONTROL);
+  _sched.setBool(RtdbPaths::WATERFALL_ON_NOW, false, Prio::CONTROL);
 
   // status feeder
-  _rtdb.set<bool>(_client, "/aquario/status/feeder/busy", false, onAsync, "feeder_busy");
-  _rtdb.set<uint64_t>(_client, "/aquario/status/feeder/last_ts", 0, onAsync, "feeder_last_ts");
+  _sched.setBool(RtdbPaths::FEEDER_BUSY, false, Prio::CONTROL);
+  _sched.setU64(RtdbPaths::FEEDER_LAST_TS, 0, Prio::CONTROL);
 
   _feederReady = true;
   Serial.println("[FirebaseRepo] Nós do feeder/commands garantidos.");
@@ -156,9 +247,9 @@ void FirebaseRepo::ensureFeederNodes() {
 bool FirebaseRepo::pollFeedNowAndReset() {
   if (!ready()) return false;
   bool want = false;
-  want = _rtdb.get<bool>(_client, "/aquario/controle/feeder/feed_now");
+  want = _rtdb.get<bool>(_client, RtdbPaths::FEED_NOW);
   if (want) {
-    _rtdb.set<bool>(_client, "/aquario/controle/feeder/feed_now", false, onAsync, "feed_reset");
+    _sched.setBool(RtdbPaths::FEED_NOW, false, Prio::CONTROL);
     return true;
   }
   return false;
@@ -166,9 +257,9 @@ bool FirebaseRepo::pollFeedNowAndReset() {
 
 bool FirebaseRepo::pollHeaterTurnOnNowEdge() {
   if (!ready()) return false;
-  bool want = _rtdb.get<bool>(_client, "/aquario/controle/heater/turn_on_now");
+  bool want = _rtdb.get<bool>(_client, RtdbPaths::HEATER_ON_NOW);
   if (want) {
-    _rtdb.set<bool>(_client, "/aquario/controle/heater/turn_on_now", false, onAsync, "heater_ton_rst");
+    _sched.setBool(RtdbPaths::HEATER_ON_NOW, false, Prio::CONTROL);
     return true;
   }
   return false;
@@ -176,20 +267,19 @@ bool FirebaseRepo::pollHeaterTurnOnNowEdge() {
 
 bool FirebaseRepo::pollWaterfallTurnOnNowEdge() {
   if (!ready()) return false;
-  bool want = _rtdb.get<bool>(_client, "/aquario/controle/waterfall/turn_on_now");
+  bool want = _rtdb.get<bool>(_client, RtdbPaths::WATERFALL_ON_NOW);
   if (want) {
-    _rtdb.set<bool>(_client, "/aquario/controle/waterfall/turn_on_now", false, onAsync, "wf_ton_rst");
+    _sched.setBool(RtdbPaths::WATERFALL_ON_NOW, false, Prio::CONTROL);
     return true;
   }
   return false;
 }
 
 void FirebaseRepo::setFeederBusy(bool busy) {
-  if (!ready()) return;
-  _rtdb.set<bool>(_client, "/aquario/status/feeder/busy", busy, onAsync, "feeder_busy_set");
+  _shadow.publishBool(_sched, SH_FEEDER_BUSY, busy, millis());
 }
 
 void FirebaseRepo::setFeederLastTs(uint64_t epochMs) {
   if (!ready()) return;
-  _rtdb.set<uint64_t>(_client, "/aquario/status/feeder/last_ts", epochMs, onAsync, "feeder_last_ts_set");
+  _sched.setU64(RtdbPaths::FEEDER_LAST_TS, epochMs, Prio::CONTROL);
 }
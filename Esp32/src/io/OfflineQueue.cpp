@@ -0,0 +1,243 @@
+#include "io/OfflineQueue.h"
+#include <LittleFS.h>
+#include <math.h>
+#include <stddef.h>
+
+// FNV-1a sobre o registro (sem o campo crc): detecta registro rasgado por queda de energia
+uint32_t OfflineQueue::checksum(const Record& r) {
+    const uint8_t* p = (const uint8_t*)&r;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(Record, crc); i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// anéis pré-alocados da versão anterior (escrita no meio do arquivo)
+static const char* const LEGACY_RINGS[] = {"/backlog.bin", "/repo_q.bin"};
+
+void OfflineQueue::segmentPath(uint32_t seg, char* out, size_t len) const {
+    snprintf(out, len, "%s/%lu", _dir, (unsigned long)seg);
+}
+
+// Conta os registros íntegros e em sequência do segmento; se sobrar um
+// resto (acréscimo rasgado), regrava só o prefixo bom num temporário
+uint32_t OfflineQueue::repairSegment(uint32_t seg) {
+    char path[32];
+    segmentPath(seg, path, sizeof(path));
+    File f = LittleFS.open(path, "r");
+    if (!f) return 0;
+
+    const size_t size = f.size();
+    uint32_t count = 0;
+    Record r;
+    while (count < SEG_RECORDS && f.read((uint8_t*)&r, sizeof(r)) == sizeof(r)) {
+        if (r.seq != seg * SEG_RECORDS + count + 1 || r.crc != checksum(r)) break;
+        count++;
+    }
+    if (size == count * sizeof(Record)) {
+        f.close();
+        return count;
+    }
+
+    char tmp[36];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    File t = LittleFS.open(tmp, "w");
+    f.seek(0);
+    for (uint32_t i = 0; t && i < count; i++) {
+        f.read((uint8_t*)&r, sizeof(r));
+        t.write((const uint8_t*)&r, sizeof(r));
+    }
+    f.close();
+    if (t) t.close();
+    LittleFS.remove(path);
+    if (count) LittleFS.rename(tmp, path);
+    else LittleFS.remove(tmp);
+    Serial.printf("[Backlog] Segmento %lu recortado: %lu registro(s) integro(s)\n",
+                  (unsigned long)seg, (unsigned long)count);
+    return count;
+}
+
+// apaga os segmentos inteiramente confirmados (até `seq`)
+void OfflineQueue::dropSegmentsUpTo(uint32_t seq) {
+    char path[32];
+    while (_firstSeg < seq / SEG_RECORDS) {
+        segmentPath(_firstSeg++, path, sizeof(path));
+        LittleFS.remove(path);
+    }
+}
+
+// ==== inicialização / recuperação ====
+bool OfflineQueue::begin(const char* dir, const char* ackFile) {
+    strncpy(_dir, dir, sizeof(_dir) - 1);
+    strncpy(_ackFile, ackFile, sizeof(_ackFile) - 1);
+
+    if (!LittleFS.begin(true)) {
+        Serial.println("[Backlog] LittleFS indisponível");
+        return _ok = false;
+    }
+    for (const char* legacy : LEGACY_RINGS)
+        if (LittleFS.exists(legacy)) LittleFS.remove(legacy);
+    if (!LittleFS.exists(_dir) && !LittleFS.mkdir(_dir)) return _ok = false;
+
+    // segmentos presentes: nome = número do segmento
+    bool any = false;
+    uint32_t minSeg = UINT32_MAX, maxSeg = 0;
+    File d = LittleFS.open(_dir);
+    if (!d) return _ok = false;
+    for (File f = d.openNextFile(); f; f = d.openNextFile()) {
+        const char* name = f.name();
+        const char* slash = strrchr(name, '/');
+        if (slash) name = slash + 1;
+        char* end;
+        const uint32_t seg = strtoul(name, &end, 10);
+        if (end == name || *end) continue;   // .tmp de um recorte interrompido
+        any = true;
+        if (seg < minSeg) minSeg = seg;
+        if (seg > maxSeg) maxSeg = seg;
+    }
+    d.close();
+
+    _ackedSeq = 0;
+    File a = LittleFS.open(_ackFile, "r");
+    if (a) {
+        a.read((uint8_t*)&_ackedSeq, sizeof(_ackedSeq));
+        a.close();
+    }
+
+    if (!any) {
+        // nada guardado: recomeça no início de um segmento
+        _headSeq = _ackedSeq = (_ackedSeq + SEG_RECORDS - 1) / SEG_RECORDS * SEG_RECORDS;
+        _firstSeg = _headSeq / SEG_RECORDS;
+    } else {
+        _headSeq = maxSeg * SEG_RECORDS + repairSegment(maxSeg);
+        if (_ackedSeq < minSeg * SEG_RECORDS) _ackedSeq = minSeg * SEG_RECORDS;
+        if (_ackedSeq > _headSeq) _ackedSeq = _headSeq;
+        _firstSeg = minSeg;
+        dropSegmentsUpTo(_ackedSeq);   // queda entre o ack e o remove
+    }
+
+    _inflightSeq = 0;
+    _ok = true;
+    Serial.printf("[Backlog] %s: %lu registro(s) pendente(s)\n", _dir, (unsigned long)pending());
+    return true;
+}
+
+// ==== escrita ====
+bool OfflineQueue::push(const char* path, const char* rawJson) {
+    if (!_ok) return false;
+    if (!*path || strlen(path) >= PATH_LEN || strlen(rawJson) >= VALUE_LEN) return false;
+
+    Record r;
+    memset(&r, 0, sizeof(r));
+    r.seq = _headSeq + 1;
+    strcpy(r.path, path);
+    strcpy(r.value, rawJson);
+    r.crc = checksum(r);
+
+    // cheio: descarta o segmento mais antigo inteiro antes de abrir outro
+    const uint32_t seg = segmentOf(r.seq);
+    if (seg - segmentOf(_ackedSeq + 1) >= MAX_SEGMENTS) {
+        _ackedSeq = (segmentOf(_ackedSeq + 1) + 1) * SEG_RECORDS;
+        if (_inflightSeq && _inflightSeq <= _ackedSeq) _inflightSeq = 0;
+        dropSegmentsUpTo(_ackedSeq);
+    }
+
+    char file[32];
+    segmentPath(seg, file, sizeof(file));
+    File f = LittleFS.open(file, "a");
+    if (!f) return false;
+    const bool wrote = f.write((const uint8_t*)&r, sizeof(r)) == sizeof(r);
+    f.close();
+    if (!wrote) {
+        repairSegment(seg);   // não deixa meio registro desalinhar os próximos
+        return false;
+    }
+
+    _headSeq = r.seq;
+    return true;
+}
+
+bool OfflineQueue::pushFloat(const char* path, float v, uint8_t decimals) {
+    char buf[24];
+    if (!isfinite(v)) return false;
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, (double)v);
+    return push(path, buf);
+}
+
+bool OfflineQueue::pushU64(const char* path, uint64_t v) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%llu", (unsigned long long)v);
+    return push(path, buf);
+}
+
+bool OfflineQueue::pushString(const char* path, const char* v) {
+    char buf[VALUE_LEN];
+    RtdbScheduler::quote(v, buf, sizeof(buf));
+    return push(path, buf);
+}
+
+// ==== drenagem ====
+uint8_t OfflineQueue::drainInto(RtdbScheduler& sched, RtdbScheduler::Prio prio, uint8_t max, uint32_t now) {
+    if (!_ok || inFlight() || pending() == 0) return 0;
+
+    uint8_t n = 0;
+    uint32_t seq = _ackedSeq;
+    uint32_t openSeg = UINT32_MAX;
+    File f;
+    Record r;
+    while (n < max && seq < _headSeq) {
+        seq++;
+        const uint32_t seg = segmentOf(seq);
+        if (seg != openSeg) {
+            if (f) f.close();
+            char file[32];
+            segmentPath(seg, file, sizeof(file));
+            f = LittleFS.open(file, "r");
+            openSeg = seg;
+        }
+        // registro corrompido é pulado (não trava a fila)
+        const bool got = f && f.seek(((seq - 1) % SEG_RECORDS) * sizeof(Record)) &&
+                         f.read((uint8_t*)&r, sizeof(r)) == sizeof(r) && r.seq == seq && r.crc == checksum(r);
+        if (!got) continue;
+        if (!sched.setRaw(r.path, r.value, prio)) { seq--; break; }
+        n++;
+    }
+    if (f) f.close();
+
+    if (n == 0 && seq > _ackedSeq) {
+        // só havia registros inválidos: descarta sem ir à rede
+        _ackedSeq = seq;
+        saveAck();
+        dropSegmentsUpTo(_ackedSeq);
+    } else if (n > 0) {
+        _inflightSeq = seq;
+        _inflightAt = now;
+    }
+    return n;
+}
+
+void OfflineQueue::commit() {
+    if (!inFlight()) return;
+    _ackedSeq = _inflightSeq;
+    _inflightSeq = 0;
+    saveAck();
+    dropSegmentsUpTo(_ackedSeq);
+    if (pending() == 0) Serial.println("[Backlog] Fila offline drenada");
+}
+
+void OfflineQueue::rollback() {
+    _inflightSeq = 0;
+}
+
+void OfflineQueue::checkTimeout(uint32_t now) {
+    if (inFlight() && now - _inflightAt >= INFLIGHT_TIMEOUT_MS) rollback();
+}
+
+void OfflineQueue::saveAck() {
+    File a = LittleFS.open(_ackFile, "w");
+    if (!a) return;
+    a.write((const uint8_t*)&_ackedSeq, sizeof(_ackedSeq));
+    a.close();
+}
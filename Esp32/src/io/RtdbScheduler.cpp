@@ -0,0 +1,347 @@
+#include "io/RtdbScheduler.h"
+#include "core/RtdbPaths.h"
+#include <math.h>
+
+// sufixos dinâmicos mais longos: "<ts 13>/<campo>" e "<nome>/<t0 13>"
+static_assert(RtdbPaths::MAX_LEN + 24 < RtdbScheduler::PATH_LEN,
+              "PATH_LEN não comporta os caminhos de RtdbPaths");
+
+// cota máxima (pendentes + em voo) por classe; SAFETY pode usar o pool todo
+static const uint8_t CLASS_CAP[] = {
+    RtdbScheduler::MAX_ENTRIES,   // SAFETY
+    16,                           // CONTROL (init dos nós = 10 de uma vez)
+    12,                           // TELEMETRY
+    16,                           // LOGS
+};
+
+static const char* const CLASS_NAME[] = {"safety", "control", "telemetry", "logs"};
+
+// ==== pool ====
+int8_t RtdbScheduler::oldestPending(Prio p) const {
+    int8_t best = -1;
+    for (uint8_t i = 0; i < MAX_ENTRIES; i++) {
+        const Entry& e = _entries[i];
+        if (e.state != State::PENDING || e.prio != p) continue;
+        if (best < 0 || (int32_t)(e.queuedAt - _entries[best].queuedAt) < 0) best = i;
+    }
+    return best;
+}
+
+void RtdbScheduler::release(Entry& e) {
+    _stats[(uint8_t)e.prio].depth--;
+    e.state = State::FREE;
+}
+
+// descarte de uma pendente para abrir espaço: conta e avisa o espelho
+void RtdbScheduler::evict(Entry& e) {
+    _stats[(uint8_t)e.prio].dropped++;
+    release(e);
+    if (_dropHook) _dropHook(_dropCtx, e.path);
+}
+
+uint8_t RtdbScheduler::room(Prio p) const {
+    uint8_t free = 0;
+    for (const Entry& e : _entries)
+        if (e.state == State::FREE) free++;
+    if (p != Prio::SAFETY) free = free > SAFETY_RESERVE ? free - SAFETY_RESERVE : 0;
+    uint8_t cap = CLASS_CAP[(uint8_t)p];
+    uint8_t d = _stats[(uint8_t)p].depth;
+    uint8_t quota = d >= cap ? 0 : cap - d;
+    return quota < free ? quota : free;
+}
+
+bool RtdbScheduler::hasPending() const {
+    for (const Entry& e : _entries)
+        if (e.state == State::PENDING) return true;
+    return false;
+}
+
+bool RtdbScheduler::put(const char* path, const char* rawJson, Prio p) {
+    // chaves do update multi-caminho são relativas à raiz (sem '/')
+    while (*path == '/') path++;
+    if (!*path || strlen(path) >= PATH_LEN || strlen(rawJson) >= VALUE_LEN) {
+        Serial.printf("[FB-Sched] entrada grande demais: %s\n", path);
+        return false;
+    }
+    ClassStats& st = _stats[(uint8_t)p];
+
+    // merge: mesmo caminho ainda pendente → último valor vence
+    for (Entry& e : _entries) {
+        if (e.state == State::PENDING && strcmp(e.path, path) == 0) {
+            strcpy(e.value, rawJson);
+            if (p < e.prio) {
+                _stats[(uint8_t)e.prio].depth--;
+                e.prio = p;
+                st.depth++;
+            }
+            st.merged++;
+            return true;
+        }
+    }
+
+    // cota da classe estourada → descarta a pendente mais antiga dela
+    if (st.depth >= CLASS_CAP[(uint8_t)p]) {
+        int8_t victim = oldestPending(p);
+        if (victim < 0) { st.dropped++; return false; }
+        evict(_entries[victim]);
+    }
+
+    // as últimas SAFETY_RESERVE posições livres ficam para SAFETY, para que
+    // um pool todo em voo não barre um alarme
+    Entry* slot = nullptr;
+    uint8_t free = 0;
+    for (Entry& e : _entries) {
+        if (e.state != State::FREE) continue;
+        if (!slot) slot = &e;
+        free++;
+    }
+    if (p != Prio::SAFETY && free <= SAFETY_RESERVE) slot = nullptr;
+
+    // pool cheio → despeja a mais antiga de uma classe inferior
+    if (!slot) {
+        for (int8_t c = (int8_t)Prio::LOGS; c > (int8_t)p && !slot; c--) {
+            int8_t victim = oldestPending((Prio)c);
+            if (victim < 0) continue;
+            evict(_entries[victim]);
+            slot = &_entries[victim];
+        }
+    }
+    if (!slot) {
+        st.dropped++;
+        Serial.printf("[FB-Sched] fila cheia, descartando %s\n", path);
+        return false;
+    }
+
+    strcpy(slot->path, path);
+    strcpy(slot->value, rawJson);
+    slot->state = State::PENDING;
+    slot->prio = p;
+    slot->rejects = knownBad(path) ? 1 : 0;   // já recusado antes: vai direto para o solo
+    slot->queuedAt = millis();
+    st.enqueued++;
+    st.depth++;
+    if (st.depth > st.maxDepth) st.maxDepth = st.depth;
+    return true;
+}
+
+bool RtdbScheduler::setBool(const char* path, bool v, Prio p) {
+    return put(path, v ? "true" : "false", p);
+}
+
+bool RtdbScheduler::setInt(const char* path, long v, Prio p) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%ld", v);
+    return put(path, buf, p);
+}
+
+bool RtdbScheduler::setU64(const char* path, uint64_t v, Prio p) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%llu", (unsigned long long)v);
+    return put(path, buf, p);
+}
+
+bool RtdbScheduler::setFloat(const char* path, float v, Prio p, uint8_t decimals) {
+    // JSON não tem NaN/Inf
+    if (!isfinite(v)) return put(path, "null", p);
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, (double)v);
+    return put(path, buf, p);
+}
+
+// string JSON entre aspas, com '"' e '\\' escapados; corta no fim do buffer
+size_t RtdbScheduler::quote(const char* v, char* out, size_t len) {
+    size_t n = 0;
+    out[n++] = '"';
+    for (const char* c = v; *c && n < len - 3; c++) {
+        if (*c == '"' || *c == '\\') out[n++] = '\\';
+        out[n++] = *c;
+    }
+    out[n++] = '"';
+    out[n] = '\0';
+    return n;
+}
+
+bool RtdbScheduler::setString(const char* path, const char* v, Prio p) {
+    char buf[VALUE_LEN];
+    quote(v, buf, sizeof(buf));
+    return put(path, buf, p);
+}
+
+bool RtdbScheduler::setRaw(const char* path, const char* rawJson, Prio p) {
+    return put(path, rawJson, p);
+}
+
+// ==== envio ====
+// suspeita mais prioritária (e mais antiga) pronta para um lote solo
+int8_t RtdbScheduler::nextSuspect(bool safetyOnly) const {
+    int8_t best = -1;
+    for (uint8_t i = 0; i < MAX_ENTRIES; i++) {
+        const Entry& e = _entries[i];
+        if (e.state != State::PENDING || !e.rejects) continue;
+        if (safetyOnly && e.prio != Prio::SAFETY) continue;
+        if (best < 0) { best = i; continue; }
+        const Entry& b = _entries[best];
+        if (e.prio < b.prio || (e.prio == b.prio && (int32_t)(e.queuedAt - b.queuedAt) < 0)) best = i;
+    }
+    return best;
+}
+
+void RtdbScheduler::take(Entry& e, uint32_t gen, uint32_t now) {
+    if (_json.length() > 1) _json += ',';
+    _json += '"';
+    _json += e.path;
+    _json += "\":";
+    _json += e.value;
+
+    ClassStats& st = _stats[(uint8_t)e.prio];
+    uint32_t wait = now - e.queuedAt;
+    st.waitTotalMs += wait;
+    if (wait > st.waitMaxMs) st.waitMaxMs = wait;
+    e.state = State::INFLIGHT;
+    e.gen = gen;
+    e.sentAt = now;
+}
+
+bool RtdbScheduler::flush(RealtimeDatabase& db, AsyncClientClass& client,
+                          AsyncResultCallback cb, const char* uid, uint32_t now) {
+    const bool saturated = _inflight >= MAX_INFLIGHT;
+    const uint32_t gen = _gen + 1 ? _gen + 1 : 1;   // 0 = nenhum lote
+    uint8_t n = 0;
+
+    // capacidade reservada uma vez: os próximos flushes reaproveitam o buffer
+    _json.reserve((size_t)MAX_PER_UPDATE * (PATH_LEN + VALUE_LEN + 4) + 2);
+    _json = "{";
+
+    // suspeita sai sozinha na vez dela, mas nunca na frente de SAFETY limpa
+    const int8_t suspect = nextSuspect(saturated);
+    bool cleanSafety = false;
+    for (const Entry& e : _entries)
+        if (e.state == State::PENDING && !e.rejects && e.prio == Prio::SAFETY) { cleanSafety = true; break; }
+    bool solo = suspect >= 0 && _soloTurn &&
+                (!cleanSafety || _entries[suspect].prio == Prio::SAFETY);
+
+    for (uint8_t c = 0; !solo && c < (uint8_t)Prio::COUNT && n < MAX_PER_UPDATE; c++) {
+        // link saturado: só segurança passa na frente
+        if (saturated && c != (uint8_t)Prio::SAFETY) break;
+        for (Entry& e : _entries) {
+            if (n >= MAX_PER_UPDATE) break;
+            if (e.state != State::PENDING || (uint8_t)e.prio != c || e.rejects) continue;
+            take(e, gen, now);
+            n++;
+        }
+    }
+    if (n == 0 && suspect >= 0) solo = true;
+    if (solo) {
+        take(_entries[suspect], gen, now);
+        n = 1;
+    }
+    _soloTurn = !solo && suspect >= 0;
+    if (n == 0) return false;
+    _json += '}';
+
+    _gen = gen;
+    _inflight++;
+    snprintf(_uid, sizeof(_uid), "%s#%lu", uid, (unsigned long)gen);
+    db.update<object_t>(client, "/", object_t(_json), cb, _uid);
+    return true;
+}
+
+bool RtdbScheduler::isBatchUid(const char* uid, const char* prefix) {
+    const size_t n = strlen(prefix);
+    return strncmp(uid, prefix, n) == 0 && uid[n] == '#';
+}
+
+// valor mais novo do mesmo caminho: pendente ou já em voo num lote posterior
+// (reenfileirar este o mandaria depois e sobrescreveria o novo no RTDB)
+bool RtdbScheduler::superseded(const Entry& e) const {
+    for (const Entry& o : _entries) {
+        if (&o == &e || strcmp(o.path, e.path) != 0) continue;
+        if (o.state == State::PENDING) return true;
+        if (o.state == State::INFLIGHT && (int32_t)(o.gen - e.gen) > 0) return true;
+    }
+    return false;
+}
+
+// fecha o lote `gen`; false se nenhuma entrada dele está em voo
+bool RtdbScheduler::settle(uint32_t gen, bool ok, bool rejected) {
+    bool found = false;
+    for (Entry& e : _entries) {
+        if (e.state != State::INFLIGHT || e.gen != gen) continue;
+        found = true;
+        ClassStats& st = _stats[(uint8_t)e.prio];
+        if (ok) {
+            st.sent++;
+            if (e.rejects) forgetBad(e.path);   // regra mudou: caminho aceito
+            release(e);
+            continue;
+        }
+        st.failed++;
+        // já existe valor mais novo para o caminho → este morre
+        if (superseded(e)) {
+            release(e);
+            continue;
+        }
+        // recusa (não rede): suspeita; sozinha e recusada de novo → descarta
+        if (rejected && ++e.rejects >= MAX_REJECTS) {
+            Serial.printf("[FB-Sched] %s recusado %u vezes, descartando\n", e.path, e.rejects);
+            st.rejected++;
+            _badPaths[_badNext] = pathHash(e.path);
+            _badNext = (_badNext + 1) % BAD_PATHS;
+            release(e);   // sem DropHook: reenviar o mesmo caminho seria recusado de novo
+            continue;
+        }
+        e.state = State::PENDING;
+    }
+    if (found && _inflight) _inflight--;
+    return found;
+}
+
+bool RtdbScheduler::onResult(const char* uid, bool ok, bool rejected) {
+    const char* mark = uid ? strrchr(uid, '#') : nullptr;
+    if (!mark) return false;
+    const uint32_t gen = strtoul(mark + 1, nullptr, 10);
+    return gen && settle(gen, ok, rejected);
+}
+
+// FNV-1a: só para reconhecer o caminho, colisão rara custa um lote solo
+uint32_t RtdbScheduler::pathHash(const char* path) {
+    uint32_t h = 2166136261UL;
+    while (*path) h = (h ^ (uint8_t)*path++) * 16777619UL;
+    return h ? h : 1;   // 0 = posição vazia
+}
+
+bool RtdbScheduler::knownBad(const char* path) const {
+    const uint32_t h = pathHash(path);
+    for (uint32_t b : _badPaths)
+        if (b == h) return true;
+    return false;
+}
+
+void RtdbScheduler::forgetBad(const char* path) {
+    const uint32_t h = pathHash(path);
+    for (uint32_t& b : _badPaths)
+        if (b == h) b = 0;
+}
+
+void RtdbScheduler::checkTimeout(uint32_t now) {
+    for (const Entry& e : _entries) {
+        if (e.state == State::INFLIGHT && now - e.sentAt >= RESULT_TIMEOUT_MS) {
+            Serial.printf("[FB-Sched] lote %lu sem resposta, reenfileirando\n", (unsigned long)e.gen);
+            settle(e.gen, false, false);
+        }
+    }
+}
+
+void RtdbScheduler::printStats() const {
+    Serial.printf("[FB-Sched] em voo=%u\n", _inflight);
+    for (uint8_t c = 0; c < (uint8_t)Prio::COUNT; c++) {
+        const ClassStats& st = _stats[c];
+        Serial.printf("[FB-Sched] %-9s fila=%u (max %u) env=%lu merge=%lu desc=%lu falha=%lu recus=%lu espera med=%lums max=%lums\n",
+                      CLASS_NAME[c], st.depth, st.maxDepth,
+                      (unsigned long)st.sent, (unsigned long)st.merged,
+                      (unsigned long)st.dropped, (unsigned long)st.failed,
+                      (unsigned long)st.rejected,
+                      (unsigned long)(st.sent ? st.waitTotalMs / st.sent : 0),
+                      (unsigned long)st.waitMaxMs);
+    }
+}
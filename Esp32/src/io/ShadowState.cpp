@@ -0,0 +1,87 @@
+#include "io/ShadowState.h"
+#include <math.h>
+
+void ShadowState::attach(RtdbScheduler& sched) {
+    sched.setDropHook(&ShadowState::onDropped, this);
+}
+
+void ShadowState::onDropped(void* ctx, const char* path) {
+    static_cast<ShadowState*>(ctx)->markDropped(path);
+}
+
+// o scheduler guarda o caminho sem a '/' inicial
+void ShadowState::markDropped(const char* path) {
+    for (Node& n : _nodes) {
+        if (!n.path) continue;
+        const char* p = n.path;
+        while (*p == '/') p++;
+        if (strcmp(p, path) == 0) n.dirty = true;
+    }
+}
+
+void ShadowState::define(uint8_t id, const char* path, Prio prio, float deadband, uint32_t maxStaleMs) {
+    if (id >= MAX_NODES) return;
+    Node& n = _nodes[id];
+    n = Node();
+    n.path = path;
+    n.prio = prio;
+    n.deadband = deadband;
+    n.maxStaleMs = maxStaleMs;
+}
+
+bool ShadowState::enqueue(RtdbScheduler& sched, Node& n, uint32_t now) {
+    bool queued = (n.kind == Kind::BOOL)
+        ? sched.setBool(n.path, n.desired != 0.0f, n.prio)
+        : sched.setFloat(n.path, n.desired, n.prio);
+    if (!queued) {
+        n.dirty = true;   // refresh() tenta de novo
+        return false;
+    }
+
+    n.sent = n.desired;
+    n.hasSent = true;
+    n.dirty = false;
+    n.sentAt = now;
+    return true;
+}
+
+bool ShadowState::publish(RtdbScheduler& sched, uint8_t id, float v, uint32_t now) {
+    if (id >= MAX_NODES || !_nodes[id].path) return false;
+    Node& n = _nodes[id];
+    n.desired = v;
+
+    if (n.hasSent && !n.dirty) {
+        bool same = (n.kind == Kind::BOOL)
+            ? (n.sent == v)
+            : (isfinite(v) == isfinite(n.sent)) && (!isfinite(v) || fabsf(v - n.sent) <= n.deadband);
+        if (same) { _suppressed++; return false; }
+    }
+    return enqueue(sched, n, now);
+}
+
+bool ShadowState::publishBool(RtdbScheduler& sched, uint8_t id, bool v, uint32_t now) {
+    if (id < MAX_NODES) _nodes[id].kind = Kind::BOOL;
+    return publish(sched, id, v ? 1.0f : 0.0f, now);
+}
+
+bool ShadowState::publishFloat(RtdbScheduler& sched, uint8_t id, float v, uint32_t now) {
+    if (id < MAX_NODES) _nodes[id].kind = Kind::FLOAT;
+    return publish(sched, id, v, now);
+}
+
+void ShadowState::refresh(RtdbScheduler& sched, uint32_t now) {
+    for (Node& n : _nodes) {
+        if (!n.path || (!n.hasSent && !n.dirty)) continue;
+        bool stale = n.hasSent && n.maxStaleMs && (now - n.sentAt >= n.maxStaleMs);
+        if (!n.dirty && !stale) continue;
+        // classe cheia: reenfileirar só despejaria outro nó
+        if (sched.room(n.prio) == 0) continue;
+        enqueue(sched, n, now);
+    }
+}
+
+void ShadowState::invalidate() {
+    for (Node& n : _nodes) {
+        if (n.path && n.hasSent) n.dirty = true;
+    }
+}
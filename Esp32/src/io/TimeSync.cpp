@@ -1,12 +1,17 @@
 #include "io/TimeSync.h"
 #include <time.h>
+#include <sys/time.h>
+#include "esp_sntp.h"
+#include "core/Clock.h"
 
-void syncTimeTZ(){
-  const long GMT_OFFSET_SEC = -3 * 3600;
-  configTime(GMT_OFFSET_SEC, 0, "pool.ntp.org", "time.nist.gov");
-  time_t now = time(nullptr);
-  Serial.print("Sincronizando NTP");
-  int tries = 0;
-  while (now < 1700000000 && tries < 60) { delay(250); Serial.print("."); now = time(nullptr); tries++; }
-  Serial.println();
+// roda na task do lwIP: só grava a referência (sem Serial)
+static void onTimeSync(struct timeval* tv) {
+  const uint64_t mono = Clock::monoMillis();
+  const uint64_t epoch = (uint64_t)tv->tv_sec * 1000ULL + (uint64_t)(tv->tv_usec / 1000);
+  Clock::sync(epoch, mono);
+}
+
+void TimeSync::begin(long gmtOffsetSec, const char* server1, const char* server2) {
+  sntp_set_time_sync_notification_cb(onTimeSync);
+  configTime(gmtOffsetSec, 0, server1, server2);
 }
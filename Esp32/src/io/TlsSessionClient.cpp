@@ -0,0 +1,328 @@
+#include "io/TlsSessionClient.h"
+#include <esp_system.h>
+#include "mbedtls/version.h"
+#include "mbedtls/error.h"
+#include "mbedtls/net_sockets.h"
+
+// estado do handshake: campo público no mbedTLS 2.x, privado no 3.x
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+#define TLS_STATE(s) ((s).MBEDTLS_PRIVATE(state))
+#else
+#define TLS_STATE(s) ((s).state)
+#endif
+
+// ==== cache de sessões em RTC ====
+// Sobrevive a reset por software/watchdog e deep sleep; no power-on (ou
+// brownout) a RTC volta com lixo e o cache é zerado.
+namespace {
+struct CacheSlot {
+    char     host[TlsSessionClient::HOST_LEN];
+    uint16_t len;
+    uint32_t crc;
+    uint32_t lastUse;
+    uint8_t  blob[TlsSessionClient::SESSION_MAX];
+};
+
+struct RtcCache {
+    uint32_t                magic;
+    uint32_t                useCounter;
+    TlsSessionClient::Stats stats;
+    CacheSlot               slots[TlsSessionClient::CACHE_SLOTS];
+};
+
+constexpr uint32_t CACHE_MAGIC = 0x544C5331;   // "TLS1"
+RTC_NOINIT_ATTR RtcCache s_cache;
+bool s_checked = false;
+
+RtcCache& cache() {
+    if (!s_checked) {
+        s_checked = true;
+        esp_reset_reason_t why = esp_reset_reason();
+        if (s_cache.magic != CACHE_MAGIC || why == ESP_RST_POWERON || why == ESP_RST_BROWNOUT) {
+            memset(&s_cache, 0, sizeof(s_cache));
+            s_cache.magic = CACHE_MAGIC;
+        }
+    }
+    return s_cache;
+}
+
+uint32_t checksum(const uint8_t* p, size_t n) {
+    uint32_t h = 2166136261u;   // FNV-1a
+    for (size_t i = 0; i < n; i++) { h ^= p[i]; h *= 16777619u; }
+    return h;
+}
+
+CacheSlot* findSlot(const char* host) {
+    for (CacheSlot& s : cache().slots)
+        if (s.len && strncmp(s.host, host, TlsSessionClient::HOST_LEN) == 0) return &s;
+    return nullptr;
+}
+
+// mesmo host → mesmo slot; senão um vazio; senão o menos usado recentemente
+CacheSlot& pickSlot(const char* host) {
+    if (CacheSlot* s = findSlot(host)) return *s;
+    CacheSlot* best = &cache().slots[0];
+    for (CacheSlot& s : cache().slots) {
+        if (!s.len) return s;
+        if (s.lastUse < best->lastUse) best = &s;
+    }
+    return *best;
+}
+} // namespace
+
+// ==== ciclo de vida ====
+TlsSessionClient::TlsSessionClient() {}
+
+TlsSessionClient::~TlsSessionClient() { stop(); }
+
+bool TlsSessionClient::setup(const char* host) {
+    mbedtls_ssl_init(&_ssl);
+    mbedtls_ssl_config_init(&_conf);
+    mbedtls_ctr_drbg_init(&_drbg);
+    mbedtls_entropy_init(&_entropy);
+    mbedtls_x509_crt_init(&_cacert);
+    _init = true;
+
+    static const char PERS[] = "aquario-tls";
+    if (mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy,
+                              (const unsigned char*)PERS, sizeof(PERS) - 1) != 0) return false;
+    if (mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                    MBEDTLS_SSL_PRESET_DEFAULT) != 0) return false;
+
+    if (_ca) {
+        if (mbedtls_x509_crt_parse(&_cacert, (const unsigned char*)_ca, strlen(_ca) + 1) != 0) {
+            Serial.println("[TLS] bundle de CAs inválido");
+            return false;
+        }
+        mbedtls_ssl_conf_ca_chain(&_conf, &_cacert, nullptr);
+        mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    } else {
+        mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_NONE);
+    }
+    mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+
+    if (mbedtls_ssl_setup(&_ssl, &_conf) != 0) return false;
+    if (mbedtls_ssl_set_hostname(&_ssl, host) != 0) return false;
+    mbedtls_ssl_set_bio(&_ssl, &_tcp, bioSend, bioRecv, nullptr);
+    return true;
+}
+
+void TlsSessionClient::teardown() {
+    if (!_init) return;
+    mbedtls_ssl_free(&_ssl);
+    mbedtls_ssl_config_free(&_conf);
+    mbedtls_ctr_drbg_free(&_drbg);
+    mbedtls_entropy_free(&_entropy);
+    mbedtls_x509_crt_free(&_cacert);
+    _init = false;
+}
+
+// ==== handshake ====
+// Oferece a sessão guardada (se houver) e avança passo a passo: um
+// handshake completo passa por SERVER_KEY_EXCHANGE, o abreviado pula do
+// ServerHello direto para o ChangeCipherSpec.
+bool TlsSessionClient::handshake(const char* host) {
+    RtcCache& c = cache();
+    bool offered = false;
+    if (CacheSlot* slot = findSlot(host)) {
+        if (slot->crc == checksum(slot->blob, slot->len)) {
+            mbedtls_ssl_session s;
+            mbedtls_ssl_session_init(&s);
+            if (mbedtls_ssl_session_load(&s, slot->blob, slot->len) == 0 &&
+                mbedtls_ssl_set_session(&_ssl, &s) == 0) offered = true;
+            mbedtls_ssl_session_free(&s);
+        }
+        if (!offered) slot->len = 0;
+    }
+
+    const uint32_t t0 = millis();
+    bool full = false;
+    while (TLS_STATE(_ssl) != MBEDTLS_SSL_HANDSHAKE_OVER) {
+        if (TLS_STATE(_ssl) == MBEDTLS_SSL_SERVER_KEY_EXCHANGE) full = true;
+        int ret = mbedtls_ssl_handshake_step(&_ssl);
+        if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+            if (millis() - t0 >= _timeoutMs) {
+                Serial.printf("[TLS] %s: timeout no handshake\n", host);
+                c.stats.failed++;
+                return false;
+            }
+            delay(1);
+            continue;
+        }
+        if (ret != 0) {
+            char err[80];
+            mbedtls_strerror(ret, err, sizeof(err));
+            Serial.printf("[TLS] %s: handshake falhou (-0x%04x %s)\n", host, -ret, err);
+            c.stats.failed++;
+            // sessão pode ter sido o problema: a próxima tentativa é completa
+            if (offered) forgetSession(host);
+            return false;
+        }
+    }
+
+    const uint32_t ms = millis() - t0;
+    c.stats.lastMs = ms;
+    if (full) {
+        c.stats.full++;
+        c.stats.fullMsTotal += ms;
+        if (ms > c.stats.fullMsMax) c.stats.fullMsMax = ms;
+        if (offered) c.stats.rejected++;
+    } else {
+        c.stats.resumed++;
+        c.stats.resumedMsTotal += ms;
+    }
+    Serial.printf("[TLS] %s: handshake %s em %lums\n", host, full ? "completo" : "retomado", (unsigned long)ms);
+
+    // guarda (ou renova) a sessão/ticket para a próxima conexão
+    mbedtls_ssl_session s;
+    mbedtls_ssl_session_init(&s);
+    if (mbedtls_ssl_get_session(&_ssl, &s) == 0) {
+        CacheSlot& slot = pickSlot(host);
+        size_t olen = 0;
+        if (mbedtls_ssl_session_save(&s, slot.blob, sizeof(slot.blob), &olen) == 0) {
+            strncpy(slot.host, host, HOST_LEN - 1);
+            slot.host[HOST_LEN - 1] = '\0';
+            slot.len = (uint16_t)olen;
+            slot.crc = checksum(slot.blob, slot.len);
+            slot.lastUse = ++c.useCounter;
+        } else {
+            slot.len = 0;
+            Serial.printf("[TLS] %s: sessão não coube no cache (%u bytes)\n", host, (unsigned)olen);
+        }
+    }
+    mbedtls_ssl_session_free(&s);
+    return true;
+}
+
+int TlsSessionClient::connect(const char* host, uint16_t port) {
+    stop();
+    if (!_tcp.connect(host, port, _timeoutMs)) {
+        Serial.printf("[TLS] %s:%u: TCP falhou\n", host, port);
+        return 0;
+    }
+    if (!setup(host) || !handshake(host)) {
+        stop();
+        return 0;
+    }
+    _ready = true;
+    return 1;
+}
+
+int TlsSessionClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip.toString().c_str(), port);
+}
+
+void TlsSessionClient::stop() {
+    if (_ready) mbedtls_ssl_close_notify(&_ssl);
+    _ready = false;
+    _peeked = -1;
+    _tcp.stop();
+    teardown();
+}
+
+// ==== E/S ====
+int TlsSessionClient::bioSend(void* ctx, const unsigned char* buf, size_t len) {
+    WiFiClient* tcp = static_cast<WiFiClient*>(ctx);
+    if (!tcp->connected()) return MBEDTLS_ERR_NET_CONN_RESET;
+    size_t n = tcp->write(buf, len);
+    return n ? (int)n : MBEDTLS_ERR_SSL_WANT_WRITE;
+}
+
+int TlsSessionClient::bioRecv(void* ctx, unsigned char* buf, size_t len) {
+    WiFiClient* tcp = static_cast<WiFiClient*>(ctx);
+    if (tcp->available() <= 0)
+        return tcp->connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_NET_CONN_RESET;
+    int n = tcp->read(buf, len);
+    return n > 0 ? n : MBEDTLS_ERR_SSL_WANT_READ;
+}
+
+size_t TlsSessionClient::write(const uint8_t* buf, size_t size) {
+    if (!_ready) return 0;
+    size_t done = 0;
+    const uint32_t t0 = millis();
+    while (done < size) {
+        int ret = mbedtls_ssl_write(&_ssl, buf + done, size - done);
+        if (ret > 0) { done += ret; continue; }
+        if ((ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) &&
+            millis() - t0 < _timeoutMs) {
+            delay(1);
+            continue;
+        }
+        stop();
+        break;
+    }
+    return done;
+}
+
+size_t TlsSessionClient::write(uint8_t b) { return write(&b, 1); }
+
+int TlsSessionClient::available() {
+    if (!_ready) return 0;
+    // processa um registro pendente (se houver) sem consumir dados
+    int ret = mbedtls_ssl_read(&_ssl, nullptr, 0);
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        stop();
+        return 0;
+    }
+    return (int)mbedtls_ssl_get_bytes_avail(&_ssl) + (_peeked >= 0 ? 1 : 0);
+}
+
+int TlsSessionClient::read(uint8_t* buf, size_t size) {
+    if (!_ready || size == 0) return -1;
+    size_t n = 0;
+    if (_peeked >= 0) {
+        buf[n++] = (uint8_t)_peeked;
+        _peeked = -1;
+    }
+    if (n < size) {
+        int ret = mbedtls_ssl_read(&_ssl, buf + n, size - n);
+        if (ret > 0) n += ret;
+        else if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) stop();
+    }
+    return n ? (int)n : -1;
+}
+
+int TlsSessionClient::read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int TlsSessionClient::peek() {
+    if (_peeked < 0) {
+        uint8_t b;
+        if (read(&b, 1) == 1) _peeked = b;
+    }
+    return _peeked;
+}
+
+void TlsSessionClient::flush() {}
+
+uint8_t TlsSessionClient::connected() {
+    if (!_ready) return 0;
+    if (_tcp.connected()) return 1;
+    return available() > 0;
+}
+
+// ==== cache / métricas ====
+void TlsSessionClient::forgetSession(const char* host) {
+    if (CacheSlot* s = findSlot(host)) s->len = 0;
+}
+
+const TlsSessionClient::Stats& TlsSessionClient::stats() { return cache().stats; }
+
+void TlsSessionClient::printStats() {
+    const Stats& st = stats();
+    const uint32_t total = st.full + st.resumed;
+    Serial.printf("[TLS] handshakes=%lu retomados=%lu (%lu%%) recusados=%lu falhas=%lu\n",
+                  (unsigned long)total, (unsigned long)st.resumed,
+                  (unsigned long)(total ? st.resumed * 100 / total : 0),
+                  (unsigned long)st.rejected, (unsigned long)st.failed);
+    Serial.printf("[TLS] completo med=%lums max=%lums | retomado med=%lums | ultimo=%lums\n",
+                  (unsigned long)(st.full ? st.fullMsTotal / st.full : 0),
+                  (unsigned long)st.fullMsMax,
+                  (unsigned long)(st.resumed ? st.resumedMsTotal / st.resumed : 0),
+                  (unsigned long)st.lastMs);
+}
@@ -0,0 +1,92 @@
+#include "io/TokenRefresher.h"
+#include <stdlib.h>
+#include "core/JsonScan.h"
+
+static const char* HOST = "securetoken.googleapis.com";
+
+bool TokenRefresher::start(const char* apiKey, const char* refreshToken) {
+    if (busy()) return false;
+    _len = 0;
+    _buf[0] = '\0';
+    _startedMs = millis();
+
+    if (!_tls.connect(HOST, 443)) {
+        _state = State::FAILED;
+        return false;
+    }
+
+    // refresh token é base64url: vai no corpo sem escape
+    const size_t bodyLen = strlen("grant_type=refresh_token&refresh_token=") + strlen(refreshToken);
+    char head[256];
+    int n = snprintf(head, sizeof(head),
+                     "POST /v1/token?key=%s HTTP/1.0\r\n"
+                     "Host: %s\r\n"
+                     "Content-Type: application/x-www-form-urlencoded\r\n"
+                     "Content-Length: %u\r\n"
+                     "Connection: close\r\n\r\n"
+                     "grant_type=refresh_token&refresh_token=",
+                     apiKey, HOST, (unsigned)bodyLen);
+    if (n <= 0 || (size_t)n >= sizeof(head) ||
+        _tls.write((const uint8_t*)head, n) != (size_t)n ||
+        _tls.write((const uint8_t*)refreshToken, strlen(refreshToken)) != strlen(refreshToken)) {
+        _tls.stop();
+        _state = State::FAILED;
+        return false;
+    }
+    _state = State::READING;
+    return true;
+}
+
+TokenRefresher::State TokenRefresher::poll(AuthToken& out, uint32_t nowEpoch) {
+    // falha já no start(): entrega uma vez e volta a IDLE
+    if (_state == State::FAILED) {
+        _state = State::IDLE;
+        return State::FAILED;
+    }
+    if (_state != State::READING) return _state;
+
+    while (_tls.available() > 0 && _len < RESPONSE_LEN - 1) {
+        int n = _tls.read((uint8_t*)_buf + _len, RESPONSE_LEN - 1 - _len);
+        if (n <= 0) break;
+        _len += n;
+    }
+    _buf[_len] = '\0';
+
+    const bool closed = !_tls.connected();
+    if (!closed && _len < RESPONSE_LEN - 1) {
+        if (millis() - _startedMs < TIMEOUT_MS) return State::READING;
+        Serial.println("[Auth] Refresh: timeout");
+    }
+    _tls.stop();
+    _state = State::IDLE;
+    return parse(out, nowEpoch) ? State::DONE : State::FAILED;
+}
+
+// "HTTP/1.x 200 ..." + corpo JSON com id_token, refresh_token, expires_in
+bool TokenRefresher::parse(AuthToken& out, uint32_t nowEpoch) {
+    if (strncmp(_buf, "HTTP/1.", 7) != 0 || strncmp(_buf + 8, " 200", 4) != 0) {
+        Serial.printf("[Auth] Refresh recusado: %.40s\n", _buf);
+        return false;
+    }
+    const char* body = strstr(_buf, "\r\n\r\n");
+    if (!body) return false;
+    body += 4;
+
+    // monta num temporário: em falha o token atual (e o refresh) fica intacto
+    AuthToken fresh;
+    char expires[12];
+    if (!JsonScan::find(body, "id_token", fresh.id, sizeof(fresh.id)) ||
+        !JsonScan::find(body, "refresh_token", fresh.refresh, sizeof(fresh.refresh)) ||
+        !JsonScan::find(body, "expires_in", expires, sizeof(expires))) {
+        Serial.println("[Auth] Refresh: resposta incompleta");
+        return false;
+    }
+    // token maior que o buffer sairia truncado → inválido
+    if (strlen(fresh.id) >= sizeof(fresh.id) - 1 || strlen(fresh.refresh) >= sizeof(fresh.refresh) - 1) {
+        Serial.println("[Auth] Refresh: token maior que o buffer");
+        return false;
+    }
+    fresh.expiresAt = nowEpoch + (uint32_t)strtoul(expires, nullptr, 10);
+    out = fresh;
+    return true;
+}
@@ -1,16 +1,149 @@
 #include "io/WiFiManager.h"
 #include <WiFi.h>
+#include <Preferences.h>
 
-void WiFiManager::begin(const char* ssid, const char* pass){
+static const char* NVS_NS = "wifi";
+
+// ==== cache BSSID/canal (NVS) ====
+void WiFiManager::loadCache() {
+  Preferences p;
+  if (!p.begin(NVS_NS, true)) return;
+  if (p.getBytes("bssid", _bssid, sizeof(_bssid)) != sizeof(_bssid)) _channel = 0;
+  else _channel = p.getUChar("ch", 0);
+  p.end();
+}
+
+// só grava quando o AP/canal mudou (evita desgaste a cada reconexão)
+void WiFiManager::saveCache() {
+  const uint8_t* bssid = WiFi.BSSID();
+  const uint8_t ch = (uint8_t)WiFi.channel();
+  if (!bssid || !ch) return;
+  if (ch == _channel && memcmp(bssid, _bssid, sizeof(_bssid)) == 0) return;
+
+  memcpy(_bssid, bssid, sizeof(_bssid));
+  _channel = ch;
+  Preferences p;
+  if (!p.begin(NVS_NS, false)) return;
+  p.putBytes("bssid", _bssid, sizeof(_bssid));
+  p.putUChar("ch", _channel);
+  p.end();
+}
+
+// ==== ciclo de vida ====
+void WiFiManager::begin(const char* ssid, const char* pass) {
+  _ssid = ssid;
+  _pass = pass;
+  loadCache();
+
+  WiFi.persistent(false);        // credenciais já vêm do firmware
+  WiFi.setAutoReconnect(false);  // quem reconecta é a máquina de estados
   WiFi.mode(WIFI_MODE_STA);
-  WiFi.begin(ssid, pass);
-  Serial.print("Conectando Wi-Fi");
-  while (WiFi.status() != WL_CONNECTED) { delay(250); Serial.print("."); }
-  Serial.printf("\nWi-Fi OK. IP: %s\n", WiFi.localIP().toString().c_str());
-}
-void WiFiManager::handle(){
-  if (WiFi.status() != WL_CONNECTED){
-    WiFi.reconnect();
+
+  WiFi.onEvent([this](arduino_event_id_t ev, arduino_event_info_t info) {
+    if (ev == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+      _evGotIp = true;
+    } else if (ev == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+      _evReason = info.wifi_sta_disconnected.reason;
+      _evLost = true;
+    }
+  });
+
+  startAttempt(millis());
+}
+
+void WiFiManager::startAttempt(uint32_t now) {
+  _evGotIp = false;
+  _evLost = false;
+  _attemptAt = now;
+  _stats.attempts++;
+  // falhou a tentativa rápida → a próxima faz scan
+  _fastAttempt = _channel != 0 && _failStreak == 0;
+  if (_fastAttempt) {
+    Serial.printf("[WiFi] Conectando (canal %u, BSSID em cache)\n", _channel);
+    WiFi.begin(_ssid, _pass, _channel, _bssid);
+  } else {
+    Serial.println("[WiFi] Conectando (scan)");
+    WiFi.begin(_ssid, _pass);
   }
+  _state = State::CONNECTING;
+}
+
+void WiFiManager::onConnected(uint32_t now) {
+  const uint32_t ms = now - _attemptAt;
+  _stats.connects++;
+  if (_fastAttempt) _stats.fastConnects++;
+  _stats.totalConnectMs += ms;
+  _stats.lastConnectMs = ms;
+  if (ms > _stats.maxConnectMs) _stats.maxConnectMs = ms;
+  _failStreak = 0;
+  _state = State::CONNECTED;
+  _connectedEdge = true;
+  saveCache();
+  Serial.printf("[WiFi] OK em %lums. IP: %s\n", (unsigned long)ms, WiFi.localIP().toString().c_str());
+}
+
+void WiFiManager::onFailed(uint32_t now) {
+  _stats.failures++;
+  WiFi.disconnect();
+  if (_fastAttempt) {
+    // AP trocou de canal/BSSID? tenta já com scan
+    _failStreak = 1;
+    startAttempt(now);
+    return;
+  }
+  _failStreak++;
+  uint32_t wait = BACKOFF_MIN_MS << (_failStreak < 7 ? _failStreak - 1 : 6);
+  if (wait > BACKOFF_MAX_MS) wait = BACKOFF_MAX_MS;
+  _retryAt = now + wait;
+  _state = State::BACKOFF;
+  Serial.printf("[WiFi] Falhou (motivo %u), nova tentativa em %lus\n",
+                _stats.lastReason, (unsigned long)(wait / 1000));
+}
+
+// ==== máquina de estados ====
+void WiFiManager::handle(uint32_t now) {
+  if (!_ssid) return;
+  if (_evLost) _stats.lastReason = _evReason;
+
+  switch (_state) {
+    case State::IDLE:
+      startAttempt(now);
+      break;
+
+    case State::CONNECTING:
+      if (_evGotIp || WiFi.status() == WL_CONNECTED) {
+        onConnected(now);
+      } else if (now - _attemptAt >= (_fastAttempt ? FAST_TIMEOUT_MS : SCAN_TIMEOUT_MS)) {
+        onFailed(now);
+      }
+      break;
+
+    case State::CONNECTED:
+      if (_evLost || WiFi.status() != WL_CONNECTED) {
+        _stats.drops++;
+        Serial.printf("[WiFi] Caiu (motivo %u), reconectando\n", _stats.lastReason);
+        startAttempt(now);
+      }
+      break;
+
+    case State::BACKOFF:
+      if ((int32_t)(now - _retryAt) >= 0) startAttempt(now);
+      break;
+  }
+}
+
+bool WiFiManager::justConnected() {
+  bool e = _connectedEdge;
+  _connectedEdge = false;
+  return e;
+}
+
+void WiFiManager::printStats() const {
+  Serial.printf("[WiFi] tentativas=%lu conexoes=%lu (rapidas %lu) falhas=%lu quedas=%lu "
+                "tempo med=%lums max=%lums ultimo=%lums\n",
+                (unsigned long)_stats.attempts, (unsigned long)_stats.connects,
+                (unsigned long)_stats.fastConnects, (unsigned long)_stats.failures,
+                (unsigned long)_stats.drops,
+                (unsigned long)(_stats.connects ? _stats.totalConnectMs / _stats.connects : 0),
+                (unsigned long)_stats.maxConnectMs, (unsigned long)_stats.lastConnectMs);
 }
-bool WiFiManager::connected() const { return WiFi.status() == WL_CONNECTED; }
@@ -8,5 +8,6 @@ void setup() {
 }
 
 void loop() {
-  app.tick();
+  // App roda nas próprias tasks (controle/rede); a loopTask não tem mais uso
+  vTaskDelete(nullptr);
 }
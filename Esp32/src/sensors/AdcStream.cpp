@@ -0,0 +1,101 @@
+#include "sensors/AdcStream.h"
+
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+#include <esp_adc/adc_continuous.h>
+static adc_continuous_handle_t s_handle = nullptr;
+static volatile uint32_t s_overruns = 0;
+
+static bool IRAM_ATTR onPoolOverflow(adc_continuous_handle_t, const adc_continuous_evt_data_t*, void*) {
+  s_overruns++;
+  return false;
+}
+#else
+#include <driver/adc.h>
+static volatile uint32_t s_overruns = 0;
+#endif
+
+// bytes por leitura do driver (múltiplo do tamanho de uma amostra)
+static constexpr size_t FRAME_BYTES = 256;
+static constexpr size_t RESULT_BYTES = sizeof(adc_digi_output_data_t);   // 2 no ESP32 (TYPE1)
+
+bool AdcStream::begin(uint8_t pin) {
+  const int8_t ch = digitalPinToAnalogChannel(pin);
+  if (ch < 0 || ch > 7) {   // 0..7 = ADC1
+    Serial.printf("[ADC] Pino %u nao e do ADC1\n", pin);
+    return false;
+  }
+  _channel = (uint8_t)ch;
+
+  adc_digi_pattern_config_t pattern = {};
+  pattern.atten = ADC_ATTEN_DB_11;
+  pattern.channel = _channel;
+  pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+  pattern.unit = ADC_UNIT_1;
+  adc_continuous_handle_cfg_t hc = {};
+  hc.max_store_buf_size = POOL_BYTES;
+  hc.conv_frame_size = FRAME_BYTES;
+  if (adc_continuous_new_handle(&hc, &s_handle) != ESP_OK) return false;
+
+  adc_continuous_config_t cfg = {};
+  cfg.pattern_num = 1;
+  cfg.adc_pattern = &pattern;
+  cfg.sample_freq_hz = SAMPLE_HZ;
+  cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+  cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+  adc_continuous_evt_cbs_t cbs = {};
+  cbs.on_pool_ovf = onPoolOverflow;
+  _running = adc_continuous_config(s_handle, &cfg) == ESP_OK &&
+             adc_continuous_register_event_callbacks(s_handle, &cbs, nullptr) == ESP_OK &&
+             adc_continuous_start(s_handle) == ESP_OK;
+#else
+  pattern.unit = 0;   // ADC1
+  adc_digi_init_config_t init = {};
+  init.max_store_buf_size = POOL_BYTES;
+  init.conv_num_each_intr = FRAME_BYTES;
+  init.adc1_chan_mask = BIT(_channel);
+  init.adc2_chan_mask = 0;
+  if (adc_digi_initialize(&init) != ESP_OK) return false;
+
+  adc_digi_configuration_t cfg = {};
+  cfg.conv_limit_en = 1;      // obrigatório no ESP32
+  cfg.conv_limit_num = 250;
+  cfg.pattern_num = 1;
+  cfg.adc_pattern = &pattern;
+  cfg.sample_freq_hz = SAMPLE_HZ;
+  cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+  cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+  _running = adc_digi_controller_configure(&cfg) == ESP_OK && adc_digi_start() == ESP_OK;
+#endif
+
+  if (!_running) Serial.println("[ADC] Modo continuo indisponivel");
+  return _running;
+}
+
+size_t AdcStream::read(uint16_t* out, size_t max) {
+  if (!_running) return 0;
+  uint8_t buf[FRAME_BYTES];
+  size_t n = 0;
+  while (n < max) {
+    uint32_t want = (uint32_t)((max - n) * RESULT_BYTES);
+    if (want > sizeof(buf)) want = sizeof(buf);
+    uint32_t got = 0;
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    if (adc_continuous_read(s_handle, buf, want, &got, 0) != ESP_OK) break;
+#else
+    // INVALID_STATE = pool estourou; os dados entregues ainda valem
+    const esp_err_t err = adc_digi_read_bytes(buf, want, &got, 0);
+    if (err == ESP_ERR_INVALID_STATE) s_overruns++;
+    else if (err != ESP_OK) break;
+#endif
+    for (uint32_t i = 0; i + RESULT_BYTES <= got; i += RESULT_BYTES) {
+      const adc_digi_output_data_t* d = (const adc_digi_output_data_t*)&buf[i];
+      if (d->type1.channel == _channel) out[n++] = d->type1.data;
+    }
+    if (got < want) break;   // esvaziou
+  }
+  return n;
+}
+
+uint32_t AdcStream::overruns() const { return s_overruns; }
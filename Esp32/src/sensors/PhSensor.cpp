@@ -1,17 +1,78 @@
 #include "sensors/PhSensor.h"
-#include "config/thresholds.h"
-
-void PhSensor::begin(uint8_t adcPin){ pin = adcPin; }
-
-float PhSensor::readPH(){
-  const int N=12; long acc=0;
-  for (int i=0;i<N;i++){ acc += analogRead(pin); delayMicroseconds(100); }
-  float adc = acc/(float)N;
-  float v = adc * (ADC_VREF/ADC_MAX_COUNTS);
-  if (!init){ emaV = v; init = true; } else { emaV = ALPHA_PH*v + (1.0f-ALPHA_PH)*emaV; }
-  float pH = M_PH * emaV + B_PH;
-  if (pH < PH_MIN) pH = PH_MIN;
-  if (pH > PH_MAX) pH = PH_MAX;
-  lastPH = pH;
-  return pH;
+#include "config/Thresholds.h"
+#include <algorithm>
+#include <esp_timer.h>
+
+PhSensor::PhSensor()
+  : _filter(Signal::Ema(ALPHA_PH), Signal::Linear(M_PH, B_PH), Signal::Clamp<float>(PH_MIN, PH_MAX)) {}
+
+bool PhSensor::begin(uint8_t adcPin) { return _adc.begin(adcPin); }
+
+// ==== aquisição ====
+void PhSensor::poll() {
+  const int64_t t0 = esp_timer_get_time();
+  uint16_t raw[64];
+  size_t n;
+  while ((n = _adc.read(raw, 64)) > 0) {
+    _stats.samples += n;
+    for (size_t i = 0; i < n; i++) {
+      _blockSum += raw[i];
+      if (++_blockN < OVERSAMPLE) continue;
+      _ring[_head] = (uint16_t)_blockSum;
+      _head = (_head + 1) % RING;
+      if (_filled < RING) _filled++;
+      _blockSum = 0;
+      _blockN = 0;
+      _stats.blocks++;
+    }
+  }
+  const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+  if (us > _stats.pollUsMax) _stats.pollUsMax = us;
+}
+
+// ==== filtro ====
+float PhSensor::trimmedMean(uint16_t* v, size_t n, uint8_t trimPct, uint16_t* spread) {
+  if (n == 0) return NAN;
+  size_t k = n * trimPct / 100;
+  if (2 * k >= n) k = (n - 1) / 2;
+  // O(n): k menores para a esquerda, depois k maiores para a direita
+  std::nth_element(v, v + k, v + n);
+  std::nth_element(v + k, v + (n - k), v + n);
+  uint32_t sum = 0;
+  uint16_t lo = 0xFFFF, hi = 0;
+  for (size_t i = k; i < n - k; i++) {
+    sum += v[i];
+    if (v[i] < lo) lo = v[i];
+    if (v[i] > hi) hi = v[i];
+  }
+  if (spread) *spread = hi - lo;
+  return sum / (float)(n - 2 * k);
+}
+
+float PhSensor::readVolts() {
+  if (_filled == 0) return NAN;
+  const int64_t t0 = esp_timer_get_time();
+  uint16_t work[RING];
+  memcpy(work, _ring, _filled * sizeof(work[0]));
+  uint16_t spread = 0;
+  const float blockMean = trimmedMean(work, _filled, TRIM_PCT, &spread);
+  _stats.filterUsLast = (uint32_t)(esp_timer_get_time() - t0);
+
+  const float voltsPerBlock = ADC_VREF / (ADC_MAX_COUNTS * OVERSAMPLE);
+  _stats.spreadMvLast = spread * voltsPerBlock * 1000.0f;
+  return blockMean * voltsPerBlock;
+}
+
+float PhSensor::readPH() {
+  const float v = readVolts();
+  if (isnan(v)) return NAN;
+  _lastPH = _filter.process(v);
+  return _lastPH;
+}
+
+void PhSensor::printStats() const {
+  Serial.printf("[pH] amostras=%lu blocos=%lu estouros=%lu | poll max=%luus filtro=%luus | faixa=%.1fmV\n",
+                (unsigned long)_stats.samples, (unsigned long)_stats.blocks,
+                (unsigned long)_adc.overruns(), (unsigned long)_stats.pollUsMax,
+                (unsigned long)_stats.filterUsLast, _stats.spreadMvLast);
 }
@@ -1,17 +1,144 @@
 #include "sensors/TemperatureSensor.h"
-#include <OneWire.h>
-#include <DallasTemperature.h>
+#include <Preferences.h>
+#include <esp_timer.h>
 
-static OneWire* _ow=nullptr;
-static DallasTemperature* _dt=nullptr;
+static const char* NVS_NS = "ds18b20";
+static constexpr uint8_t CMD_CONVERT_T = 0x44;
 
-void TemperatureSensor::begin(uint8_t pin){
-  _ow = new OneWire(pin);
-  _dt = new DallasTemperature(_ow);
-  _dt->begin();
+// DS18S20 (0x10), DS1822 (0x22), DS18B20 (0x28)
+static bool isTempFamily(uint8_t f) { return f == 0x10 || f == 0x22 || f == 0x28; }
+
+// ==== cache de ROMs (NVS) ====
+void TemperatureSensor::loadCache() {
+  Preferences p;
+  if (!p.begin(NVS_NS, true)) return;
+  const size_t n = p.getBytes("roms", _addr, sizeof(_addr));
+  p.end();
+  _count = (uint8_t)(n / sizeof(DeviceAddress));
+}
+
+// só grava quando o conjunto de sondas mudou
+void TemperatureSensor::saveCache() {
+  Preferences p;
+  if (!p.begin(NVS_NS, false)) return;
+  p.putBytes("roms", _addr, _count * sizeof(DeviceAddress));
+  p.end();
+}
+
+// Busca no barramento e casa com as vagas: quem já tem vaga fica nela,
+// ROM novo assume a primeira vaga cuja sonda não respondeu (troca) ou
+// a próxima livre
+void TemperatureSensor::enumerate(uint32_t nowMs) {
+  DeviceAddress found[MAX_PROBES];
+  uint8_t n = 0;
+  DeviceAddress a;
+  _ow.reset_search();
+  while (n < MAX_PROBES && _ow.search(a)) {
+    if (OneWire::crc8(a, 7) != a[7] || !isTempFamily(a[0])) continue;
+    memcpy(found[n++], a, sizeof(a));
+  }
+  _stats.searches++;
+  _lastScanMs = nowMs;
+  _rescan = false;
+
+  bool seen[MAX_PROBES] = {false};
+  bool matched[MAX_PROBES] = {false};
+  for (uint8_t i = 0; i < _count; i++)
+    for (uint8_t j = 0; j < n; j++)
+      if (!matched[j] && memcmp(_addr[i], found[j], sizeof(DeviceAddress)) == 0) {
+        seen[i] = matched[j] = true;
+        break;
+      }
+
+  bool changed = false;
+  for (uint8_t j = 0; j < n; j++) {
+    if (matched[j]) continue;
+    uint8_t slot = 0;
+    while (slot < _count && seen[slot]) slot++;
+    if (slot == MAX_PROBES) break;
+    if (slot == _count) _count++;
+    memcpy(_addr[slot], found[j], sizeof(DeviceAddress));
+    seen[slot] = true;
+    changed = true;
+    // resolução vai para a EEPROM da sonda: só nas novas
+    _dt.setResolution(_addr[slot], _resolution);
+    Serial.printf("[DS18B20] Sonda %u: %02X%02X%02X%02X%02X%02X%02X%02X (nova)\n", slot,
+                  found[j][0], found[j][1], found[j][2], found[j][3],
+                  found[j][4], found[j][5], found[j][6], found[j][7]);
+  }
+  if (changed) saveCache();
 }
-float TemperatureSensor::readCelsius(){
-  _dt->requestTemperatures();
-  lastC = _dt->getTempCByIndex(0);
-  return lastC;
+
+// ==== ciclo de vida ====
+void TemperatureSensor::begin(uint8_t pin, uint8_t resolution) {
+  _ow.begin(pin);
+  _dt.setOneWire(&_ow);
+  _resolution = resolution;
+  for (float& c : _lastC) c = NAN;
+  loadCache();
+  const uint8_t cached = _count;
+  enumerate(millis());
+  Serial.printf("[DS18B20] %u sonda(s) (%u do cache)\n", _count, cached);
+}
+
+bool TemperatureSensor::start(uint32_t nowMs) {
+  if (_converting) return false;
+  const int64_t t0 = esp_timer_get_time();
+
+  if (_rescan && nowMs - _lastScanMs >= RESCAN_MS) enumerate(nowMs);
+  // alimentação normal (3 fios): sem pull-up forte durante a conversão
+  _ok = _count > 0 && _ow.reset();
+  if (_ok) {
+    _ow.skip();
+    _ow.write(CMD_CONVERT_T, 0);
+  }
+  _readyAtMs = nowMs + (_ok ? _dt.millisToWaitForConversion(_resolution) : 0);
+  _next = 0;
+  _converting = true;
+
+  const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+  if (us > _stats.startUsMax) _stats.startUsMax = us;
+  return _ok;
+}
+
+TemperatureSensor::Step TemperatureSensor::poll(uint32_t nowMs) {
+  if (!_converting) return Step::NONE;
+  if (_ok && (int32_t)(nowMs - _readyAtMs) < 0) return Step::NONE;
+
+  if (!_ok) {
+    for (uint8_t i = 0; i < _count; i++) _lastC[i] = NAN;
+    _stats.failures++;
+    _rescan = true;
+    _next = _count;
+  } else {
+    const int64_t t0 = esp_timer_get_time();
+    const float c = _dt.getTempC(_addr[_next]);   // scratchpad + CRC pelo ROM
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    _stats.readUsLast = us;
+    if (us > _stats.readUsMax) _stats.readUsMax = us;
+
+    if (c == DEVICE_DISCONNECTED_C) {
+      _lastC[_next] = NAN;
+      _stats.failures++;
+      _rescan = true;
+    } else {
+      _lastC[_next] = c;
+      _stats.reads++;
+    }
+    _next++;
+  }
+
+  if (_next < _count) return Step::READ;
+  _converting = false;
+  _stats.rounds++;
+  return Step::ROUND;
+}
+
+void TemperatureSensor::printStats() const {
+  Serial.printf("[DS18B20] sondas=%u rodadas=%lu leituras=%lu falhas=%lu buscas=%lu | "
+                "start max=%luus | leitura/sonda ultima=%luus max=%luus\n",
+                _count, (unsigned long)_stats.rounds, (unsigned long)_stats.reads,
+                (unsigned long)_stats.failures, (unsigned long)_stats.searches,
+                (unsigned long)_stats.startUsMax, (unsigned long)_stats.readUsLast,
+                (unsigned long)_stats.readUsMax);
 }
@@ -0,0 +1,67 @@
+#include "ui/LcdFrame.h"
+#include <LiquidCrystal_I2C.h>
+#include <esp_timer.h>
+
+void LcdFrame::begin(LiquidCrystal_I2C* lcd) {
+  _lcd = lcd;
+  memset(_want, ' ', sizeof(_want));
+  invalidate();
+}
+
+void LcdFrame::setLine(uint8_t row, const char* text) {
+  if (row >= ROWS) return;
+  uint8_t c = 0;
+  for (; c < COLS && text[c]; c++) _want[row][c] = text[c];
+  for (; c < COLS; c++) _want[row][c] = ' ';
+}
+
+// 0 nunca é escrito pelo setLine: marca todas as células como diferentes
+void LcdFrame::invalidate() { memset(_shown, 0, sizeof(_shown)); }
+
+uint16_t LcdFrame::flush(uint32_t nowMs) {
+  _stats.frames++;
+  if (!_lcd) return 0;
+  if (nowMs - _lastResyncMs >= RESYNC_MS) {
+    _lastResyncMs = nowMs;
+    invalidate();
+  }
+
+  const int64_t t0 = esp_timer_get_time();
+  uint16_t bytes = 0;
+  for (uint8_t r = 0; r < ROWS; r++) {
+    uint8_t c = 0;
+    while (c < COLS) {
+      if (_want[r][c] == _shown[r][c]) { c++; continue; }
+      // início de corrida: estende enquanto houver diferença a até MERGE_GAP células
+      uint8_t end = c + 1, gap = 0;
+      for (uint8_t k = c + 1; k < COLS; k++) {
+        if (_want[r][k] != _shown[r][k]) { end = k + 1; gap = 0; }
+        else if (++gap > MERGE_GAP) break;
+      }
+      _lcd->setCursor(c, r);
+      bytes++;
+      for (; c < end; c++) {
+        _lcd->write((uint8_t)_want[r][c]);
+        _shown[r][c] = _want[r][c];
+        bytes++;
+      }
+    }
+  }
+  if (bytes == 0) return 0;
+
+  const uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+  _stats.dirtyFrames++;
+  _stats.bytesTotal += bytes;
+  _stats.bytesLast = bytes;
+  if (bytes > _stats.bytesMax) _stats.bytesMax = bytes;
+  _stats.usLast = us;
+  if (us > _stats.usMax) _stats.usMax = us;
+  return bytes;
+}
+
+void LcdFrame::printStats() const {
+  Serial.printf("[LCD] quadros=%lu com envio=%lu | bytes ultimo=%u max=%u total=%lu | tempo ultimo=%luus max=%luus\n",
+                (unsigned long)_stats.frames, (unsigned long)_stats.dirtyFrames,
+                _stats.bytesLast, _stats.bytesMax, (unsigned long)_stats.bytesTotal,
+                (unsigned long)_stats.usLast, (unsigned long)_stats.usMax);
+}
@@ -1,8 +1,10 @@
 #include "ui/LcdView.h"
 #include <Wire.h>
 #include <LiquidCrystal_I2C.h>
+#include "ui/LcdFrame.h"
 
 static LiquidCrystal_I2C* lcd=nullptr;
+static LcdFrame frame;
 
 static uint8_t scanI2C(){
   uint8_t found=0;
@@ -36,6 +38,7 @@ void LcdView::begin(uint8_t sda, uint8_t scl){
   lcd->print(buf);
   delay(1000);
   lcd->clear();
+  frame.begin(lcd);
 }
 
 void LcdView::update(float tC, float pH, bool heaterOn, bool waterfallOn, bool waterOk){
@@ -50,10 +53,9 @@ void LcdView::update(float tC, float pH, bool heaterOn, bool waterfallOn, bool w
     snprintf(l1,sizeof(l1),"CASC:%s", waterfallOn? "ON ":"OFF");
     snprintf(l2,sizeof(l2),"NIV:%s",  waterOk? "OK ":"BAIX");
   }
-  lcd->setCursor(0,0); lcd->print("                ");
-  lcd->setCursor(0,1); lcd->print("                ");
-  lcd->setCursor(0,0); lcd->print(l1);
-  lcd->setCursor(0,1); lcd->print(l2);
+  frame.setLine(0,l1);
+  frame.setLine(1,l2);
+  frame.flush(millis());
 }
 
 void LcdView::show(float tC, float pH, bool heaterOn, bool waterfallOn, bool waterOk){
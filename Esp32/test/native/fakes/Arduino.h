@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <cmath>
+#include <string>
+
+/**
+ * Arduino.h (env:native) — só o que o firmware portátil usa
+ * ---------------------------------------------------------------
+ *  - Tempo: relógio falso em µs, avançado pelo teste (Fake::advanceMs);
+ *    millis()/micros()/esp_timer_get_time() leem o mesmo relógio
+ *  - GPIO: saídas vão para o GPIO falso (soc/gpio_struct.h), o mesmo que
+ *    o FastGpio escreve; entradas vêm de Fake::setInput()
+ *  - Timer de hardware: guarda a ISR; Fake::fireTimer() a dispara
+ *  - Serial: printf no stdout (Fake::quiet() silencia)
+ *  Estado e controle em Fake.h.
+ */
+using std::isfinite;
+using std::isnan;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+
+// ==== tempo ====
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// ==== GPIO / ADC ====
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+
+// ==== timer de hardware (API do core 2.x) ====
+struct hw_timer_t {
+  void (*isr)() = nullptr;
+  uint64_t alarmUs = 0;
+  uint64_t nextUs = 0;    // próxima interrupção no relógio falso
+  bool enabled = false;
+};
+hw_timer_t* timerBegin(uint8_t num, uint16_t divider, bool countUp);
+void timerAttachInterrupt(hw_timer_t* t, void (*isr)(), bool edge);
+void timerWrite(hw_timer_t* t, uint64_t v);
+void timerAlarmWrite(hw_timer_t* t, uint64_t alarmUs, bool autoreload);
+void timerAlarmEnable(hw_timer_t* t);
+void timerAlarmDisable(hw_timer_t* t);
+
+// ==== String (std::string por baixo; aloca como a do core) ====
+class String {
+public:
+  String() {}
+  String(const char* s) : _s(s ? s : "") {}
+  String(const String& o) : _s(o._s) {}
+  String& operator=(const String& o) { _s = o._s; return *this; }
+  String& operator=(const char* s) { _s = s ? s : ""; return *this; }
+  String& operator+=(const char* s) { _s += s; return *this; }
+  String& operator+=(char c) { _s += c; return *this; }
+  String& operator+=(const String& o) { _s += o._s; return *this; }
+  bool reserve(size_t n) { _s.reserve(n); return true; }
+  size_t length() const { return _s.size(); }
+  const char* c_str() const { return _s.c_str(); }
+  bool operator==(const char* s) const { return _s == s; }
+
+private:
+  std::string _s;
+};
+
+// ==== Serial ====
+class HardwareSerial {
+public:
+  void begin(unsigned long) {}
+  int available() { return 0; }
+  int read() { return -1; }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  size_t print(const char* s);
+  size_t println(const char* s = "");
+  size_t println(const String& s) { return println(s.c_str()); }
+};
+extern HardwareSerial Serial;
@@ -0,0 +1,159 @@
+#include "Fake.h"
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <soc/gpio_struct.h>
+#include "sensors/AdcStream.h"
+
+HardwareSerial Serial;
+gpio_dev_t GPIO;
+
+static uint64_t s_nowUs = 0;
+static bool     s_quiet = false;
+static uint8_t  s_mode[Fake::PIN_COUNT];
+static uint8_t  s_input[Fake::PIN_COUNT];
+static uint16_t s_adc[Fake::ADC_CAP];
+static size_t   s_adcHead = 0, s_adcCount = 0;
+static uint32_t s_adcOverruns = 0;
+static hw_timer_t s_timer;
+static bool     s_timerTaken = false;
+
+// ==== controle ====
+void Fake::reset() {
+  s_nowUs = 0;
+  GPIO.out = GPIO.out1 = 0;
+  memset(s_mode, 0, sizeof(s_mode));
+  memset(s_input, HIGH, sizeof(s_input));   // INPUT_PULLUP solto = HIGH
+  s_adcHead = s_adcCount = 0;
+  s_adcOverruns = 0;
+  s_timer = hw_timer_t();
+  s_timerTaken = false;
+}
+
+void Fake::quiet(bool on) { s_quiet = on; }
+
+static bool timerDue(uint64_t untilUs) {
+  return s_timer.enabled && s_timer.isr && s_timer.alarmUs && s_timer.nextUs <= untilUs;
+}
+
+static void fireOne() {
+  s_nowUs = s_timer.nextUs;
+  s_timer.isr();
+  s_timer.nextUs = s_nowUs + s_timer.alarmUs;   // autoreload: alarme escrito na ISR vale já para o próximo
+}
+
+uint64_t Fake::nowUs() { return s_nowUs; }
+
+void Fake::advanceUs(uint64_t us) {
+  const uint64_t until = s_nowUs + us;
+  while (timerDue(until)) fireOne();
+  s_nowUs = until;
+}
+
+void Fake::advanceMs(uint32_t ms) { advanceUs((uint64_t)ms * 1000); }
+
+void Fake::setInput(uint8_t pin, int level) {
+  if (pin < PIN_COUNT) s_input[pin] = level ? HIGH : LOW;
+}
+
+int Fake::output(uint8_t pin) {
+  if (pin >= PIN_COUNT) return LOW;
+  return pin < 32 ? (GPIO.out >> pin) & 1 : (GPIO.out1 >> (pin - 32)) & 1;
+}
+
+uint8_t Fake::mode(uint8_t pin) { return pin < PIN_COUNT ? s_mode[pin] : 0; }
+
+void Fake::pushAdc(uint16_t count, size_t n) {
+  while (n--) {
+    if (s_adcCount == ADC_CAP) {
+      // pool cheio: o driver descarta o mais antigo
+      s_adcHead = (s_adcHead + 1) % ADC_CAP;
+      s_adcCount--;
+      s_adcOverruns++;
+    }
+    s_adc[(s_adcHead + s_adcCount++) % ADC_CAP] = count & 0x0FFF;
+  }
+}
+
+size_t Fake::adcQueued() { return s_adcCount; }
+
+uint32_t Fake::fireTimer(uint32_t n) {
+  uint32_t fired = 0;
+  while (fired < n && timerDue(UINT64_MAX)) {
+    fireOne();
+    fired++;
+  }
+  return fired;
+}
+
+// ==== Arduino ====
+unsigned long millis() { return (unsigned long)(s_nowUs / 1000); }
+unsigned long micros() { return (unsigned long)s_nowUs; }
+void delay(unsigned long ms) { Fake::advanceMs(ms); }
+void delayMicroseconds(unsigned int us) { Fake::advanceUs(us); }
+int64_t esp_timer_get_time() { return (int64_t)s_nowUs; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < Fake::PIN_COUNT) s_mode[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+  const uint32_t bit = 1UL << (pin < 32 ? pin : pin - 32);
+  gpio_w1_t& reg = pin < 32 ? (level ? GPIO.out_w1ts : GPIO.out_w1tc)
+                            : (level ? GPIO.out1_w1ts.val : GPIO.out1_w1tc.val);
+  reg = bit;
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= Fake::PIN_COUNT) return LOW;
+  return s_mode[pin] == OUTPUT ? Fake::output(pin) : s_input[pin];
+}
+
+// um timer só: o firmware usa um (StepperEngine)
+hw_timer_t* timerBegin(uint8_t, uint16_t, bool) {
+  if (s_timerTaken) return nullptr;
+  s_timerTaken = true;
+  return &s_timer;
+}
+void timerAttachInterrupt(hw_timer_t* t, void (*isr)(), bool) { t->isr = isr; }
+void timerWrite(hw_timer_t*, uint64_t) {}
+void timerAlarmWrite(hw_timer_t* t, uint64_t alarmUs, bool) { t->alarmUs = alarmUs; }
+void timerAlarmEnable(hw_timer_t* t) {
+  t->enabled = true;
+  t->nextUs = s_nowUs + t->alarmUs;   // o firmware zera o contador antes (timerWrite 0)
+}
+void timerAlarmDisable(hw_timer_t* t) { t->enabled = false; }
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+  if (s_quiet) return 0;
+  va_list ap;
+  va_start(ap, fmt);
+  const int n = vprintf(fmt, ap);
+  va_end(ap);
+  return n > 0 ? (size_t)n : 0;
+}
+
+size_t HardwareSerial::print(const char* s) { return s_quiet ? 0 : (size_t)fputs(s, stdout); }
+
+size_t HardwareSerial::println(const char* s) {
+  if (s_quiet) return 0;
+  return (size_t)printf("%s\n", s);
+}
+
+// ==== AdcStream falso: entrega o que Fake::pushAdc() enfileirou ====
+bool AdcStream::begin(uint8_t pin) {
+  _channel = pin;
+  _running = true;
+  return true;
+}
+
+size_t AdcStream::read(uint16_t* out, size_t max) {
+  size_t n = 0;
+  while (n < max && s_adcCount) {
+    out[n++] = s_adc[s_adcHead];
+    s_adcHead = (s_adcHead + 1) % Fake::ADC_CAP;
+    s_adcCount--;
+  }
+  return n;
+}
+
+uint32_t AdcStream::overruns() const { return s_adcOverruns; }
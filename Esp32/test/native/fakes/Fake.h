@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Fake — controle da camada falsa do env:native
+ * ---------------------------------------------------------------
+ *  - reset() volta tudo ao estado de boot (chamar no setUp() do teste)
+ *  - Tempo só anda quando o teste manda: advanceUs/advanceMs; com o
+ *    timer de hardware armado, as interrupções vencidas no caminho
+ *    disparam cada uma no seu instante
+ *  - pushAdc() enfileira contagens que o AdcStream falso entrega no
+ *    próximo read(); passou de ADC_CAP sem leitura → conta overrun
+ *  - fireTimer(n) dispara n interrupções do timer de hardware, avançando
+ *    o relógio pelo período armado (StepperEngine)
+ */
+namespace Fake {
+  constexpr size_t ADC_CAP = 4096;
+  constexpr uint8_t PIN_COUNT = 40;
+
+  void reset();
+  void quiet(bool on);   // Serial muda (benchmarks)
+
+  // ---- tempo ----
+  uint64_t nowUs();
+  void advanceUs(uint64_t us);
+  void advanceMs(uint32_t ms);
+
+  // ---- GPIO ----
+  void setInput(uint8_t pin, int level);
+  int output(uint8_t pin);
+  uint8_t mode(uint8_t pin);
+
+  // ---- ADC ----
+  void pushAdc(uint16_t count, size_t n = 1);
+  size_t adcQueued();
+
+  // ---- timer de hardware ----
+  uint32_t fireTimer(uint32_t n);   // interrupções entregues (timer desarmado → para)
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * FirebaseClient.h (env:native) — RTDB de mentira para o RtdbScheduler
+ *  update() não vai a lugar nenhum: conta e guarda o último corpo num
+ *  buffer fixo (sem alocar, para não sujar a contagem do benchmark).
+ *  object_t copia o JSON numa String, como a biblioteca de verdade.
+ */
+class AsyncResult;
+typedef void (*AsyncResultCallback)(AsyncResult&);
+
+class AsyncClientClass {};
+
+class object_t {
+public:
+  object_t() {}
+  explicit object_t(const String& json) : _json(json) {}
+  const char* c_str() const { return _json.c_str(); }
+
+private:
+  String _json;
+};
+
+class RealtimeDatabase {
+public:
+  uint32_t updates = 0;
+  char lastPath[64] = {0};
+  char lastBody[4096] = {0};
+
+  template <typename T>
+  void update(AsyncClientClass&, const char* path, const T& value, AsyncResultCallback, const char*) {
+    updates++;
+    strncpy(lastPath, path, sizeof(lastPath) - 1);
+    strncpy(lastBody, value.c_str(), sizeof(lastBody) - 1);
+  }
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * LiquidCrystal_I2C.h (env:native) — LCD 16x2 de mentira
+ *  Guarda a tela e conta os bytes que iriam para o PCF8574
+ *  (setCursor = 1 comando, write = 1 caractere).
+ */
+class LiquidCrystal_I2C {
+public:
+  static constexpr uint8_t COLS = 16;
+  static constexpr uint8_t ROWS = 2;
+
+  char screen[ROWS][COLS + 1];
+  uint32_t bytes = 0;
+
+  LiquidCrystal_I2C(uint8_t addr = 0x27, uint8_t cols = COLS, uint8_t rows = ROWS) {
+    (void)addr; (void)cols; (void)rows;
+    clear();
+  }
+
+  void init() {}
+  void backlight() {}
+  void clear() {
+    for (uint8_t r = 0; r < ROWS; r++) {
+      memset(screen[r], ' ', COLS);
+      screen[r][COLS] = '\0';
+    }
+    _col = _row = 0;
+    bytes++;
+  }
+  void setCursor(uint8_t col, uint8_t row) {
+    _col = col;
+    _row = row;
+    bytes++;
+  }
+  size_t write(uint8_t c) {
+    if (_row < ROWS && _col < COLS) screen[_row][_col] = (char)c;
+    _col++;
+    bytes++;
+    return 1;
+  }
+  size_t print(const char* s) {
+    size_t n = 0;
+    while (*s) n += write((uint8_t)*s++);
+    return n;
+  }
+
+private:
+  uint8_t _col = 0;
+  uint8_t _row = 0;
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include <stdint.h>
+
+// esp_timer (env:native): mesmo relógio falso do millis()
+int64_t esp_timer_get_time();
+
+// seções críticas viram no-op: os testes rodam numa thread só
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
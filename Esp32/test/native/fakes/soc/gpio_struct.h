@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+
+/**
+ * gpio_struct.h (env:native) — registradores W1TS/W1TC de mentira
+ *  Escrever em out_w1ts liga os bits em out, out_w1tc desliga; o banco
+ *  alto (GPIO 32–39) fica em out1. digitalWrite() usa os mesmos bits.
+ */
+struct gpio_w1_t {
+  uint32_t* reg;
+  bool set;
+  gpio_w1_t& operator=(uint32_t mask) {
+    if (set) *reg |= mask;
+    else *reg &= ~mask;
+    return *this;
+  }
+};
+
+struct gpio_w1_bank_t {
+  gpio_w1_t val;
+};
+
+struct gpio_dev_t {
+  uint32_t out = 0;
+  uint32_t out1 = 0;
+  gpio_w1_t out_w1ts{&out, true};
+  gpio_w1_t out_w1tc{&out, false};
+  gpio_w1_bank_t out1_w1ts{{&out1, true}};
+  gpio_w1_bank_t out1_w1tc{{&out1, false}};
+};
+
+extern gpio_dev_t GPIO;
@@ -0,0 +1,300 @@
+#include "AquaSim.h"
+#include <Fake.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include "core/Clock.h"
+
+namespace AquaSim {
+
+static constexpr float WATER_J_PER_L_K = 4186.0f;
+static constexpr float PROBE_STEP_C = 0.0625f;   // 12 bits
+
+// ==== Report ====
+float Report::outsideBandPct() const {
+  return simMs ? 100.0f * (float)(belowBandMs + aboveBandMs) / (float)simMs : 0.0f;
+}
+
+void Report::print(const char* title) const {
+  const double pct = simMs ? 100.0 / simMs : 0;
+  printf("[SIM] %s: %.1f dias em %.0f ms (%.0fx tempo real), %llu despertares\n", title,
+         (double)simMs / DAY_MS, wallMs, speedup(), (unsigned long long)wakeups);
+  printf("[SIM]   Aquecedor: %u comutacoes, ligado %.1f%% (%.2f kWh), fail-safe %u (%u/%u leituras invalidas)\n",
+         heaterSwitches, heaterOnMs * pct, heaterKWh, failSafeOffs, invalidReadings, samples);
+  printf("[SIM]   Agua: %.2f..%.2f C, fora da faixa %.2f%% (abaixo %.2f%%, acima %.2f%%)\n", minC, maxC,
+         outsideBandPct(), belowBandMs * pct, aboveBandMs * pct);
+  printf("[SIM]   Boia: %u bordas brutas, %u quedas confirmadas (%.1f min baixa), cascata %u comutacoes\n",
+         floatEdges, waterLowEvents, (double)waterLowMs / MINUTE_MS, waterfallSwitches);
+  printf("[SIM]   Alimentador: %u alimentacoes, %u bloqueios, maior intervalo %.2f h\n", feeds, feedsBlocked,
+         (double)maxFeedGapMs / HOUR_MS);
+}
+
+// ==== Simulator ====
+Simulator::Simulator(const Plant& plant, const Control& control, uint32_t seed)
+    : _plant(plant), _ctl(control), _seed(seed ? seed : 1) {}
+
+bool Simulator::add(const Event& e) {
+  if (_scriptCount >= MAX_SCRIPT) return false;
+  _script[_scriptCount++] = e;
+  return true;
+}
+
+bool Simulator::active(const Event& e, uint64_t t) const {
+  return t >= e.atMs && (e.durMs == 0 || t < e.atMs + e.durMs);
+}
+
+float Simulator::roomC(uint64_t t) const {
+  float c = _plant.roomMeanC - _plant.roomSwingC * cosf(2.0f * (float)M_PI * (float)((t + 20 * HOUR_MS) % DAY_MS) / DAY_MS);
+  for (uint8_t i = 0; i < _scriptCount; i++)
+    if (_script[i].kind == Kind::ROOM_STEP && active(_script[i], t)) c += _script[i].value;
+  return c;
+}
+
+int Simulator::floatRaw(uint64_t t) const {
+  int raw = 1;
+  for (uint8_t i = 0; i < _scriptCount; i++) {
+    const Event& e = _script[i];
+    if (!active(e, t)) continue;
+    if (e.kind == Kind::FLOAT_LOW) return 0;
+    if (e.kind == Kind::FLOAT_CHATTER && e.value >= 1.0f)
+      raw = ((t - e.atMs) / (uint64_t)e.value) % 2 ? 1 : 0;
+  }
+  return raw;
+}
+
+// próximo instante em que o roteiro muda alguma coisa (começo, fim, virada do chacoalho)
+uint64_t Simulator::nextScriptEdge(uint64_t t) const {
+  uint64_t next = NEVER;
+  for (uint8_t i = 0; i < _scriptCount; i++) {
+    const Event& e = _script[i];
+    uint64_t at = NEVER;
+    if (t < e.atMs) at = e.atMs;
+    else if (active(e, t)) {
+      if (e.durMs) at = e.atMs + e.durMs;
+      if (e.kind == Kind::FLOAT_CHATTER && e.value >= 1.0f) {
+        const uint64_t p = (uint64_t)e.value;
+        const uint64_t flip = e.atMs + ((t - e.atMs) / p + 1) * p;
+        if (flip < at) at = flip;
+      }
+    }
+    if (at < next) next = at;
+  }
+  return next;
+}
+
+// ~N(0, 1): soma de 4 uniformes (xorshift32), determinístico pela semente
+float Simulator::noise() {
+  float s = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    s += (float)_rng / 4294967296.0f;
+  }
+  return (s - 2.0f) * 1.7320508f;
+}
+
+// ==== planta ====
+void Simulator::stepModel(uint32_t dtMs) {
+  const float dt = dtMs / 1000.0f;
+  const float target = _heater.isOn() ? _plant.heaterW : 0.0f;
+
+  // resistência: 1ª ordem exata no passo; potência média entregue à água
+  float avgW = target;
+  if (_plant.elementTauS > 0) {
+    const float a = expf(-dt / _plant.elementTauS);
+    avgW = target + (_elementW - target) * _plant.elementTauS / dt * (1.0f - a);
+    _elementW = target + (_elementW - target) * a;
+  }
+
+  const float room = roomC(_now + dtMs / 2);
+  _waterC += (avgW - _plant.lossWPerK * (_waterC - room)) * dt / (_plant.liters * WATER_J_PER_L_K);
+
+  if (_heater.isOn()) {
+    _rep.heaterOnMs += dtMs;
+    _rep.heaterKWh += _plant.heaterW * dt / 3.6e6;
+  }
+  if (!_waterOk) _rep.waterLowMs += dtMs;
+  if (_waterC < _rep.minC) _rep.minC = _waterC;
+  if (_waterC > _rep.maxC) _rep.maxC = _waterC;
+  if (_waterC < _ctl.tSet - _ctl.tHyst) _rep.belowBandMs += dtMs;
+  else if (_waterC > _ctl.tSet + _ctl.tHyst) _rep.aboveBandMs += dtMs;
+}
+
+// integra a planta até t e leva o relógio das fakes junto (o timer do
+// motor dispara no caminho)
+void Simulator::advance(uint64_t t) {
+  const uint64_t from = _now;
+  while (_now < t) {
+    const uint32_t dt = (uint32_t)(t - _now < MODEL_STEP_MS ? t - _now : MODEL_STEP_MS);
+    stepModel(dt);
+    _now += dt;
+  }
+  Fake::advanceUs((t - from) * 1000);
+}
+
+// ==== controle: o que o App faz em cada fonte ====
+
+// (A) boia + cascata. Debounce só muda numa borda ou quando vence a
+// confirmação: basta acordar nesses instantes (mesmo resultado de um tick
+// a cada 1 ms)
+void Simulator::pollFloat() {
+  const int raw = floatRaw(_now);
+  if (raw != _raw) {
+    _raw = raw;
+    _rawSince = _now;
+    _rep.floatEdges++;
+  }
+
+  const bool ok = _float.process(raw, (uint32_t)_now) == 1;
+  if (ok != _waterOk) {
+    _waterOk = ok;
+    _waterfall.set(ok);
+    _rep.waterfallSwitches++;
+    if (!ok) _rep.waterLowEvents++;
+    if (ok && _schedule.blocked()) _nextFeed = _now;   // agenda vencida esperando a água
+  }
+
+  _nextFloat = NEVER;
+  if ((raw == 1) != ok) _nextFloat = _rawSince + (raw ? _ctl.highConfirmMs : _ctl.lowConfirmMs);
+}
+
+// (B) leitura da sonda → aquecedor
+void Simulator::readProbe() {
+  float c = _waterC + _plant.sensorNoiseC * noise();
+  c = roundf(c / PROBE_STEP_C) * PROBE_STEP_C;
+  for (uint8_t i = 0; i < _scriptCount; i++) {
+    const Event& e = _script[i];
+    if (!active(e, _now)) continue;
+    if (e.kind == Kind::PROBE_LOST) c = NAN;
+    else if (e.kind == Kind::PROBE_85C) c = 85.0f;
+    else if (e.kind == Kind::PROBE_STUCK) c = _lastGoodC;
+    else if (e.kind == Kind::PROBE_OFFSET) c += e.value;
+  }
+
+  _rep.samples++;
+  if (_heater.valid(c)) _lastGoodC = c;
+  else _rep.invalidReadings++;
+
+  // mesma chamada do App::controlTick (modo AUTO)
+  const HeaterController::Action act = _heater.step(c, true, (unsigned long)_now);
+  if (act != HeaterController::Action::NONE) _rep.heaterSwitches++;
+  if (act == HeaterController::Action::OFF_FAIL_SAFE) _rep.failSafeOffs++;
+}
+
+// (G) fim do movimento do motor
+void Simulator::serviceFeeder() {
+  _feeder.tick();
+  if (_feeder.isBusy()) {
+    _nextFeeder = _now + 1;
+    return;
+  }
+  const uint64_t mono = Clock::monoMillis();
+  if (_rep.feeds) {
+    const uint64_t gap = mono - _rep.lastFeedMs;
+    if (gap > _rep.maxFeedGapMs) _rep.maxFeedGapMs = gap;
+  }
+  _rep.feeds++;
+  _rep.lastFeedMs = mono;
+  _schedule.done(mono);
+  _feeding = false;
+  _nextFeeder = NEVER;
+  _nextFeed = _schedule.dueAt();
+}
+
+// (H) agenda de 12 h
+void Simulator::tryFeed() {
+  _nextFeed = NEVER;
+  if (_feeding) return;
+  const uint64_t mono = Clock::monoMillis();
+  // mesmo passo (H) do App: FeedSchedule::gate
+  switch (_schedule.gate(mono, _feeding, _waterOk)) {
+    case FeedSchedule::Gate::WAIT:
+      // vencida e travada: pollFloat reagenda quando a água voltar
+      if (!_schedule.blocked()) _nextFeed = _schedule.dueAt();
+      return;
+    case FeedSchedule::Gate::BLOCKED:
+      _rep.feedsBlocked++;
+      return;
+    case FeedSchedule::Gate::FEED:
+      break;
+  }
+  if (!_feeder.request(1, _ctl.feedStepsPerPortion, _waterOk, _ctl.feedStepRateHz)) return;
+  _schedule.started();
+  _feeding = true;
+  _nextFeeder = _now + (StepperEngine::moveUs(_ctl.feedStepsPerPortion, _ctl.feedStepRateHz) + 999) / 1000 + 1;
+}
+
+// ==== laço de eventos ====
+const Report& Simulator::run(uint64_t durationMs) {
+  Fake::reset();
+  Fake::quiet(true);
+
+  _rep = Report();
+  _now = 0;
+  _waterC = _plant.startC;
+  _elementW = 0;
+  _lastGoodC = _plant.startC;
+  _rng = _seed;
+  _schedule = FeedSchedule(_ctl.feedIntervalMs);
+  _float = Signal::Pipeline<int, Signal::Debounce<int>>{Signal::Debounce<int>(_ctl.highConfirmMs, _ctl.lowConfirmMs)};
+
+  _heater = HeaterController();
+  _waterfall = WaterfallController();
+  _feeder = FeederController();
+  _heater.begin(PIN_RELAY_HEATER, RELAY_ACTIVE_LOW);
+  HeaterController::Config hc;
+  hc.setC = _ctl.tSet;
+  hc.hystC = _ctl.tHyst;
+  hc.minSwitchMs = _ctl.minSwitchMs;
+  _heater.configure(hc);
+  _waterfall.begin(PIN_RELAY_WATERFALL, RELAY_ACTIVE_LOW);
+  _feeder.begin(FEED_IN1, FEED_IN2, FEED_IN3, FEED_IN4);
+
+  _raw = floatRaw(0);
+  _rawSince = 0;
+  _waterOk = _float.process(_raw, 0) == 1;
+  if (!_waterOk) _waterfall.set(false);
+  _feeding = false;
+
+  // App: primeira amostra um SAMPLE_MS depois do boot; alimenta no boot
+  _nextSample = _ctl.sampleMs;
+  _nextRead = NEVER;
+  _nextFloat = NEVER;
+  _nextFeed = 0;
+  _nextFeeder = NEVER;
+
+  const std::chrono::steady_clock::time_point w0 = std::chrono::steady_clock::now();
+  for (;;) {
+    uint64_t t = durationMs;
+    const uint64_t edge = nextScriptEdge(_now);
+    const uint64_t next[] = {_nextSample, _nextRead, _nextFloat, _nextFeed, _nextFeeder, edge};
+    for (uint64_t n : next)
+      if (n < t) t = n;
+    if (t < _now) t = _now;
+
+    advance(t);
+    if (_now >= durationMs) break;
+    _rep.wakeups++;
+
+    // mesma ordem do controlTick: boia, temperatura, motor, agenda
+    if (edge <= _now || _nextFloat <= _now) pollFloat();
+    if (_nextSample <= _now) {
+      _nextSample = _now + _ctl.sampleMs;
+      _nextRead = _now + CONVERT_MS;
+    }
+    if (_nextRead <= _now) {
+      _nextRead = NEVER;
+      readProbe();
+    }
+    if (_nextFeeder <= _now) serviceFeeder();
+    if (_nextFeed <= _now) tryFeed();
+  }
+  _rep.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - w0).count();
+  _rep.simMs = _now;
+
+  Fake::quiet(false);
+  return _rep;
+}
+
+}  // namespace AquaSim
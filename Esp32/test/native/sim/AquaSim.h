@@ -0,0 +1,166 @@
+#pragma once
+#include <stdint.h>
+#include "config/Thresholds.h"
+#include "config/Pins.h"
+#include "core/SignalPipeline.h"
+#include "control/HeaterController.h"
+#include "control/WaterfallController.h"
+#include "control/FeederController.h"
+#include "control/FeedSchedule.h"
+
+/**
+ * AquaSim — simulador de eventos discretos do laço de controle (env:native)
+ * ---------------------------------------------------------------
+ *  - Relógio virtual = relógio das fakes: millis(), Clock::monoMillis() e
+ *    o timer do motor de passo andam juntos, só quando o simulador manda
+ *  - Controle de verdade: HeaterController (histerese, anti bate-bate,
+ *    fail-safe), Debounce da boia com os tempos do App,
+ *    WaterfallController, FeederController/StepperEngine e FeedSchedule
+ *  - Planta: tanque + resistência (com inércia térmica) + sala com ciclo
+ *    dia/noite; DS18B20 com ruído, passo de 1/16 °C e 750 ms de conversão
+ *  - Roteiro: boia baixa ou chacoalhando, falhas da sonda, degrau na sala
+ *  - Só acorda nos instantes em que algo pode mudar (amostra, leitura,
+ *    boia, agenda, fim do motor, roteiro); entre eles integra o modelo
+ *    térmico em passos de até MODEL_STEP_MS. Semanas rodam em segundos
+ *  - Usa as fakes: chama Fake::reset() no início de cada run()
+ */
+namespace AquaSim {
+
+constexpr uint64_t MINUTE_MS = 60000ULL;
+constexpr uint64_t HOUR_MS = 60ULL * MINUTE_MS;
+constexpr uint64_t DAY_MS = 24ULL * HOUR_MS;
+
+// ==== planta ====
+struct Plant {
+  float liters = 100.0f;
+  float heaterW = 150.0f;
+  float lossWPerK = 3.5f;       // tanque → sala (vidro, sem tampa)
+  float elementTauS = 90.0f;    // resistência de vidro: esquenta/esfria depois do relé
+  float roomMeanC = 22.0f;
+  float roomSwingC = 2.0f;      // amplitude dia/noite; mínima às 4 h
+  float startC = 25.5f;
+  float sensorNoiseC = 0.03f;   // desvio do ruído da sonda
+};
+
+// ==== parâmetros do controle (padrão: config/Thresholds.h) ====
+struct Control {
+  float tSet = T_SET;
+  float tHyst = T_HYST;
+  uint32_t minSwitchMs = MIN_SWITCH_MS;
+  uint32_t sampleMs = SAMPLE_MS;
+  uint32_t lowConfirmMs = T_LOW_CONFIRM_MS;     // boia: confirma a queda
+  uint32_t highConfirmMs = T_HIGH_CONFIRM_MS;   // boia: confirma a volta
+  uint64_t feedIntervalMs = FEED_INTERVAL_MS;
+  int feedStepsPerPortion = FEED_STEPS_PER_PORTION;
+  uint16_t feedStepRateHz = FEED_STEP_RATE_HZ;
+};
+
+// ==== roteiro ====
+enum class Kind : uint8_t {
+  FLOAT_LOW,       // boia em nível baixo durante durMs
+  FLOAT_CHATTER,   // boia alterna a cada value ms (onda, bolha) durante durMs
+  PROBE_LOST,      // sonda some: NAN
+  PROBE_85C,       // leitura de power-on do DS18B20 (85 °C)
+  PROBE_STUCK,     // repete a última leitura boa
+  PROBE_OFFSET,    // soma value °C à leitura
+  ROOM_STEP,       // soma value °C à sala (janela aberta, ar-condicionado)
+};
+
+struct Event {
+  uint64_t atMs;
+  uint64_t durMs;   // 0 = até o fim
+  Kind kind;
+  float value;
+};
+
+// ==== resultado ====
+struct Report {
+  uint64_t simMs = 0;
+  double wallMs = 0;
+  uint64_t wakeups = 0;           // instantes em que o simulador acordou
+
+  uint32_t samples = 0;
+  uint32_t invalidReadings = 0;   // NAN ou fora de [T_MIN_SAFE, T_MAX_SAFE]
+  uint32_t heaterSwitches = 0;
+  uint32_t failSafeOffs = 0;      // desligado por leitura inválida
+  uint64_t heaterOnMs = 0;
+  double heaterKWh = 0;
+
+  float minC = 1e9f, maxC = -1e9f;   // água (modelo, não a leitura)
+  uint64_t belowBandMs = 0;          // < tSet - tHyst
+  uint64_t aboveBandMs = 0;          // > tSet + tHyst
+
+  uint32_t floatEdges = 0;        // bordas brutas da boia
+  uint32_t waterLowEvents = 0;    // quedas confirmadas pelo debounce
+  uint64_t waterLowMs = 0;
+  uint32_t waterfallSwitches = 0;
+
+  uint32_t feeds = 0;
+  uint32_t feedsBlocked = 0;      // episódios: agenda vencida com nível baixo
+  uint64_t lastFeedMs = 0;
+  uint64_t maxFeedGapMs = 0;
+
+  float outsideBandPct() const;
+  double speedup() const { return wallMs > 0 ? simMs / wallMs : 0; }
+  void print(const char* title) const;
+};
+
+// ==== simulador ====
+class Simulator {
+public:
+  static constexpr uint8_t MAX_SCRIPT = 32;
+  static constexpr uint32_t MODEL_STEP_MS = 5000;
+  static constexpr uint32_t CONVERT_MS = 750;    // DS18B20 em 12 bits
+
+  explicit Simulator(const Plant& plant = Plant(), const Control& control = Control(), uint32_t seed = 1);
+
+  bool add(const Event& e);   // false: roteiro cheio
+  const Report& run(uint64_t durationMs);
+  const Report& report() const { return _rep; }
+
+private:
+  static constexpr uint64_t NEVER = UINT64_MAX;
+
+  Plant _plant;
+  Control _ctl;
+  uint32_t _seed;
+  Event _script[MAX_SCRIPT];
+  uint8_t _scriptCount = 0;
+  Report _rep;
+
+  // controle
+  HeaterController _heater;
+  WaterfallController _waterfall;
+  FeederController _feeder;
+  FeedSchedule _schedule{FEED_INTERVAL_MS};
+  Signal::Pipeline<int, Signal::Debounce<int>> _float{Signal::Debounce<int>(T_HIGH_CONFIRM_MS, T_LOW_CONFIRM_MS)};
+  bool _waterOk = true;
+  bool _feeding = false;
+
+  // planta
+  uint64_t _now = 0;
+  float _waterC = 0;
+  float _elementW = 0;
+  float _lastGoodC = 0;
+  uint32_t _rng = 1;
+
+  // próximos instantes de cada fonte de eventos
+  uint64_t _nextSample = 0, _nextRead = 0, _nextFloat = 0, _nextFeed = 0, _nextFeeder = 0;
+  int _raw = 1;
+  uint64_t _rawSince = 0;
+
+  bool active(const Event& e, uint64_t t) const;
+  float roomC(uint64_t t) const;
+  int floatRaw(uint64_t t) const;
+  uint64_t nextScriptEdge(uint64_t t) const;
+  float noise();
+
+  void advance(uint64_t t);
+  void stepModel(uint32_t dtMs);
+  void pollFloat();
+  void readProbe();
+  void serviceFeeder();
+  void tryFeed();
+};
+
+}  // namespace AquaSim
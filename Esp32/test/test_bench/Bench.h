@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+
+/**
+ * Bench — microbenchmark no host: ns/op e alocações/op
+ * ---------------------------------------------------------------
+ *  - run("nome", fn) aquece, depois dobra as iterações até a medida
+ *    passar de MIN_NS; fica a melhor de ROUNDS medidas (menos ruído do SO)
+ *  - Alocações: operator new global contado (no test_main.cpp); um
+ *    caminho quente do firmware deve dar 0
+ *  - ns/op é do host (x86/ARM de desenvolvimento): serve para comparar
+ *    antes/depois de uma mudança, não para prever µs no ESP32
+ */
+namespace Bench {
+  constexpr uint64_t MIN_NS = 20000000;   // 20 ms por medida
+  constexpr uint8_t ROUNDS = 3;
+
+  struct Result {
+    const char* name;
+    uint64_t iters;
+    double nsPerOp;
+    double allocsPerOp;
+  };
+
+  uint64_t allocations();   // contador global do operator new
+
+  // impede o compilador de descartar o resultado
+  template <typename T>
+  inline void keep(const T& v) { asm volatile("" : : "g"(&v) : "memory"); }
+
+  template <typename Fn>
+  Result run(const char* name, Fn fn) {
+    using clock = std::chrono::steady_clock;
+    for (int i = 0; i < 1000; i++) fn();
+
+    Result best{name, 0, 1e30, 0.0};
+    for (uint8_t r = 0; r < ROUNDS; r++) {
+      uint64_t iters = 1000;
+      for (;;) {
+        const uint64_t a0 = allocations();
+        const clock::time_point t0 = clock::now();
+        for (uint64_t i = 0; i < iters; i++) fn();
+        const uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count();
+        const uint64_t allocs = allocations() - a0;
+        if (ns < MIN_NS) { iters *= 2; continue; }
+        const double perOp = (double)ns / iters;
+        if (perOp < best.nsPerOp) best = Result{name, iters, perOp, (double)allocs / iters};
+        break;
+      }
+    }
+    printf("[BENCH] %-40s %10.1f ns/op %8.3f aloc/op  (%llu it)\n", best.name, best.nsPerOp,
+           best.allocsPerOp, (unsigned long long)best.iters);
+    return best;
+  }
+}
@@ -0,0 +1,296 @@
+// Microbenchmarks dos caminhos quentes do firmware (env:native):
+//   pio test -e native -f test_bench -v
+// Cada caso imprime ns/op e alocações/op; o teste falha se um caminho que
+// deve ser sem heap passar a alocar.
+#include <unity.h>
+#include <Fake.h>
+#include <FirebaseClient.h>
+#include <LiquidCrystal_I2C.h>
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+#include "Bench.h"
+#include "config/Thresholds.h"
+#include "core/SpscQueue.h"
+#include "core/SignalPipeline.h"
+#include "core/WindowStats.h"
+#include "core/SeriesCodec.h"
+#include "core/LoopProfiler.h"
+#include "core/JsonScan.h"
+#include "core/RtdbPaths.h"
+#include "actuators/FastGpio.h"
+#include "control/HeaterController.h"
+#include "sensors/PhSensor.h"
+#include "io/RtdbScheduler.h"
+#include "io/ShadowState.h"
+#include "io/BurstScheduler.h"
+#include "ui/LcdFrame.h"
+
+// ==== contagem de alocações ====
+static std::atomic<uint64_t> s_allocs{0};
+uint64_t Bench::allocations() { return s_allocs.load(std::memory_order_relaxed); }
+
+void* operator new(size_t n) {
+  s_allocs.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+using Prio = RtdbScheduler::Prio;
+
+void setUp() {
+  Fake::reset();
+  Fake::quiet(true);
+}
+void tearDown() { Fake::quiet(false); }
+
+static void expectNoHeap(const Bench::Result& r) { TEST_ASSERT_EQUAL_FLOAT(0.0, r.allocsPerOp); }
+
+// ==== sensores / filtros ====
+void bench_ph_poll_64_samples() {
+  PhSensor ph;
+  ph.begin(34);
+  expectNoHeap(Bench::run("PhSensor::poll (64 amostras)", [&] {
+    Fake::pushAdc(2048, 64);
+    ph.poll();
+  }));
+}
+
+void bench_ph_read_volts_full_ring() {
+  PhSensor ph;
+  ph.begin(34);
+  srand(1);
+  for (int i = 0; i < PhSensor::RING * PhSensor::OVERSAMPLE; i++) Fake::pushAdc(2000 + rand() % 100);
+  ph.poll();
+  expectNoHeap(Bench::run("PhSensor::readVolts (anel 256)", [&] { Bench::keep(ph.readVolts()); }));
+}
+
+void bench_ph_filter_pipeline() {
+  Signal::Pipeline<float, Signal::Ema, Signal::Linear, Signal::Clamp<float>> f{
+      Signal::Ema(ALPHA_PH), Signal::Linear(M_PH, B_PH), Signal::Clamp<float>(PH_MIN, PH_MAX)};
+  float x = 2.5f;
+  expectNoHeap(Bench::run("Signal::Pipeline pH (3 estagios)", [&] {
+    x += 0.0001f;
+    Bench::keep(f.process(x));
+  }));
+}
+
+void bench_float_debounce() {
+  Signal::Pipeline<int, Signal::Debounce<int>> f{Signal::Debounce<int>(T_HIGH_CONFIRM_MS, T_LOW_CONFIRM_MS)};
+  uint32_t now = 0;
+  expectNoHeap(Bench::run("Signal::Debounce (boia)", [&] {
+    now++;
+    Bench::keep(f.process((now >> 11) & 1, now));
+  }));
+}
+
+void bench_heater_update() {
+  HeaterController h;
+  h.begin(26, true);
+  unsigned long now = 0;
+  expectNoHeap(Bench::run("HeaterController::step", [&] {
+    now += 1000;
+    const float t = T_SET + ((now / 60000) % 2 ? 1.5f : -1.5f);
+    Bench::keep(h.step(t, true, now));
+  }));
+}
+
+// ==== agregação ====
+void bench_window_stats_add() {
+  WindowStats w;
+  float x = 25.0f;
+  uint32_t i = 0;
+  expectNoHeap(Bench::run("WindowStats::add", [&] {
+    if (++i % 4096 == 0) w.reset();
+    x = 25.0f + (float)(i % 97) * 0.01f;
+    w.add(x);
+  }));
+}
+
+void bench_window_stats_summary_json() {
+  WindowStats w;
+  for (int i = 0; i < 500; i++) w.add(25.0f + (i % 37) * 0.02f);
+  char json[RtdbScheduler::VALUE_LEN];
+  expectNoHeap(Bench::run("WindowStats::summary + toJson", [&] {
+    Bench::keep(WindowStats::toJson(w.summary(), json, sizeof(json)));
+  }));
+}
+
+void bench_series_append_base64() {
+  SeriesCodec::Encoder enc;
+  char b64[128];
+  uint64_t t = 1700000000000ULL;
+  float v = 25.0f;
+  expectNoHeap(Bench::run("SeriesCodec append + base64", [&] {
+    t += 300000;
+    v += 0.01f;
+    if (enc.empty() || !enc.append(t, v)) enc.begin(t, v, 2);
+    Bench::keep(enc.toBase64(b64, sizeof(b64)));
+  }));
+}
+
+// ==== publicação ====
+void bench_pathbuf_series_path() {
+  uint64_t t0 = 1700000000000ULL;
+  expectNoHeap(Bench::run("PathBuf series/<nome>/<t0>", [&] {
+    PathBuf<RtdbScheduler::PATH_LEN> p(RtdbPaths::SERIES);
+    p.add("temperatura").add('/').addU64(++t0);
+    Bench::keep(p.length());
+  }));
+}
+
+void bench_sched_set_float_merge() {
+  RtdbScheduler s;
+  float v = 25.0f;
+  expectNoHeap(Bench::run("RtdbScheduler::setFloat (merge)", [&] {
+    v += 0.01f;
+    s.setFloat(RtdbPaths::TEMP_CURRENT, v, Prio::TELEMETRY, 2);
+  }));
+}
+
+void bench_sched_flush_16() {
+  static const char* const paths[] = {
+      RtdbPaths::RELAY_HEATER, RtdbPaths::RELAY_WATERFALL, RtdbPaths::WATER_OK, RtdbPaths::HEATER_STATE,
+      RtdbPaths::WATERFALL_STATE, RtdbPaths::TEMP_CURRENT, RtdbPaths::PH_CURRENT, RtdbPaths::LAST_SEEN,
+      RtdbPaths::FEEDER_BUSY, RtdbPaths::FEEDER_LAST_TS, RtdbPaths::HEATER_MODE, RtdbPaths::HEATER_ON_NOW,
+      RtdbPaths::WATERFALL_MODE, RtdbPaths::WATERFALL_ON_NOW, RtdbPaths::FEED_NOW, RtdbPaths::FEEDER_STEPS,
+  };
+  RtdbScheduler s;
+  RealtimeDatabase db;
+  AsyncClientClass client;
+  uint32_t now = 0;
+  // object_t copia o JSON numa String (como a biblioteca): 1 alocação por update
+  const Bench::Result r = Bench::run("RtdbScheduler 16 set + flush", [&] {
+    for (uint8_t i = 0; i < 16; i++) s.setInt(paths[i], (long)(now + i), i < 8 ? Prio::CONTROL : Prio::LOGS);
+    s.flush(db, client, nullptr, "b", ++now);
+    s.onResult(s.lastUid(), true);
+  });
+  TEST_ASSERT_TRUE(r.allocsPerOp <= 1.0);
+}
+
+void bench_shadow_suppressed() {
+  RtdbScheduler s;
+  ShadowState sh;
+  sh.define(0, RtdbPaths::PH_CURRENT, Prio::TELEMETRY, 0.02f, 600000);
+  sh.publishFloat(s, 0, 7.0f, 0);
+  uint32_t now = 0;
+  expectNoHeap(Bench::run("ShadowState::publishFloat (zona morta)", [&] {
+    now++;
+    Bench::keep(sh.publishFloat(s, 0, 7.0f + (now % 10) * 0.001f, now));
+  }));
+}
+
+void bench_json_scan_stream_event() {
+  const char* ev = "{\"feeder\":{\"feed_now\":false},\"heater\":{\"mode\":\"auto\",\"turn_on_now\":false},"
+                   "\"waterfall\":{\"mode\":\"manual\",\"turn_on_now\":true}}";
+  char out[16];
+  expectNoHeap(Bench::run("JsonScan::find (snapshot do stream)", [&] {
+    Bench::keep(JsonScan::find(ev, "waterfall/turn_on_now", out, sizeof(out)));
+  }));
+}
+
+// ==== atuadores ====
+// fase do 28BYJ-48 (IN1..IN4 = 25, 26, 27, 33): os dois bancos de GPIO
+static const uint8_t COIL[4] = {25, 26, 27, 33};
+
+void bench_gpio_digitalwrite_x4() {
+  for (uint8_t p : COIL) pinMode(p, OUTPUT);
+  uint32_t i = 0;
+  expectNoHeap(Bench::run("digitalWrite x4 (fase do motor)", [&] {
+    const uint8_t seq = (uint8_t)(1u << (++i & 3));
+    for (uint8_t c = 0; c < 4; c++) digitalWrite(COIL[c], (seq >> c) & 1);
+  }));
+}
+
+void bench_gpio_fastgpio_apply() {
+  FastGpio::Mask all, on[4];
+  for (uint8_t c = 0; c < 4; c++) {
+    pinMode(COIL[c], OUTPUT);
+    all.add(COIL[c]);
+    on[c].add(COIL[c]);
+  }
+  uint32_t i = 0;
+  expectNoHeap(Bench::run("FastGpio::apply (fase do motor)", [&] {
+    const FastGpio::Mask& set = on[++i & 3];
+    FastGpio::apply(set, all & ~set);
+  }));
+}
+
+// ==== infraestrutura do loop ====
+void bench_spsc_push_pop() {
+  struct Ev { uint8_t kind; float value; uint64_t mono; };
+  SpscQueue<Ev, 32> q;
+  Ev e{1, 25.0f, 0}, out;
+  expectNoHeap(Bench::run("SpscQueue push + pop", [&] {
+    e.mono++;
+    q.push(e);
+    q.pop(out);
+    Bench::keep(out);
+  }));
+}
+
+void bench_profiler_record() {
+  static const char* const names[] = {"a", "b"};
+  LoopProfiler p;
+  p.begin(names, 2);
+  uint32_t us = 0;
+  expectNoHeap(Bench::run("LoopProfiler::record", [&] {
+    us++;
+    p.record(us & 1, us % 5000);
+  }));
+}
+
+void bench_lcd_frame_one_digit() {
+  LiquidCrystal_I2C lcd;
+  LcdFrame f;
+  f.begin(&lcd);
+  char l1[17];
+  uint32_t i = 0;
+  expectNoHeap(Bench::run("LcdFrame setLine + flush (1 digito)", [&] {
+    snprintf(l1, sizeof(l1), "T:25.%luC pH:7.02", (unsigned long)(++i % 10));
+    f.setLine(0, l1);
+    f.setLine(1, "HTR:OFF");
+    Bench::keep(f.flush(1000));
+  }));
+}
+
+void bench_burst_tick() {
+  BurstScheduler b;
+  b.begin(0);
+  b.setManaged(true, 0);
+  uint32_t now = 0;
+  expectNoHeap(Bench::run("BurstScheduler::tick", [&] {
+    now += 2;
+    b.tick(now, (now % 60000) == 0, b.open() && (now % 10000) < 500);
+    Bench::keep(b.periodicDue());
+  }));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(bench_ph_poll_64_samples);
+  RUN_TEST(bench_ph_read_volts_full_ring);
+  RUN_TEST(bench_ph_filter_pipeline);
+  RUN_TEST(bench_float_debounce);
+  RUN_TEST(bench_heater_update);
+  RUN_TEST(bench_gpio_digitalwrite_x4);
+  RUN_TEST(bench_gpio_fastgpio_apply);
+  RUN_TEST(bench_window_stats_add);
+  RUN_TEST(bench_window_stats_summary_json);
+  RUN_TEST(bench_series_append_base64);
+  RUN_TEST(bench_pathbuf_series_path);
+  RUN_TEST(bench_sched_set_float_merge);
+  RUN_TEST(bench_sched_flush_16);
+  RUN_TEST(bench_shadow_suppressed);
+  RUN_TEST(bench_json_scan_stream_event);
+  RUN_TEST(bench_spsc_push_pop);
+  RUN_TEST(bench_profiler_record);
+  RUN_TEST(bench_lcd_frame_one_digit);
+  RUN_TEST(bench_burst_tick);
+  return UNITY_END();
+}
@@ -0,0 +1,233 @@
+// Controle e sensores sobre o GPIO/ADC/timer falsos: aquecedor, cascata,
+// alimentador (motor de passo) e pH. Roda no env:native.
+#include <unity.h>
+#include <Fake.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "config/Thresholds.h"
+#include "control/HeaterController.h"
+#include "control/WaterfallController.h"
+#include "control/FeederController.h"
+#include "control/FeedSchedule.h"
+#include "core/Clock.h"
+#include "sensors/PhSensor.h"
+
+static const uint8_t PIN_HEATER = 26;
+static const uint8_t PIN_CASCATA = 27;
+static const uint8_t PIN_COIL[4] = {14, 12, 13, 33};   // um no banco alto
+
+void setUp() {
+  Fake::reset();
+  Fake::quiet(true);
+}
+void tearDown() { Fake::quiet(false); }
+
+// ==== HeaterController ====
+using Action = HeaterController::Action;
+
+void test_heater_hysteresis_and_min_switch() {
+  HeaterController h;
+  h.begin(PIN_HEATER, true);
+  TEST_ASSERT_EQUAL_INT(HIGH, Fake::output(PIN_HEATER));   // ativo baixo: desligado
+
+  TEST_ASSERT_EQUAL(Action::NONE, h.step(T_SET, true, MIN_SWITCH_MS));
+  TEST_ASSERT_EQUAL(Action::ON_BELOW, h.step(T_SET - T_HYST - 0.1f, true, MIN_SWITCH_MS));
+  TEST_ASSERT_TRUE(h.isOn());
+  TEST_ASSERT_EQUAL_INT(LOW, Fake::output(PIN_HEATER));
+
+  // passou do limite, mas ainda dentro do anti bate-bate
+  TEST_ASSERT_EQUAL(Action::NONE, h.step(T_SET + T_HYST + 0.1f, true, 2 * MIN_SWITCH_MS - 1));
+  TEST_ASSERT_EQUAL(Action::OFF_ABOVE, h.step(T_SET + T_HYST + 0.1f, true, 2 * MIN_SWITCH_MS));
+  TEST_ASSERT_FALSE(h.isOn());
+}
+
+void test_heater_off_on_invalid_reading() {
+  HeaterController h;
+  h.begin(PIN_HEATER, true);
+  h.step(20.0f, true, MIN_SWITCH_MS);
+  TEST_ASSERT_TRUE(h.isOn());
+  // sensor solto: desliga na hora, sem esperar o anti bate-bate
+  TEST_ASSERT_EQUAL(Action::OFF_FAIL_SAFE, h.step(NAN, true, MIN_SWITCH_MS + 1));
+  TEST_ASSERT_FALSE(h.isOn());
+  TEST_ASSERT_EQUAL(Action::NONE, h.step(T_MAX_SAFE + 1.0f, true, 10 * MIN_SWITCH_MS));
+  TEST_ASSERT_FALSE(h.isOn());
+}
+
+void test_heater_manual_mode_keeps_only_fail_safe() {
+  HeaterController h;
+  h.begin(PIN_HEATER, true);
+  h.set(true);   // comando manual
+  TEST_ASSERT_EQUAL(Action::NONE, h.step(T_SET + 3.0f, false, 10 * MIN_SWITCH_MS));
+  TEST_ASSERT_TRUE(h.isOn());
+  TEST_ASSERT_EQUAL(Action::OFF_FAIL_SAFE, h.step(85.0f, false, 10 * MIN_SWITCH_MS + 1));
+  TEST_ASSERT_EQUAL_INT(HIGH, Fake::output(PIN_HEATER));
+
+  // faixa ajustada (a mesma Config que o AquaSim varre)
+  HeaterController::Config c;
+  c.setC = 24.0f;
+  c.hystC = 0.25f;
+  h.configure(c);
+  TEST_ASSERT_EQUAL(Action::ON_BELOW, h.step(23.7f, true, 20 * MIN_SWITCH_MS));
+}
+
+// ==== FeedSchedule (passo (H) do App) ====
+void test_feed_gate_blocks_once_until_water_returns() {
+  using Gate = FeedSchedule::Gate;
+  FeedSchedule f(1000);
+  TEST_ASSERT_EQUAL(Gate::FEED, f.gate(0, false, true));   // primeira sai no boot
+  f.started();
+  TEST_ASSERT_EQUAL(Gate::WAIT, f.gate(10, true, true));   // motor girando
+  f.done(100);
+  TEST_ASSERT_EQUAL(Gate::WAIT, f.gate(1099, false, true));
+
+  // vencida com nível baixo: um aviso por episódio, não um por tick
+  TEST_ASSERT_EQUAL(Gate::BLOCKED, f.gate(1100, false, false));
+  for (uint64_t t = 1101; t < 1200; t++) TEST_ASSERT_EQUAL(Gate::WAIT, f.gate(t, false, false));
+  TEST_ASSERT_EQUAL(Gate::FEED, f.gate(1200, false, true));   // água voltou
+  f.started();
+  f.done(1300);
+  TEST_ASSERT_EQUAL(Gate::BLOCKED, f.gate(2300, false, false));   // episódio novo
+}
+
+// ==== WaterfallController ====
+void test_waterfall_float_debounce() {
+  WaterfallController w;
+  w.begin(PIN_CASCATA);
+  TEST_ASSERT_TRUE(w.isOn());
+  TEST_ASSERT_EQUAL_INT(LOW, Fake::output(PIN_CASCATA));
+
+  bool ok = false;
+  w.processFloatRaw(1, 0, ok);             // semeia: água OK
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_FALSE(w.processFloatRaw(0, 100, ok));
+  TEST_ASSERT_FALSE(w.processFloatRaw(0, 1099, ok));
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_TRUE(w.processFloatRaw(0, 1100, ok));   // desce em 1 s
+  TEST_ASSERT_FALSE(ok);
+  TEST_ASSERT_FALSE(w.processFloatRaw(1, 1200, ok));
+  TEST_ASSERT_TRUE(w.processFloatRaw(1, 3200, ok));   // sobe em 2 s
+  TEST_ASSERT_TRUE(ok);
+
+  w.forceOff();
+  TEST_ASSERT_FALSE(w.isOn());
+  TEST_ASSERT_EQUAL_INT(HIGH, Fake::output(PIN_CASCATA));
+}
+
+// ==== FeederController / StepperEngine ====
+void test_feeder_blocked_without_water() {
+  FeederController f;
+  f.begin(PIN_COIL[0], PIN_COIL[1], PIN_COIL[2], PIN_COIL[3]);
+  TEST_ASSERT_FALSE(f.request(1, 8, false));
+  TEST_ASSERT_FALSE(f.isBusy());
+}
+
+void test_feeder_runs_steps_from_timer() {
+  FeederController f;
+  f.begin(PIN_COIL[0], PIN_COIL[1], PIN_COIL[2], PIN_COIL[3]);
+  Clock::sync(1700000000000ULL, Clock::monoMillis());
+
+  TEST_ASSERT_TRUE(f.request(2, 8, true, 500));
+  TEST_ASSERT_TRUE(f.isBusy());
+  TEST_ASSERT_FALSE(f.request(1, 8, true));   // ocupado
+
+  // meio-passo: IN1+IN2, depois só IN2 (IN4 fica no banco alto)
+  TEST_ASSERT_EQUAL_UINT32(1, Fake::fireTimer(1));
+  TEST_ASSERT_EQUAL_INT(HIGH, Fake::output(PIN_COIL[0]));
+  TEST_ASSERT_EQUAL_INT(HIGH, Fake::output(PIN_COIL[1]));
+  TEST_ASSERT_EQUAL_INT(LOW, Fake::output(PIN_COIL[2]));
+  TEST_ASSERT_EQUAL_INT(LOW, Fake::output(PIN_COIL[3]));
+  Fake::fireTimer(1);
+  TEST_ASSERT_EQUAL_INT(LOW, Fake::output(PIN_COIL[0]));
+  TEST_ASSERT_EQUAL_INT(HIGH, Fake::output(PIN_COIL[1]));
+
+  Fake::fireTimer(14);
+  f.tick();
+  TEST_ASSERT_FALSE(f.isBusy());
+  TEST_ASSERT_EQUAL_UINT64(Clock::epochMillis(), f.lastTimestamp());
+  // fim do movimento: bobinas soltas
+  for (uint8_t p : PIN_COIL) TEST_ASSERT_EQUAL_INT(LOW, Fake::output(p));
+  // 16 passos saindo de 400 Hz rumo a 500 Hz
+  TEST_ASSERT_EQUAL_UINT64(StepperEngine::moveUs(16, 500), Fake::nowUs());
+  TEST_ASSERT_TRUE(Fake::nowUs() > 16 * 2000 && Fake::nowUs() < 16 * 2500);
+}
+
+void test_stepper_ramps_up_from_pull_in_rate() {
+  StepperEngine e;
+  e.begin(PIN_COIL[0], PIN_COIL[1], PIN_COIL[2], PIN_COIL[3]);
+  const uint32_t steps = 2 * StepperEngine::RAMP_STEPS;
+  TEST_ASSERT_TRUE(e.move(steps, 800));
+
+  // 1º passo na taxa de partida; período cai a cada meio-passo até 1250 µs
+  uint64_t t0 = Fake::nowUs();
+  Fake::fireTimer(1);
+  TEST_ASSERT_EQUAL_UINT64(1000000 / StepperEngine::RAMP_START_HZ, Fake::nowUs() - t0);
+  uint64_t prev = Fake::nowUs() - t0;
+  for (uint16_t i = 1; i < StepperEngine::RAMP_STEPS; i++) {
+    t0 = Fake::nowUs();
+    Fake::fireTimer(1);
+    TEST_ASSERT_TRUE(Fake::nowUs() - t0 < prev);
+    prev = Fake::nowUs() - t0;
+  }
+  for (uint16_t i = 0; i < StepperEngine::RAMP_STEPS; i++) {
+    t0 = Fake::nowUs();
+    Fake::fireTimer(1);
+    TEST_ASSERT_EQUAL_UINT64(1250, Fake::nowUs() - t0);
+  }
+  TEST_ASSERT_EQUAL(StepperEngine::Event::DONE, e.poll());
+  TEST_ASSERT_EQUAL_UINT64(StepperEngine::moveUs(steps, 800), Fake::nowUs());
+
+  // abaixo da partida: sem rampa
+  TEST_ASSERT_EQUAL_UINT32(10 * 4000, StepperEngine::moveUs(10, 250));
+}
+
+// ==== PhSensor ====
+void test_trimmed_mean_matches_sorted_reference() {
+  uint16_t v[257], ref[257];
+  srand(11);
+  for (int round = 0; round < 200; round++) {
+    const size_t n = 1 + rand() % 257;
+    for (size_t i = 0; i < n; i++) v[i] = ref[i] = (uint16_t)(rand() % 65536);
+    std::sort(ref, ref + n);
+    size_t k = n * PhSensor::TRIM_PCT / 100;
+    if (2 * k >= n) k = (n - 1) / 2;
+    double sum = 0;
+    for (size_t i = k; i < n - k; i++) sum += ref[i];
+    uint16_t spread = 0;
+    const float got = PhSensor::trimmedMean(v, n, PhSensor::TRIM_PCT, &spread);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, (float)(sum / (n - 2 * k)), got);
+    TEST_ASSERT_EQUAL_UINT16(ref[n - k - 1] - ref[k], spread);
+  }
+}
+
+void test_ph_from_adc_rejects_spikes() {
+  PhSensor ph;
+  ph.begin(34);
+  TEST_ASSERT_FLOAT_IS_NAN(ph.readPH());
+
+  // 2,5 V com picos de fundo de escala em 10% dos blocos
+  const uint16_t counts = (uint16_t)(2.5f / ADC_VREF * ADC_MAX_COUNTS);
+  for (int b = 0; b < PhSensor::RING; b++)
+    Fake::pushAdc(b % 10 == 0 ? 4095 : counts, PhSensor::OVERSAMPLE);
+  ph.poll();
+  TEST_ASSERT_EQUAL_size_t(0, Fake::adcQueued());
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)PhSensor::RING, ph.stats().blocks);
+
+  const float volts = ph.readVolts();
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, counts * ADC_VREF / ADC_MAX_COUNTS, volts);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, M_PH * volts + B_PH, ph.readPH());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_heater_hysteresis_and_min_switch);
+  RUN_TEST(test_heater_off_on_invalid_reading);
+  RUN_TEST(test_heater_manual_mode_keeps_only_fail_safe);
+  RUN_TEST(test_waterfall_float_debounce);
+  RUN_TEST(test_feed_gate_blocks_once_until_water_returns);
+  RUN_TEST(test_feeder_blocked_without_water);
+  RUN_TEST(test_feeder_runs_steps_from_timer);
+  RUN_TEST(test_stepper_ramps_up_from_pull_in_rate);
+  RUN_TEST(test_trimmed_mean_matches_sorted_reference);
+  RUN_TEST(test_ph_from_adc_rejects_spikes);
+  return UNITY_END();
+}
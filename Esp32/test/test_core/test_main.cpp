@@ -0,0 +1,311 @@
+// Módulos portáveis do core: filas, filtros, estatística, codec, relógio,
+// caminhos, profilers e janelas do rádio. Roda no env:native.
+#include <unity.h>
+#include <Fake.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "core/SpscQueue.h"
+#include "core/SignalPipeline.h"
+#include "core/WindowStats.h"
+#include "core/SeriesCodec.h"
+#include "core/LoopProfiler.h"
+#include "core/JsonScan.h"
+#include "core/RtdbPaths.h"
+#include "core/Clock.h"
+#include "core/BootTrace.h"
+#include "io/BurstScheduler.h"
+
+void setUp() { Fake::reset(); }
+void tearDown() {}
+
+// ==== SpscQueue ====
+void test_spsc_fifo_full_and_wrap() {
+  SpscQueue<int, 4> q;
+  int v = 0;
+  TEST_ASSERT_FALSE(q.pop(v));
+  for (int round = 0; round < 3; round++) {   // índices dão a volta
+    for (int i = 0; i < 4; i++) TEST_ASSERT_TRUE(q.push(round * 10 + i));
+    TEST_ASSERT_FALSE(q.push(99));
+    for (int i = 0; i < 4; i++) {
+      TEST_ASSERT_TRUE(q.pop(v));
+      TEST_ASSERT_EQUAL_INT(round * 10 + i, v);
+    }
+    TEST_ASSERT_FALSE(q.pop(v));
+  }
+}
+
+// ==== Signal ====
+void test_median_drops_isolated_spike() {
+  Signal::Pipeline<int, Signal::Median<int, 3>> f{Signal::Median<int, 3>()};
+  f.process(10);
+  f.process(10);
+  TEST_ASSERT_EQUAL_INT(10, f.process(500));
+  TEST_ASSERT_EQUAL_INT(10, f.process(10));
+}
+
+void test_ema_seeds_then_smooths() {
+  Signal::Ema ema(0.5f);
+  TEST_ASSERT_EQUAL_FLOAT(8.0f, ema.process(8.0f, 0));
+  TEST_ASSERT_EQUAL_FLOAT(6.0f, ema.process(4.0f, 0));
+  ema.reset();
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, ema.process(1.0f, 0));
+}
+
+void test_debounce_rise_and_fall_times() {
+  Signal::Debounce<int> d(1000, 2000);
+  TEST_ASSERT_EQUAL_INT(0, d.process(0, 0));      // semeia
+  TEST_ASSERT_EQUAL_INT(0, d.process(1, 100));
+  TEST_ASSERT_EQUAL_INT(0, d.process(1, 1099));
+  TEST_ASSERT_EQUAL_INT(1, d.process(1, 1100));
+  TEST_ASSERT_EQUAL_INT(1, d.process(0, 1200));
+  TEST_ASSERT_EQUAL_INT(1, d.process(1, 1300));   // volta antes: recomeça
+  TEST_ASSERT_EQUAL_INT(1, d.process(0, 1400));
+  TEST_ASSERT_EQUAL_INT(1, d.process(0, 3399));
+  TEST_ASSERT_EQUAL_INT(0, d.process(0, 3400));
+}
+
+void test_pipeline_matches_hand_written_chain() {
+  Signal::Pipeline<float, Signal::Ema, Signal::Linear, Signal::Clamp<float>> f{
+      Signal::Ema(0.2f), Signal::Linear(-5.77f, 22.0f), Signal::Clamp<float>(0.0f, 14.0f)};
+  float y = 0.0f;
+  bool init = false;
+  srand(7);
+  for (int i = 0; i < 500; i++) {
+    const float x = 2.0f + (rand() % 1000) / 1000.0f;
+    y = init ? 0.2f * x + 0.8f * y : x;
+    init = true;
+    float ph = -5.77f * y + 22.0f;
+    ph = ph < 0.0f ? 0.0f : (ph > 14.0f ? 14.0f : ph);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, ph, f.process(x));
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, y, f.head().value());
+}
+
+// ==== WindowStats ====
+void test_window_stats_exact_small_window() {
+  WindowStats w;
+  const float xs[] = {25.0f, 25.5f, 24.5f, 26.0f, 25.0f};
+  for (float x : xs) w.add(x);
+  const WindowStats::Summary s = w.summary();
+  TEST_ASSERT_EQUAL_UINT32(5, s.n);
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 25.2f, s.mean);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.570088f, s.stddev);
+  TEST_ASSERT_EQUAL_FLOAT(24.5f, s.min);
+  TEST_ASSERT_EQUAL_FLOAT(26.0f, s.max);
+  TEST_ASSERT_EQUAL_FLOAT(25.0f, s.p50);
+}
+
+void test_window_stats_p2_tracks_large_window() {
+  WindowStats w;
+  float all[2000];
+  srand(3);
+  for (int i = 0; i < 2000; i++) {
+    all[i] = (rand() % 10000) / 100.0f;
+    w.add(all[i]);
+  }
+  std::sort(all, all + 2000);
+  const WindowStats::Summary s = w.summary();
+  TEST_ASSERT_FLOAT_WITHIN(2.0f, all[1000], s.p50);
+  TEST_ASSERT_FLOAT_WITHIN(2.0f, all[100], s.p5);
+  TEST_ASSERT_FLOAT_WITHIN(2.0f, all[1900], s.p95);
+
+  char json[128];
+  TEST_ASSERT_GREATER_THAN(0, (int)WindowStats::toJson(s, json, sizeof(json)));
+  TEST_ASSERT_TRUE(strncmp(json, "{\"n\":2000,", 10) == 0);
+}
+
+// ==== SeriesCodec ====
+void test_series_codec_round_trip() {
+  SeriesCodec::Encoder enc;
+  const uint64_t t0 = 1700000000000ULL;
+  enc.begin(t0, 25.31f, 2);
+  uint64_t t = t0;
+  float v = 25.31f;
+  uint8_t n = 1;
+  while (true) {
+    t += 300000 + (n % 3) * 7;
+    v += (n % 2 ? 0.03f : -0.02f);
+    if (!enc.append(t, v)) break;
+    n++;
+  }
+  TEST_ASSERT_EQUAL_UINT8(n, enc.count());
+
+  char b64[160];
+  TEST_ASSERT_GREATER_THAN(0, (int)enc.toBase64(b64, sizeof(b64)));
+  uint64_t ts[64];
+  float vs[64];
+  TEST_ASSERT_EQUAL_size_t(n, SeriesCodec::decodeBase64(b64, ts, vs, 64));
+  TEST_ASSERT_EQUAL_UINT64(t0, ts[0]);
+  TEST_ASSERT_FLOAT_WITHIN(0.006f, 25.31f, vs[0]);
+  TEST_ASSERT_EQUAL_UINT64(enc.lastMs(), ts[n - 1]);
+}
+
+// mesmo chunk que SistemaWeb/src/lib/seriesCodec.test.ts decodifica: se o
+// layout mudar aqui, o fixture de lá tem de mudar junto
+static const char* const SERIES_FIXTURE = "AQIHAYvP5WgAAAATiAAAYaiUXfATiDwBaoyDJsQLgHB94AtyLQA=";
+
+void test_series_codec_fixed_chunk_layout() {
+  // cobre todos os baldes: delta v negativo, dod de 7/20/32 bits e
+  // delta v de 6/12/20/32 bits
+  static const uint32_t dt[] = {25000, 25000, 30000, 3000000, 3000001, 3000001};
+  static const float v[]     = {25.10f, 24.80f, 24.80f, 31.00f, -5.00f, 30000.00f};
+  SeriesCodec::Encoder enc;
+  uint64_t t = 1700000000000ULL;
+  enc.begin(t, 25.00f, 2);
+  for (uint8_t i = 0; i < 6; i++) {
+    t += dt[i];
+    TEST_ASSERT_TRUE(enc.append(t, v[i]));
+  }
+
+  char b64[160];
+  enc.toBase64(b64, sizeof(b64));
+  TEST_ASSERT_EQUAL_STRING(SERIES_FIXTURE, b64);
+
+  uint64_t ts[8];
+  float vs[8];
+  TEST_ASSERT_EQUAL_size_t(7, SeriesCodec::decodeBase64(SERIES_FIXTURE, ts, vs, 8));
+  TEST_ASSERT_EQUAL_UINT64(1700000000000ULL, ts[0]);
+  TEST_ASSERT_EQUAL_FLOAT(25.00f, vs[0]);
+  t = ts[0];
+  for (uint8_t i = 0; i < 6; i++) {
+    t += dt[i];
+    TEST_ASSERT_EQUAL_UINT64(t, ts[i + 1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.006f, v[i], vs[i + 1]);
+  }
+}
+
+// ==== LoopProfiler ====
+void test_profiler_buckets_cover_their_range() {
+  for (uint32_t us = 0; us < 100000; us += 37) {
+    const uint8_t b = LoopProfiler::bucketOf(us);
+    TEST_ASSERT_TRUE(b < LoopProfiler::BUCKETS);
+    TEST_ASSERT_TRUE(us <= LoopProfiler::bucketTop(b));
+    if (b) TEST_ASSERT_TRUE(us > LoopProfiler::bucketTop(b - 1));
+  }
+}
+
+void test_profiler_percentiles() {
+  static const char* const names[] = {"a"};
+  LoopProfiler p;
+  p.begin(names, 1);
+  for (uint32_t i = 1; i <= 100; i++) p.record(0, i * 10);
+  const LoopProfiler::Summary s = p.summary(0);
+  TEST_ASSERT_EQUAL_UINT32(100, s.n);
+  TEST_ASSERT_EQUAL_UINT32(10, s.minUs);
+  TEST_ASSERT_EQUAL_UINT32(1000, s.maxUs);
+  TEST_ASSERT_EQUAL_UINT32(505, s.avgUs);
+  // erro da faixa ≤ 25%
+  TEST_ASSERT_TRUE(s.p50Us >= 500 && s.p50Us <= 625);
+  TEST_ASSERT_TRUE(s.p99Us >= 990 && s.p99Us <= 1000);
+}
+
+// ==== JsonScan / RtdbPaths ====
+void test_json_scan_nested_leaf() {
+  char out[16];
+  TEST_ASSERT_TRUE(JsonScan::find("{\"heater\":{\"mode\":\"manual\",\"turn_on_now\":true}}",
+                                  "heater/mode", out, sizeof(out)));
+  TEST_ASSERT_EQUAL_STRING("manual", out);
+  TEST_ASSERT_FALSE(JsonScan::find("{\"heater\":{}}", "heater/mode", out, sizeof(out)));
+}
+
+void test_pathbuf_overflow_yields_empty() {
+  PathBuf<32> p(RtdbPaths::SERIES);
+  const size_t base = p.length();
+  p.add("temp").add('/').addU64(123);
+  TEST_ASSERT_EQUAL_STRING("/aquario/series/temp/123", p.c_str());
+  p.truncate(base).add("x");
+  TEST_ASSERT_EQUAL_STRING("/aquario/series/x", p.c_str());
+  p.add("_muito_longo_demais");
+  TEST_ASSERT_FALSE(p.ok());
+  TEST_ASSERT_EQUAL_STRING("", p.c_str());
+}
+
+// ==== Clock ====
+void test_clock_unsynced_then_projects() {
+  // estado do Clock é global: este teste é o único que sincroniza
+  TEST_ASSERT_EQUAL_UINT64(0, Clock::epochMillis());
+  Fake::advanceMs(5000);
+  Clock::sync(1700000000000ULL, Clock::monoMillis());
+  TEST_ASSERT_TRUE(Clock::synced());
+  TEST_ASSERT_EQUAL_UINT64(1700000000000ULL - 4000, Clock::toEpoch(1000));
+  Fake::advanceMs(250);
+  TEST_ASSERT_EQUAL_UINT64(1700000000250ULL, Clock::epochMillis());
+}
+
+// ==== BootTrace ====
+void test_boot_trace_keeps_first_mark() {
+  BootTrace::mark("t_um");
+  BootTrace::mark("t_dois");
+  const uint8_t n = BootTrace::count();
+  BootTrace::mark("t_um");
+  TEST_ASSERT_EQUAL_UINT8(n, BootTrace::count());
+  TEST_ASSERT_TRUE(BootTrace::has("t_dois"));
+  TEST_ASSERT_FALSE(BootTrace::has("t_tres"));
+  TEST_ASSERT_EQUAL_STRING("t_dois", BootTrace::at(n - 1).name);
+  TEST_ASSERT_EQUAL_STRING("", BootTrace::at(BootTrace::MAX_MARKS).name);
+}
+
+// ==== BurstScheduler ====
+void test_burst_periodic_window_and_sleep() {
+  BurstScheduler b;
+  b.begin(0);
+  TEST_ASSERT_TRUE(b.open());          // não gerenciado: rádio acordado
+  b.setManaged(true, 0);
+  TEST_ASSERT_FALSE(b.open());
+
+  b.tick(BurstScheduler::PERIOD_MS - 1, false, false);
+  TEST_ASSERT_FALSE(b.open());
+  b.tick(BurstScheduler::PERIOD_MS, false, true);
+  TEST_ASSERT_TRUE(b.open());
+  TEST_ASSERT_TRUE(b.periodicDue());
+  TEST_ASSERT_FALSE(b.periodicDue());
+
+  // ocupado segura a janela; livre depois de MIN_OPEN_MS fecha
+  b.tick(BurstScheduler::PERIOD_MS + BurstScheduler::MIN_OPEN_MS, false, true);
+  TEST_ASSERT_TRUE(b.open());
+  b.tick(BurstScheduler::PERIOD_MS + BurstScheduler::MIN_OPEN_MS + 1, false, false);
+  TEST_ASSERT_FALSE(b.open());
+  TEST_ASSERT_EQUAL_UINT32(1, b.thisHour().windows);
+}
+
+void test_burst_urgent_opens_and_max_caps() {
+  BurstScheduler b;
+  b.begin(0);
+  b.setManaged(true, 0);
+  b.tick(100, true, true);
+  TEST_ASSERT_TRUE(b.open());
+  TEST_ASSERT_EQUAL_UINT32(1, b.thisHour().urgent);
+  b.tick(100 + BurstScheduler::MAX_OPEN_MS, false, true);
+  TEST_ASSERT_FALSE(b.open());
+  TEST_ASSERT_EQUAL_UINT32(BurstScheduler::MAX_OPEN_MS, b.thisHour().awakeMs);
+}
+
+void test_burst_energy_model() {
+  BurstScheduler::Hour h;
+  h.awakeMs = BurstScheduler::HOUR_MS;    // uma hora acordado
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)BurstScheduler::RADIO_MA * BurstScheduler::SUPPLY_MV / 1000, h.mWh());
+  TEST_ASSERT_EQUAL_UINT16(1000, h.awakePermille());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_spsc_fifo_full_and_wrap);
+  RUN_TEST(test_median_drops_isolated_spike);
+  RUN_TEST(test_ema_seeds_then_smooths);
+  RUN_TEST(test_debounce_rise_and_fall_times);
+  RUN_TEST(test_pipeline_matches_hand_written_chain);
+  RUN_TEST(test_window_stats_exact_small_window);
+  RUN_TEST(test_window_stats_p2_tracks_large_window);
+  RUN_TEST(test_series_codec_round_trip);
+  RUN_TEST(test_series_codec_fixed_chunk_layout);
+  RUN_TEST(test_profiler_buckets_cover_their_range);
+  RUN_TEST(test_profiler_percentiles);
+  RUN_TEST(test_json_scan_nested_leaf);
+  RUN_TEST(test_pathbuf_overflow_yields_empty);
+  RUN_TEST(test_clock_unsynced_then_projects);
+  RUN_TEST(test_boot_trace_keeps_first_mark);
+  RUN_TEST(test_burst_periodic_window_and_sleep);
+  RUN_TEST(test_burst_urgent_opens_and_max_caps);
+  RUN_TEST(test_burst_energy_model);
+  return UNITY_END();
+}
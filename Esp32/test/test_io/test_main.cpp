@@ -0,0 +1,273 @@
+// Caminho de publicação e LCD sobre o RTDB/LCD falsos: fila com
+// prioridade, espelho de estados e framebuffer do LCD. Roda no env:native.
+#include <unity.h>
+#include <Fake.h>
+#include <FirebaseClient.h>
+#include <LiquidCrystal_I2C.h>
+#include "io/RtdbScheduler.h"
+#include "io/ShadowState.h"
+#include "core/RtdbPaths.h"
+#include "ui/LcdFrame.h"
+
+using Prio = RtdbScheduler::Prio;
+
+static RealtimeDatabase db;
+static AsyncClientClass client;
+static void onResult(AsyncResult&) {}
+
+void setUp() {
+  Fake::reset();
+  Fake::quiet(true);
+  db = RealtimeDatabase();
+}
+void tearDown() { Fake::quiet(false); }
+
+static bool flush(RtdbScheduler& s) { return s.flush(db, client, onResult, "t", millis()); }
+
+// ==== RtdbScheduler ====
+void test_sched_merges_and_orders_by_priority() {
+  RtdbScheduler s;
+  s.setFloat(RtdbPaths::TEMP_CURRENT, 25.0f, Prio::TELEMETRY, 2);
+  s.setFloat(RtdbPaths::TEMP_CURRENT, 25.5f, Prio::TELEMETRY, 2);   // mesmo caminho: vale o último
+  s.setBool(RtdbPaths::WATER_OK, false, Prio::SAFETY);
+  TEST_ASSERT_EQUAL_UINT32(1, s.stats(Prio::TELEMETRY).merged);
+
+  TEST_ASSERT_TRUE(flush(s));
+  TEST_ASSERT_EQUAL_STRING("{\"aquario/float/water_ok\":false,\"aquario/temperatura_current\":25.50}",
+                           db.lastBody);
+  TEST_ASSERT_FALSE(s.hasPending());
+  TEST_ASSERT_FALSE(flush(s));
+  s.onResult(s.lastUid(), true);
+  TEST_ASSERT_EQUAL_UINT8(0, s.depth(Prio::TELEMETRY));
+}
+
+void test_sched_failure_requeues_unless_superseded() {
+  RtdbScheduler s;
+  s.setInt(RtdbPaths::FEEDER_STEPS, 100, Prio::CONTROL);
+  s.setInt(RtdbPaths::FEEDER_STEP_RATE, 800, Prio::CONTROL);
+  flush(s);
+  s.setInt(RtdbPaths::FEEDER_STEPS, 200, Prio::CONTROL);   // mais novo, ainda pendente
+  s.onResult(s.lastUid(), false);
+
+  TEST_ASSERT_EQUAL_UINT32(2, s.stats(Prio::CONTROL).failed);
+  TEST_ASSERT_EQUAL_UINT8(2, s.depth(Prio::CONTROL));
+  flush(s);
+  TEST_ASSERT_TRUE(strstr(db.lastBody, "\"aquario/config/feeder/steps_per_portion\":200") != nullptr);
+  TEST_ASSERT_TRUE(strstr(db.lastBody, "\"aquario/config/feeder/step_rate_hz\":800") != nullptr);
+  TEST_ASSERT_TRUE(strstr(db.lastBody, ":100") == nullptr);
+}
+
+void test_sched_failed_batch_does_not_resend_value_newer_in_flight() {
+  RtdbScheduler s;
+  s.setInt(RtdbPaths::FEEDER_STEPS, 100, Prio::CONTROL);
+  flush(s);
+  char first[32];
+  strcpy(first, s.lastUid());
+  s.setInt(RtdbPaths::FEEDER_STEPS, 200, Prio::CONTROL);
+  flush(s);   // dois lotes em voo, o segundo com o valor novo
+  TEST_ASSERT_EQUAL_UINT8(2, s.inFlight());
+
+  TEST_ASSERT_TRUE(s.onResult(first, false));
+  TEST_ASSERT_FALSE(s.hasPending());   // 100 não volta
+  TEST_ASSERT_EQUAL_UINT8(1, s.depth(Prio::CONTROL));
+
+  // mesmo caminho pelo timeout: o lote mais velho expira primeiro
+  RtdbScheduler t;
+  t.setInt(RtdbPaths::FEEDER_STEPS, 100, Prio::CONTROL);
+  flush(t);
+  Fake::advanceMs(10);
+  t.setInt(RtdbPaths::FEEDER_STEPS, 200, Prio::CONTROL);
+  flush(t);
+  t.checkTimeout(millis() - 10 + RtdbScheduler::RESULT_TIMEOUT_MS);
+  TEST_ASSERT_FALSE(t.hasPending());
+  TEST_ASSERT_EQUAL_UINT8(1, t.inFlight());
+}
+
+void test_sched_rejected_batch_isolates_and_drops_bad_path() {
+  RtdbScheduler s;
+  s.setBool(RtdbPaths::WATER_OK, false, Prio::SAFETY);
+  s.setRaw("aquario/series/bad", "\"x\"", Prio::LOGS);
+  flush(s);
+
+  // falha de rede não conta como recusa
+  for (int i = 0; i < 5; i++) {
+    s.onResult(s.lastUid(), false);
+    flush(s);
+  }
+  TEST_ASSERT_EQUAL_STRING("{\"aquario/float/water_ok\":false,\"aquario/series/bad\":\"x\"}", db.lastBody);
+
+  // recusado: as duas viram suspeitas e saem sozinhas, SAFETY primeiro
+  s.onResult(s.lastUid(), false, true);
+  flush(s);
+  TEST_ASSERT_EQUAL_STRING("{\"aquario/float/water_ok\":false}", db.lastBody);
+  s.onResult(s.lastUid(), true);
+  TEST_ASSERT_EQUAL_UINT8(0, s.depth(Prio::SAFETY));
+
+  for (uint8_t i = 1; i < RtdbScheduler::MAX_REJECTS; i++) {
+    TEST_ASSERT_TRUE(flush(s));
+    TEST_ASSERT_EQUAL_STRING("{\"aquario/series/bad\":\"x\"}", db.lastBody);
+    s.onResult(s.lastUid(), false, true);
+  }
+  TEST_ASSERT_FALSE(s.hasPending());
+  TEST_ASSERT_EQUAL_UINT32(1, s.stats(Prio::LOGS).rejected);
+
+  // caminho lembrado: escrita nova nele não entra no lote normal; SAFETY
+  // limpa passa na frente da vez do solo
+  s.setRaw("aquario/series/bad", "\"y\"", Prio::LOGS);
+  s.setBool(RtdbPaths::WATER_OK, true, Prio::SAFETY);
+  flush(s);
+  TEST_ASSERT_EQUAL_STRING("{\"aquario/float/water_ok\":true}", db.lastBody);
+  s.onResult(s.lastUid(), true);
+  s.setBool(RtdbPaths::RELAY_HEATER, true, Prio::CONTROL);
+  flush(s);
+  TEST_ASSERT_EQUAL_STRING("{\"aquario/series/bad\":\"y\"}", db.lastBody);
+  s.onResult(s.lastUid(), true);   // regra corrigida: caminho volta a valer
+  flush(s);
+  TEST_ASSERT_EQUAL_STRING("{\"aquario/relay/heater\":true}", db.lastBody);
+}
+
+void test_sched_saturated_link_lets_only_safety_through() {
+  RtdbScheduler s;
+  for (uint8_t i = 0; i < RtdbScheduler::MAX_INFLIGHT; i++) {
+    s.setU64(RtdbPaths::LAST_SEEN, i, Prio::TELEMETRY);
+    TEST_ASSERT_TRUE(flush(s));
+  }
+  s.setU64(RtdbPaths::LAST_SEEN, 9, Prio::TELEMETRY);
+  TEST_ASSERT_FALSE(flush(s));
+  s.setBool(RtdbPaths::WATER_OK, true, Prio::SAFETY);
+  TEST_ASSERT_TRUE(flush(s));
+  TEST_ASSERT_EQUAL_STRING("{\"aquario/float/water_ok\":true}", db.lastBody);
+}
+
+void test_sched_result_timeout_requeues() {
+  RtdbScheduler s;
+  s.setBool(RtdbPaths::RELAY_HEATER, true, Prio::CONTROL);
+  flush(s);
+  s.checkTimeout(millis() + RtdbScheduler::RESULT_TIMEOUT_MS - 1);
+  TEST_ASSERT_FALSE(s.hasPending());
+  s.checkTimeout(millis() + RtdbScheduler::RESULT_TIMEOUT_MS);
+  TEST_ASSERT_TRUE(s.hasPending());
+}
+
+void test_sched_acks_match_batch_uid_not_order() {
+  RtdbScheduler s;
+  s.setBool(RtdbPaths::RELAY_HEATER, true, Prio::CONTROL);
+  flush(s);
+  char late[32];
+  strcpy(late, s.lastUid());
+  TEST_ASSERT_EQUAL_STRING("t#1", late);
+
+  // lote 1 expira: a entrada volta e sai de novo no lote 2
+  s.checkTimeout(millis() + RtdbScheduler::RESULT_TIMEOUT_MS);
+  TEST_ASSERT_EQUAL_UINT8(0, s.inFlight());
+  flush(s);
+  TEST_ASSERT_EQUAL_STRING("t#2", s.lastUid());
+
+  // resposta atrasada do lote 1 não confirma o lote 2
+  TEST_ASSERT_FALSE(s.onResult(late, true));
+  TEST_ASSERT_EQUAL_UINT8(1, s.depth(Prio::CONTROL));
+  TEST_ASSERT_EQUAL_UINT8(1, s.inFlight());
+
+  // fora de ordem: o lote 3 responde antes do 2
+  char second[32];
+  strcpy(second, s.lastUid());
+  s.setBool(RtdbPaths::WATER_OK, true, Prio::SAFETY);
+  flush(s);
+  TEST_ASSERT_TRUE(s.onResult(s.lastUid(), true));
+  TEST_ASSERT_EQUAL_UINT8(0, s.depth(Prio::SAFETY));
+  TEST_ASSERT_EQUAL_UINT8(1, s.depth(Prio::CONTROL));
+  TEST_ASSERT_TRUE(s.onResult(second, true));
+  TEST_ASSERT_EQUAL_UINT8(0, s.depth(Prio::CONTROL));
+  TEST_ASSERT_TRUE(RtdbScheduler::isBatchUid(second, "t"));
+  TEST_ASSERT_FALSE(RtdbScheduler::isBatchUid("tokenTask", "t"));
+}
+
+// ==== ShadowState ====
+void test_shadow_deadband_and_refresh() {
+  RtdbScheduler s;
+  ShadowState sh;
+  sh.define(0, RtdbPaths::PH_CURRENT, Prio::TELEMETRY, 0.02f, 60000);
+  sh.define(1, RtdbPaths::RELAY_HEATER, Prio::CONTROL);
+
+  TEST_ASSERT_TRUE(sh.publishFloat(s, 0, 7.00f, 0));
+  TEST_ASSERT_FALSE(sh.publishFloat(s, 0, 7.01f, 10));   // dentro da zona morta
+  TEST_ASSERT_TRUE(sh.publishFloat(s, 0, 7.03f, 20));
+  TEST_ASSERT_TRUE(sh.publishBool(s, 1, true, 20));
+  TEST_ASSERT_FALSE(sh.publishBool(s, 1, true, 30));
+  TEST_ASSERT_EQUAL_UINT32(2, sh.suppressed());
+
+  flush(s);
+  s.onResult(s.lastUid(), true);
+  sh.refresh(s, 59999);
+  TEST_ASSERT_FALSE(s.hasPending());
+  sh.refresh(s, 60020);      // nó de pH velho: reenvia o último valor
+  TEST_ASSERT_TRUE(s.hasPending());
+  sh.invalidate();
+  sh.refresh(s, 60021);
+  TEST_ASSERT_EQUAL_UINT8(1, s.depth(Prio::CONTROL));
+}
+
+void test_shadow_resends_node_evicted_by_class_cap() {
+  RtdbScheduler s;
+  ShadowState sh;
+  sh.attach(s);
+  sh.define(0, RtdbPaths::PH_CURRENT, Prio::TELEMETRY, 0.02f);
+  TEST_ASSERT_TRUE(sh.publishFloat(s, 0, 7.00f, 0));
+
+  // cota de TELEMETRY estoura: o pH (mais antigo) é descartado
+  char path[16];
+  for (uint8_t i = 0; i < 12; i++) {
+    snprintf(path, sizeof(path), "t/%u", i);
+    s.setInt(path, i, Prio::TELEMETRY);
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, s.stats(Prio::TELEMETRY).dropped);
+
+  sh.refresh(s, 10);       // classe cheia: espera, sem despejar outro nó
+  TEST_ASSERT_EQUAL_UINT32(1, s.stats(Prio::TELEMETRY).dropped);
+  flush(s);
+  s.onResult(s.lastUid(), true);
+  TEST_ASSERT_NULL(strstr(db.lastBody, "ph_current"));
+
+  // sem maxStaleMs e sem valor novo: só o refresh reenviaria
+  sh.refresh(s, 20);
+  flush(s);
+  TEST_ASSERT_NOT_NULL(strstr(db.lastBody, "\"aquario/ph_current\":7.000"));
+}
+
+// ==== LcdFrame ====
+void test_lcd_frame_sends_only_diffs() {
+  LiquidCrystal_I2C lcd;
+  LcdFrame f;
+  f.begin(&lcd);
+  f.setLine(0, "T:25.1C pH:7.02");
+  f.setLine(1, "HTR:OFF");
+  TEST_ASSERT_EQUAL_UINT16(2 * (1 + LcdFrame::COLS), f.flush(0));
+  TEST_ASSERT_EQUAL_STRING("T:25.1C pH:7.02 ", lcd.screen[0]);
+  TEST_ASSERT_EQUAL_STRING("HTR:OFF         ", lcd.screen[1]);
+
+  f.setLine(0, "T:25.1C pH:7.02");
+  f.setLine(1, "HTR:OFF");
+  TEST_ASSERT_EQUAL_UINT16(0, f.flush(100));
+
+  f.setLine(0, "T:25.2C pH:7.02");      // um dígito: setCursor + 1 caractere
+  TEST_ASSERT_EQUAL_UINT16(2, f.flush(200));
+  TEST_ASSERT_EQUAL_STRING("T:25.2C pH:7.02 ", lcd.screen[0]);
+
+  // ressincroniza tudo depois de RESYNC_MS, mesmo parado
+  TEST_ASSERT_EQUAL_UINT16(2 * (1 + LcdFrame::COLS), f.flush(LcdFrame::RESYNC_MS + 1));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_sched_merges_and_orders_by_priority);
+  RUN_TEST(test_sched_failure_requeues_unless_superseded);
+  RUN_TEST(test_sched_failed_batch_does_not_resend_value_newer_in_flight);
+  RUN_TEST(test_sched_rejected_batch_isolates_and_drops_bad_path);
+  RUN_TEST(test_sched_saturated_link_lets_only_safety_through);
+  RUN_TEST(test_sched_result_timeout_requeues);
+  RUN_TEST(test_sched_acks_match_batch_uid_not_order);
+  RUN_TEST(test_shadow_deadband_and_refresh);
+  RUN_TEST(test_shadow_resends_node_evicted_by_class_cap);
+  RUN_TEST(test_lcd_frame_sends_only_diffs);
+  return UNITY_END();
+}
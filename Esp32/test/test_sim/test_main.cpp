@@ -0,0 +1,103 @@
+// Cenários do simulador (AquaSim) sobre o controle de verdade: semanas de
+// operação em segundos. Cada caso imprime o relatório:
+//   pio test -e native -f test_sim -v
+#include <unity.h>
+#include <Fake.h>
+#include <AquaSim.h>
+
+using namespace AquaSim;
+
+void setUp() { Fake::reset(); }
+void tearDown() {}
+
+// ==== operação normal ====
+void test_two_weeks_nominal() {
+  Simulator sim;
+  const Report& r = sim.run(14 * DAY_MS);
+  r.print("14 dias, sala 20..24 C");
+
+  // agenda de 12 h contada do fim do movimento (~5 s cada)
+  TEST_ASSERT_EQUAL_UINT32(28, r.feeds);
+  TEST_ASSERT_EQUAL_UINT32(0, r.feedsBlocked);
+  TEST_ASSERT_TRUE(r.maxFeedGapMs >= FEED_INTERVAL_MS && r.maxFeedGapMs < FEED_INTERVAL_MS + MINUTE_MS);
+
+  TEST_ASSERT_TRUE(r.heaterSwitches > 0);
+  TEST_ASSERT_TRUE(r.heaterSwitches <= 14 * DAY_MS / MIN_SWITCH_MS);
+  TEST_ASSERT_EQUAL_UINT32(0, r.failSafeOffs);
+  TEST_ASSERT_EQUAL_UINT32(0, r.waterfallSwitches);
+  TEST_ASSERT_TRUE(r.outsideBandPct() < 2.0f);
+  TEST_ASSERT_TRUE(r.speedup() > 10000.0);
+}
+
+// ==== boia ====
+void test_float_chatter_filtered_sustained_low_confirmed() {
+  Simulator sim;
+  sim.add(Event{2 * HOUR_MS, 10 * MINUTE_MS, Kind::FLOAT_CHATTER, 400});   // onda: 400 ms < confirmações
+  sim.add(Event{6 * HOUR_MS, 30 * MINUTE_MS, Kind::FLOAT_LOW, 0});
+  const Report& r = sim.run(DAY_MS);
+  r.print("boia: chacoalho 10 min + nivel baixo 30 min");
+
+  TEST_ASSERT_TRUE(r.floatEdges > 1000);
+  TEST_ASSERT_EQUAL_UINT32(1, r.waterLowEvents);
+  TEST_ASSERT_EQUAL_UINT32(2, r.waterfallSwitches);   // desliga e religa
+  // confirma a queda em T_LOW_CONFIRM_MS e a volta em T_HIGH_CONFIRM_MS
+  TEST_ASSERT_EQUAL_UINT64(30 * MINUTE_MS - T_LOW_CONFIRM_MS + T_HIGH_CONFIRM_MS, r.waterLowMs);
+}
+
+void test_low_water_holds_feed_until_level_returns() {
+  Simulator sim;
+  sim.add(Event{11 * HOUR_MS, 2 * HOUR_MS, Kind::FLOAT_LOW, 0});
+  const Report& r = sim.run(DAY_MS);
+  r.print("nivel baixo na hora da 2a alimentacao");
+
+  TEST_ASSERT_EQUAL_UINT32(1, r.feedsBlocked);
+  TEST_ASSERT_EQUAL_UINT32(2, r.feeds);   // boot e a atrasada (a de 24 h fica para depois)
+  // a atrasada sai quando a água volta; a agenda recomeça dali
+  TEST_ASSERT_UINT64_WITHIN(10000, 13 * HOUR_MS, r.maxFeedGapMs);
+}
+
+// ==== sonda ====
+void test_probe_faults_force_heater_off() {
+  Plant cold;
+  cold.startC = 24.0f;   // abaixo da faixa: aquecedor liga no começo
+  Simulator sim(cold);
+  sim.add(Event{10 * MINUTE_MS, 5 * MINUTE_MS, Kind::PROBE_LOST, 0});
+  sim.add(Event{HOUR_MS, MINUTE_MS, Kind::PROBE_85C, 0});
+  const Report& r = sim.run(6 * HOUR_MS);
+  r.print("sonda: desconectada 5 min + 85 C por 1 min");
+
+  TEST_ASSERT_EQUAL_UINT32(2, r.failSafeOffs);
+  TEST_ASSERT_TRUE(r.invalidReadings >= 5 * MINUTE_MS / SAMPLE_MS + MINUTE_MS / SAMPLE_MS);
+  // liga, fail-safe, religa, fail-safe, religa, desliga no topo da faixa
+  TEST_ASSERT_EQUAL_UINT32(6, r.heaterSwitches);
+  TEST_ASSERT_TRUE(r.maxC < T_SET + T_HYST + 0.5f);
+}
+
+// ==== ajuste de parâmetros ====
+void test_hysteresis_sweep() {
+  static const float hyst[] = {0.25f, 0.5f, 1.0f};
+  uint32_t prevSwitches = UINT32_MAX;
+  for (float h : hyst) {
+    Control c;
+    c.tHyst = h;
+    Simulator sim(Plant(), c);
+    sim.add(Event{3 * DAY_MS, DAY_MS, Kind::ROOM_STEP, -4.0f});   // frente fria por 1 dia
+    const Report& r = sim.run(7 * DAY_MS);
+    char title[48];
+    snprintf(title, sizeof(title), "7 dias, T_HYST=%.2f", h);
+    r.print(title);
+
+    TEST_ASSERT_TRUE(r.heaterSwitches < prevSwitches);   // faixa maior, menos comutações
+    prevSwitches = r.heaterSwitches;
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_two_weeks_nominal);
+  RUN_TEST(test_float_chatter_filtered_sustained_low_confirmed);
+  RUN_TEST(test_low_water_holds_feed_until_level_returns);
+  RUN_TEST(test_probe_faults_force_heater_off);
+  RUN_TEST(test_hysteresis_sweep);
+  return UNITY_END();
+}
@@ -21,7 +21,11 @@ export function useAquariumData(): UseAquariumData {
     const unsubRoot = onValue(rootRef, (snap) => {
       const v = snap.val() || {};
       const feederLastTs = v?.feeder?.last_ts ?? v?.status?.feeder?.last_ts;
-      setData((prev) => ({ ...prev, ...v, feederLastTs }));
+      // Firmware novo publica os instantâneos; o legado só tem as médias
+      const atuais: Partial<UseAquariumData['data']> = {};
+      if (typeof v?.temperatura_current === 'number') atuais.temperaturaAtual = v.temperatura_current;
+      if (typeof v?.ph_current === 'number') atuais.phAtual = v.ph_current;
+      setData((prev) => ({ ...prev, ...v, feederLastTs, ...atuais }));
       setLoading(false);
     });
 
@@ -31,7 +35,7 @@ export function useAquariumData(): UseAquariumData {
       snap.forEach((child) => {
         ultima = Number(child.val());
       });
-      setData((prev) => ({ ...prev, temperaturaAtual: ultima }));
+      setData((prev) => ({ ...prev, temperaturaAtual: prev.temperatura_current ?? ultima }));
     });
 
     const phRef = query(ref(database, 'aquario/ph'), limitToLast(1));
@@ -40,7 +44,7 @@ export function useAquariumData(): UseAquariumData {
       snap.forEach((child) => {
         ultima = Number(child.val());
       });
-      setData((prev) => ({ ...prev, phAtual: ultima }));
+      setData((prev) => ({ ...prev, phAtual: prev.ph_current ?? ultima }));
     });
 
     return () => {
@@ -0,0 +1,36 @@
+// Round-trip com o encoder do ESP32: o fixture é o mesmo de
+// Esp32/test/test_core (test_series_codec_fixed_chunk_layout), gerado por
+// SeriesCodec::Encoder. Roda com `npm test` (node >= 22.6).
+import { test } from 'node:test';
+import assert from 'node:assert/strict';
+import { decodeSeriesChunk, decodeSeriesNode } from './seriesCodec.ts';
+
+const FIXTURE = 'AQIHAYvP5WgAAAATiAAAYaiUXfATiDwBaoyDJsQLgHB94AtyLQA=';
+
+// delta v negativo, dod de 7/20/32 bits e delta v de 6/12/20/32 bits
+const EXPECTED = [
+  { timestamp: 1700000000000, value: 25.0 },
+  { timestamp: 1700000025000, value: 25.1 },
+  { timestamp: 1700000050000, value: 24.8 },
+  { timestamp: 1700000080000, value: 24.8 },
+  { timestamp: 1700003080000, value: 31.0 },
+  { timestamp: 1700006080001, value: -5.0 },
+  { timestamp: 1700009080002, value: 30000.0 },
+];
+
+test('decodifica o chunk gerado pelo SeriesCodec do ESP32', () => {
+  assert.deepEqual(decodeSeriesChunk(FIXTURE), EXPECTED);
+});
+
+test('chunk truncado ou de outra versão não inventa amostras', () => {
+  assert.deepEqual(decodeSeriesChunk(FIXTURE.slice(0, 20)), EXPECTED.slice(0, 1));
+  assert.deepEqual(decodeSeriesChunk('AgIH'), []);
+  assert.deepEqual(decodeSeriesChunk('%%%'), []);
+});
+
+test('nó com vários chunks sai ordenado por tempo', () => {
+  const node = { '1700009080002': FIXTURE, '1': FIXTURE.slice(0, 20) };
+  const out = decodeSeriesNode(node);
+  assert.equal(out.length, EXPECTED.length + 1);
+  assert.ok(out.every((s, i) => i === 0 || out[i - 1].timestamp <= s.timestamp));
+});
@@ -0,0 +1,111 @@
+// Decodificador dos chunks de série gravados pelo ESP32 em
+// aquario/series/<nome>/<t0> (ver Esp32/include/core/SeriesCodec.h).
+//
+// Formato v1 (bits MSB-first):
+//   cabeçalho  : versão(8) | casas decimais(8) | nº de amostras(8)
+//   1ª amostra : t0 (48) | v0 quantizado em zigzag (32)
+//   2ª amostra : delta t (32) | delta v
+//   demais     : delta-of-delta t | delta v
+// Prefixos: '0' → 0 | '10'+6/7 bits | '110'+12 | '1110'+20 | '1111'+32
+
+export interface SeriesSample {
+  timestamp: number;
+  value: number;
+}
+
+const VERSION = 1;
+
+// sem parameter properties: o teste roda no node com --experimental-strip-types
+class BitReader {
+  private pos = 0;
+  private readonly buf: Uint8Array;
+  private readonly offset: number;
+
+  constructor(buf: Uint8Array, offset: number) {
+    this.buf = buf;
+    this.offset = offset;
+  }
+
+  get(nbits: number): number | undefined {
+    let out = 0;
+    for (let i = 0; i < nbits; i++, this.pos++) {
+      const byteIdx = this.offset + (this.pos >> 3);
+      if (byteIdx >= this.buf.length) return undefined;
+      // multiplicação em vez de << para não estourar 32 bits (t0 tem 48)
+      out = out * 2 + ((this.buf[byteIdx] >> (7 - (this.pos & 7))) & 1);
+    }
+    return out;
+  }
+
+  getBucketed(firstWidth: number): number | undefined {
+    const widths = [0, firstWidth, 12, 20, 32];
+    let prefix = 0;
+    while (prefix < 4) {
+      const bit = this.get(1);
+      if (bit === undefined) return undefined;
+      if (!bit) break;
+      prefix++;
+    }
+    if (prefix === 0) return 0;
+    const z = this.get(widths[prefix]);
+    return z === undefined ? undefined : unzigzag(z);
+  }
+}
+
+const unzigzag = (z: number) => (z % 2 === 0 ? z / 2 : -(z + 1) / 2);
+
+function base64ToBytes(b64: string): Uint8Array {
+  const bin = atob(b64);
+  const out = new Uint8Array(bin.length);
+  for (let i = 0; i < bin.length; i++) out[i] = bin.charCodeAt(i);
+  return out;
+}
+
+export function decodeSeriesChunk(b64: string): SeriesSample[] {
+  let raw: Uint8Array;
+  try {
+    raw = base64ToBytes(b64);
+  } catch {
+    return [];
+  }
+  if (raw.length < 3 || raw[0] !== VERSION) return [];
+
+  const scale = Math.pow(10, raw[1]);
+  const count = raw[2];
+  const br = new BitReader(raw, 3);
+
+  let t = br.get(48);
+  const z0 = br.get(32);
+  if (count === 0 || t === undefined || z0 === undefined) return [];
+  let q = unzigzag(z0);
+  const out: SeriesSample[] = [{ timestamp: t, value: q / scale }];
+
+  let delta = 0;
+  for (let i = 1; i < count; i++) {
+    if (i === 1) {
+      const d = br.get(32);
+      if (d === undefined) break;
+      delta = d;
+    } else {
+      const dod = br.getBucketed(7);
+      if (dod === undefined) break;
+      delta += dod;
+    }
+    const dq = br.getBucketed(6);
+    if (dq === undefined) break;
+    t += delta;
+    q += dq;
+    out.push({ timestamp: t, value: q / scale });
+  }
+  return out;
+}
+
+// Nó aquario/series/<nome> → amostras ordenadas por tempo
+export function decodeSeriesNode(node?: Record<string, string>): SeriesSample[] {
+  if (!node) return [];
+  const samples: SeriesSample[] = [];
+  for (const key of Object.keys(node)) {
+    if (typeof node[key] === 'string') samples.push(...decodeSeriesChunk(node[key]));
+  }
+  return samples.sort((a, b) => a.timestamp - b.timestamp);
+}
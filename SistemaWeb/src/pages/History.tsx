@@ -7,6 +7,10 @@ import { Card, CardContent, CardDescription, CardHeader, CardTitle } from '@/com
 import { LineChart, Line, XAxis, YAxis, CartesianGrid, Tooltip, Legend, ResponsiveContainer } from 'recharts';
 import { ArrowLeft, Loader2 } from 'lucide-react';
 import { HistoricalReading } from '@/types/aquarium';
+import { decodeSeriesNode } from '@/lib/seriesCodec';
+
+// Cada chunk de série cobre ~1 h (12 médias de 5 min): 9 chunks ≈ 100 leituras
+const SERIES_CHUNKS = 9;
 
 const History = () => {
   const navigate = useNavigate();
@@ -14,6 +18,9 @@ const History = () => {
   const [loading, setLoading] = useState(true);
 
   useEffect(() => {
+    // Séries compactadas (firmware novo) + nós legados um-por-leitura
+    const tempSeriesRef = query(ref(database, 'aquario/series/temperatura'), orderByKey(), limitToLast(SERIES_CHUNKS));
+    const phSeriesRef   = query(ref(database, 'aquario/series/ph'),          orderByKey(), limitToLast(SERIES_CHUNKS));
     const tempRef = query(ref(database, 'aquario/temperatura'), orderByKey(), limitToLast(100));
     const phRef   = query(ref(database, 'aquario/ph'),          orderByKey(), limitToLast(100));
 
@@ -31,25 +38,48 @@ const History = () => {
           if (!isNaN(ts)) readings[ts] = { ...(readings[ts] || { timestamp: ts }), ph: phs[k] };
         }
       }
-      return Object.values(readings).sort((a, b) => a.timestamp - b.timestamp);
+      return Object.values(readings).sort((a, b) => a.timestamp - b.timestamp).slice(-100);
+    };
+
+    const seriesToRecord = (node?: Record<string, string>) => {
+      const out: Record<string, number> = {};
+      for (const s of decodeSeriesNode(node)) out[String(s.timestamp)] = s.value;
+      return out;
     };
 
     let lastTemps: Record<string, number> | undefined;
     let lastPhs:   Record<string, number> | undefined;
+    let seriesTemps: Record<string, number> = {};
+    let seriesPhs:   Record<string, number> = {};
+
+    const update = () => {
+      setData(combine({ ...lastTemps, ...seriesTemps }, { ...lastPhs, ...seriesPhs }));
+      setLoading(false);
+    };
+
+    const unsubTempSeries = onValue(tempSeriesRef, (snap) => {
+      seriesTemps = seriesToRecord(snap.exists() ? snap.val() : undefined);
+      update();
+    });
+
+    const unsubPhSeries = onValue(phSeriesRef, (snap) => {
+      seriesPhs = seriesToRecord(snap.exists() ? snap.val() : undefined);
+      update();
+    });
 
     const unsubTemp = onValue(tempRef, (snap) => {
       lastTemps = snap.exists() ? snap.val() : undefined;
-      setData(combine(lastTemps, lastPhs));
-      setLoading(false);
+      update();
     });
 
     const unsubPh = onValue(phRef, (snap) => {
       lastPhs = snap.exists() ? snap.val() : undefined;
-      setData(combine(lastTemps, lastPhs));
-      setLoading(false);
+      update();
     });
 
     return () => {
+      off(tempSeriesRef, 'value', unsubTempSeries as any);
+      off(phSeriesRef, 'value', unsubPhSeries as any);
       off(tempRef, 'value', unsubTemp as any);
       off(phRef, 'value', unsubPh as any);
     };
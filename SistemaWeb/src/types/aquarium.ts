@@ -6,6 +6,10 @@ export interface AquariumData {
   temperatura?: number;
   ph?: number;
 
+  // instantâneos publicados pelo firmware (com zona morta)
+  temperatura_current?: number;
+  ph_current?: number;
+
   float?: {
     water_ok?: boolean;
   };